@@ -0,0 +1,116 @@
+#pragma once
+
+// Std. Includes
+#include <vector>
+#include <string>
+#include <iostream>
+
+// GL Includes
+#include <GL/glew.h>
+
+#include "modelAnim.h"
+#include "AnimationPlayer.h"
+#include "BonePalette.h"
+
+// Un personaje ms sobre un ModelAnim ya cargado. El modelo es el recurso compartido e inmutable (mallas
+// con sus buffers, texturas, esqueleto y clips); la instancia solo guarda su reproduccin (capas, tiempos,
+// pesos), el estado de evaluacin del esqueleto, sus huesos finales y su propia paleta en la GPU. As diez
+// copias de un personaje leen el archivo una vez y cada copia extra cuesta unos KB ms su paleta.
+// Se dibuja con skinning en el vertex shader (Shaders/skinning.vs); el pre-skinning es del modelo
+class AnimatedInstance
+{
+public:
+	// model debe vivir ms que la instancia. Empieza reproduciendo en bucle el primer clip
+	AnimatedInstance(ModelAnim& model) : model(&model), clock(0.0)
+	{
+		model.initSkeletonState(this->state);
+		this->bones.resize(model.m_num_bones);
+		this->player.Reset(&model.m_clips, model.m_bind_pose);
+		if (!model.m_clips.empty())
+			this->player.Play(0);
+	}
+
+	// Crossfade hacia el clip con ese nombre; false si no existe
+	bool PlayClip(const std::string& name, float fadeSeconds = 0.0f, float speed = 1.0f, bool loop = true)
+	{
+		unsigned int clip = this->player.FindClip(name);
+		if (clip == AnimationPlayer::NO_CLIP)
+		{
+			std::cout << "ERROR::ANIM:: no hay un clip llamado '" << name << "'" << std::endl;
+			return false;
+		}
+		this->player.Play(clip, fadeSeconds, speed, loop);
+		return true;
+	}
+
+	// Capas, velocidad, bucle y pausa propias de esta instancia
+	AnimationPlayer& Player() { return this->player; }
+
+	// Avanza la reproduccin hasta timeInSec (reloj de la aplicacin); evala el esqueleto si la pose pudo cambiar
+	void Update(double timeInSec)
+	{
+		if (Advance(timeInSec))
+			Evaluate();
+	}
+
+	// Solo avanza tiempos y desvanecimientos (barato, sin muestrear clips); true si la pose pudo cambiar.
+	// AnimationSystem lo usa con las instancias que no evala en este frame para que no se atrasen
+	bool Advance(double timeInSec)
+	{
+		float deltaSeconds = (float)(timeInSec - this->clock);
+		this->clock = timeInSec;
+		return this->player.Advance(deltaSeconds);
+	}
+
+	// Evala el esqueleto en el instante actual del reproductor. No toca OpenGL ni estado compartido:
+	// instancias distintas se pueden evaluar en hilos distintos
+	void Evaluate()
+	{
+		if (!this->bones.empty())
+			this->model->evaluatePlayer(this->player, this->state, this->bones[0].m, 12);
+	}
+
+	// Dibuja las mallas compartidas con la pose de esta instancia; shader es el programa que se pas a
+	// ModelAnim::initShaders, con model/view/projection ya asignados por quien llama
+	void Draw(Shader shader)
+	{
+		if (!this->bones.empty())
+			this->palette.Upload(this->bones[0].m, (GLuint)this->bones.size(), 12);
+		this->palette.Bind(this->model->m_bone_offset_location);
+
+		for (unsigned int i = 0; i < this->model->meshes.size(); i++)
+			this->model->meshes[i].Draw(shader);
+
+		this->palette.Fence();
+	}
+
+	// Tres filas por hueso; AnimationSystem las reescribe al interpolar entre dos evaluaciones
+	const std::vector<AffineTransform>& Bones() const { return this->bones; }
+	std::vector<AffineTransform>& Bones() { return this->bones; }
+	ModelAnim& Asset() { return *this->model; }
+
+	// Bytes propios de la instancia en la CPU; todo lo dems es de ModelAnim::MemoryBytes
+	size_t MemoryBytes() const
+	{
+		return sizeof(AnimatedInstance) + this->player.MemoryBytes() - sizeof(AnimationPlayer)
+			+ (this->state.node_local.capacity() + this->state.node_global.capacity() + this->bones.capacity()) * sizeof(AffineTransform)
+			+ this->state.node_animated.capacity();
+	}
+
+	// Bytes de su paleta en la GPU (se crea en el primer Draw)
+	size_t PaletteBytes() const
+	{
+		return BonePalette::MemoryBytes((GLuint)this->bones.size());
+	}
+
+private:
+	ModelAnim* model;
+	AnimationPlayer player;
+	double clock;
+	SkeletonState state;
+	std::vector<AffineTransform> bones;  // tres filas por hueso, en el formato de la paleta
+	BonePalette palette;
+
+	AnimatedInstance(const AnimatedInstance&);
+	AnimatedInstance& operator=(const AnimatedInstance&);
+};
@@ -0,0 +1,297 @@
+#pragma once
+
+// Std. Includes
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <algorithm>
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include "modelAnim.h"
+#include "Framebuffer.h"
+
+// Microbenchmark de la animacin esqueltica en la CPU sobre un modelo animado cualquiera.
+//  - Esqueleto: evaluacin recursiva original sobre la escena de Assimp (readNodeHierarchy) contra el
+//    esqueleto aplanado con los clips compactados (evaluateSkeleton).
+//  - Claves: reproduccin continua (cursores), saltos aleatorios (bsqueda binaria) y clips remuestreados.
+//  - Mezcla: el reproductor (boneTransform) con 1 a 4 capas contra un solo clip sin reproductor.
+// Cada fila reporta huesos evaluados por microsegundo y el error mximo contra la escena original.
+//  - Pasadas: el modelo dibujado en 1 y 3 pasadas de profundidad por frame, con la mezcla de huesos en el
+//    vertex shader de cada pasada contra el pre-skinning (una deformacin por frame) y con la pose fija.
+class AnimationBenchmark
+{
+public:
+	AnimationBenchmark(unsigned int iterations = 5000, GLuint frames = 200) : iterations(iterations), frames(frames)
+	{
+	}
+
+	// Carga el modelo dos veces conservando la escena de Assimp: con sus claves y remuestreado a 30 Hz
+	void Run(const std::string& path)
+	{
+		ModelAnim model(path, false, 0.0f, true);
+		if (model.m_clips.empty())
+		{
+			std::cout << "AnimationBenchmark: el modelo no tiene esqueleto animado" << std::endl;
+			return;
+		}
+		ModelAnim resampled(path, false, 30.0f, true);
+
+		const aiAnimation* animation = model.scene->mAnimations[0];
+		unsigned int keys = 0;
+		for (unsigned int i = 0; i < animation->mNumChannels; i++)
+		{
+			const aiNodeAnim* channel = animation->mChannels[i];
+			keys = std::max(keys, std::max(channel->mNumPositionKeys, std::max(channel->mNumRotationKeys, channel->mNumScalingKeys)));
+		}
+		std::cout << std::endl << "Animation benchmark (" << model.m_node_parent.size() << " nodos, " << model.m_num_bones
+			<< " huesos, " << animation->mNumChannels << " canales, hasta " << keys << " claves, " << this->iterations << " evaluaciones)" << std::endl;
+
+		RunSkeleton(model);
+		RunKeyLookup(model, resampled);
+		RunBlend(model);
+		RunPasses(model);
+		std::cout << std::endl;
+	}
+
+private:
+	unsigned int iterations;
+	GLuint frames;
+
+	enum SkinningMode { VERTEX_SKINNING, PRE_SKINNING, STATIC_POSE };
+
+	// Instante de la evaluacin i, repartido a lo largo del clip como en boneTransform
+	float SampleTime(const aiAnimation* animation, unsigned int i)
+	{
+		return (float)std::fmod(i * 0.37, animation->mDuration);
+	}
+
+	void RunSkeleton(ModelAnim& model)
+	{
+		const aiAnimation* animation = model.scene->mAnimations[0];
+		aiMatrix4x4 identity;
+
+		// Ruta recursiva original
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (unsigned int i = 0; i < this->iterations; i++)
+		{
+			model.readNodeHierarchy(SampleTime(animation, i), model.scene->mRootNode, identity);
+		}
+		std::chrono::duration<double, std::micro> recursive = std::chrono::steady_clock::now() - start;
+
+		// Esqueleto aplanado
+		start = std::chrono::steady_clock::now();
+		for (unsigned int i = 0; i < this->iterations; i++)
+		{
+			model.evaluateSkeleton(SampleTime(animation, i));
+		}
+		std::chrono::duration<double, std::micro> flat = std::chrono::steady_clock::now() - start;
+
+		std::vector<float> times;
+		for (unsigned int i = 0; i < 64; i++)
+			times.push_back(SampleTime(animation, i * 17));
+
+		PrintRow(model, "esqueleto", "recursivo", recursive.count(), recursive.count(), 0.0f);
+		PrintRow(model, "esqueleto", "aplanado", flat.count(), recursive.count(), SourceError(model, model, times));
+	}
+
+	void RunKeyLookup(ModelAnim& model, ModelAnim& resampled)
+	{
+		const aiAnimation* animation = model.scene->mAnimations[0];
+
+		// Reproduccin a 60 fps y los mismos instantes en desorden (cada evaluacin es un salto)
+		std::vector<float> playback(this->iterations);
+		for (unsigned int i = 0; i < this->iterations; i++)
+			playback[i] = (float)std::fmod(i * model.ticks_per_second / 60.0, animation->mDuration);
+		std::vector<float> seeks(playback);
+		std::shuffle(seeks.begin(), seeks.end(), std::mt19937(1));
+
+		double cursors = TimeSkeleton(model, playback);
+		double jumps = TimeSkeleton(model, seeks);
+		double sampled = TimeSkeleton(resampled, playback);
+
+		std::vector<float> times(seeks.begin(), seeks.begin() + std::min<size_t>(64, seeks.size()));
+		PrintRow(model, "claves", "cursores", cursors, cursors, 0.0f);
+		PrintRow(model, "claves", "saltos", jumps, cursors, 0.0f);
+		PrintRow(model, "claves", "30 Hz", sampled, cursors, SourceError(model, resampled, times));
+	}
+
+	// Capas de igual peso a 60 fps; si el modelo tiene menos clips se repiten desfasados en el tiempo
+	void RunBlend(ModelAnim& model)
+	{
+		std::vector<float> playback(this->iterations);
+		for (unsigned int i = 0; i < this->iterations; i++)
+			playback[i] = (float)std::fmod(i * model.ticks_per_second / 60.0, model.m_clips[0].duration);
+		double single = TimeSkeleton(model, playback);
+		PrintRow(model, "mezcla", "sin capas", single, single, 0.0f);
+
+		const char* names[] = { "1 clip", "2 clips", "3 clips", "4 clips" };
+		for (unsigned int layers = 1; layers <= 4; layers++)
+		{
+			model.m_player.Reset(&model.m_clips, model.m_bind_pose);
+			for (unsigned int k = 0; k < layers; k++)
+			{
+				unsigned int clip = k % model.m_clips.size();
+				model.m_player.AddLayer(clip, 1.0f / layers);
+				model.m_player.SetTime(k, k * 0.25f * model.m_clips[clip].duration / model.m_clips[clip].ticks_per_second);
+			}
+
+			model.m_clock = 0.0;
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			for (unsigned int i = 1; i <= this->iterations; i++)
+			{
+				model.boneTransform(i / 60.0);
+			}
+			std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+			PrintRow(model, "mezcla", names[layers - 1], elapsed.count(), single, 0.0f);
+		}
+
+		model.m_player.Reset(&model.m_clips, model.m_bind_pose);
+		model.m_player.Play(0);
+		model.m_clock = 0.0;
+	}
+
+	// Todos los tringulos se descartan despus del vertex shader (GL_FRONT_AND_BACK) para medir solo el costo
+	// por vrtice: la cobertura de la malla cambia con la pose y no debe pesar en la comparacin
+	void RunPasses(ModelAnim& model)
+	{
+		Shader vertexShader("Shaders/skinning.vs", "Shaders/depth.frag");
+		Shader preskinShader("Shaders/skinning.vs", "Shaders/preskin.frag", "#define PRESKIN\n", ModelAnim::PreSkinVaryings());
+		Shader staticShader("Shaders/depth.vs", "Shaders/depth.frag");
+		model.initShaders(vertexShader.Program);
+		model.enablePreSkinning(preskinShader.Program);
+		SetIdentityUniforms(vertexShader.Program);
+		SetIdentityUniforms(staticShader.Program);
+
+		unsigned int vertices = 0;
+		for (unsigned int i = 0; i < model.meshes.size(); i++)
+			vertices += (unsigned int)model.meshes[i].vertices.size();
+
+		Framebuffer target(64, 64);
+		target.Bind();
+		glEnable(GL_CULL_FACE);
+		glCullFace(GL_FRONT_AND_BACK);
+		const GLuint passCounts[] = { 1, 3 };
+		for (unsigned int i = 0; i < 2; i++)
+		{
+			GLuint passes = passCounts[i];
+			std::string group = "pasadas x" + std::to_string(passes);
+			double skinning = TimePasses(model, vertexShader, passes, VERTEX_SKINNING);
+			double preskin = TimePasses(model, staticShader, passes, PRE_SKINNING);
+			double paused = TimePasses(model, staticShader, passes, STATIC_POSE);
+
+			PrintPassRow(group, "vertex", skinning, skinning, vertices * passes);
+			PrintPassRow(group, "pre-skin", preskin, skinning, vertices);
+			PrintPassRow(group, "pose fija", paused, skinning, 0);
+		}
+		glCullFace(GL_BACK);
+		glDisable(GL_CULL_FACE);
+		Framebuffer::Unbind();
+		glUseProgram(0);
+	}
+
+	// Milisegundos de pared por frame entre dos glFinish (lo confiable tambin en llvmpipe)
+	double TimePasses(ModelAnim& model, Shader& shader, GLuint passes, SkinningMode mode)
+	{
+		glFinish();
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (GLuint frame = 0; frame < this->frames; frame++)
+		{
+			double time = mode == STATIC_POSE ? 0.0 : frame / 60.0;
+			glClear(GL_DEPTH_BUFFER_BIT);
+			if (mode == VERTEX_SKINNING)
+			{
+				model.boneTransform(time);
+				model.m_palette.Upload(model.m_bone_matrices);
+				shader.Use();
+				model.m_palette.Bind(model.m_bone_offset_location);
+				for (GLuint pass = 0; pass < passes; pass++)
+					for (unsigned int i = 0; i < model.meshes.size(); i++)
+						model.meshes[i].Draw(shader);
+				model.m_palette.Fence();
+			}
+			else
+			{
+				model.Update(time);
+				shader.Use();
+				for (GLuint pass = 0; pass < passes; pass++)
+					model.DrawSkinned(shader);
+			}
+		}
+		glFinish();
+		std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+		return elapsed.count() / this->frames;
+	}
+
+	static void SetIdentityUniforms(GLuint program)
+	{
+		glm::mat4 identity(1.0f);
+		glm::mat3 normalMatrix(1.0f);
+		glUseProgram(program);
+		glUniformMatrix4fv(glGetUniformLocation(program, "model"), 1, GL_FALSE, glm::value_ptr(identity));
+		glUniformMatrix4fv(glGetUniformLocation(program, "view"), 1, GL_FALSE, glm::value_ptr(identity));
+		glUniformMatrix4fv(glGetUniformLocation(program, "projection"), 1, GL_FALSE, glm::value_ptr(identity));
+		glUniformMatrix3fv(glGetUniformLocation(program, "normalMatrix"), 1, GL_FALSE, glm::value_ptr(normalMatrix));
+	}
+
+	// skinned: vrtices que pasan por la mezcla de huesos en cada frame
+	void PrintPassRow(const std::string& group, const char* name, double milliseconds, double baseline, unsigned int skinned)
+	{
+		std::cout << std::left << std::setw(14) << group << std::setw(12) << name
+			<< std::right << std::fixed << std::setprecision(3) << std::setw(10) << milliseconds << " ms/frame"
+			<< std::setprecision(2) << std::setw(8) << baseline / milliseconds << "x  (" << skinned << " vertices deformados)" << std::endl;
+	}
+
+	// Microsegundos en evaluar el esqueleto en cada uno de los instantes dados
+	double TimeSkeleton(ModelAnim& model, const std::vector<float>& times)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (unsigned int i = 0; i < times.size(); i++)
+		{
+			model.evaluateSkeleton(times[i]);
+		}
+		std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+		return elapsed.count();
+	}
+
+	static std::vector<aiMatrix4x4> BoneMatrices(ModelAnim& model)
+	{
+		std::vector<aiMatrix4x4> matrices(model.m_num_bones);
+		for (unsigned int b = 0; b < model.m_num_bones; b++)
+			matrices[b] = model.m_bone_matrices[b].final_world_transform;
+		return matrices;
+	}
+
+	// Diferencia absoluta mxima entre las matrices de los huesos de target y las de la escena original de source
+	static float SourceError(ModelAnim& source, ModelAnim& target, const std::vector<float>& times)
+	{
+		float maxError = 0.0f;
+		for (unsigned int i = 0; i < times.size(); i++)
+		{
+			source.readNodeHierarchy(times[i], source.scene->mRootNode, aiMatrix4x4());
+			std::vector<aiMatrix4x4> expected = BoneMatrices(source);
+			target.evaluateSkeleton(times[i]);
+			for (unsigned int b = 0; b < target.m_num_bones; b++)
+			{
+				const ai_real* a = expected[b][0];
+				const ai_real* c = target.m_bone_matrices[b].final_world_transform[0];
+				for (unsigned int k = 0; k < 16; k++)
+					maxError = std::max(maxError, (float)std::fabs(a[k] - c[k]));
+			}
+		}
+		return maxError;
+	}
+
+	void PrintRow(ModelAnim& model, const char* group, const char* name, double microseconds, double baseline, float maxError)
+	{
+		double bones = (double)model.m_num_bones * this->iterations;
+		std::cout << std::left << std::setw(14) << group << std::setw(12) << name
+			<< std::right << std::fixed << std::setprecision(2) << std::setw(10) << bones / microseconds << " huesos/us"
+			<< std::setw(8) << baseline / microseconds << "x  (error max " << std::scientific << std::setprecision(1) << maxError << ")"
+			<< std::fixed << std::endl;
+	}
+};
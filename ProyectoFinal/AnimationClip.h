@@ -0,0 +1,514 @@
+#pragma once
+
+// Std. Includes
+#include <vector>
+#include <string>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <limits>
+
+#include <assimp/scene.h>
+
+#include "AnimationPose.h"
+
+// ltimo tramo de claves usado en cada pista de un canal; de un frame al siguiente casi siempre es el mismo
+struct KeyCursor
+{
+	unsigned int position = 0;
+	unsigned int rotation = 0;
+	unsigned int scaling = 0;
+};
+
+inline float keyTime(const aiVectorKey& key) { return (float)key.mTime; }
+inline float keyTime(const aiQuatKey& key) { return (float)key.mTime; }
+inline float keyTime(uint16_t time) { return (float)time; }
+inline float keyTime(float time) { return time; }
+
+// Tramo de claves que contiene time: keyTime(keys[i]) <= time < keyTime(keys[i + 1]).
+// Primero prueba el tramo del cursor y el siguiente (de un frame al otro casi nunca se avanza ms),
+// y si no coinciden (salto o vuelta al inicio del clip) hace bsqueda binaria. Antes de la primera
+// clave o despus de la ltima devuelve el primer o el ltimo tramo; keyFactor satura la mezcla.
+template <typename KeyType>
+unsigned int findKey(float time, const KeyType* keys, unsigned int num_keys, unsigned int& cursor)
+{
+	unsigned int last = num_keys - 2; // ndice del ltimo tramo
+	if (last == 0 || time < keyTime(keys[1]))
+		return cursor = 0;
+	if (time >= keyTime(keys[last]))
+		return cursor = last;
+
+	// Aqu keys[1] <= time < keys[last], as que el tramo est en [1, last - 1]
+	if (cursor >= 1 && cursor < last && time >= keyTime(keys[cursor]))
+	{
+		if (time < keyTime(keys[cursor + 1]))
+			return cursor;
+		if (cursor + 1 < last && time < keyTime(keys[cursor + 2]))
+			return ++cursor;
+	}
+
+	unsigned int low = 1, high = last - 1;
+	while (low < high)
+	{
+		unsigned int middle = (low + high + 1) / 2;
+		if (keyTime(keys[middle]) <= time)
+			low = middle;
+		else
+			high = middle - 1;
+	}
+	return cursor = low;
+}
+
+// Fraccin del tramo [start_time, end_time]; fuera del clip o en un tramo sin duracin se satura en vez de fallar
+inline float keyFactor(float time, float start_time, float end_time)
+{
+	float delta_time = end_time - start_time;
+	if (delta_time <= 0.0f)
+		return 0.0f;
+	float factor = (time - start_time) / delta_time;
+	return factor < 0.0f ? 0.0f : (factor > 1.0f ? 1.0f : factor);
+}
+
+// Tiempos de las claves de una pista. Normalmente en punto fijo (0..65535 = inicio..fin del clip); si dos
+// claves quedan a menos de MIN_FIXED_KEY_GAP pasos el redondeo pesara en la interpolacin y la pista
+// guarda sus tiempos en float (ticks). Ambos vacos en un clip de frecuencia fija
+struct KeyTimes
+{
+	std::vector<uint16_t> fixed;
+	std::vector<float> ticks;
+};
+
+// Posiciones o escalas de un canal, cuantizadas a 16 bits por componente dentro de la caja que las contiene
+struct QuantizedVectorTrack
+{
+	KeyTimes times;
+	std::vector<uint16_t> values;  // 3 por clave; una sola clave si la pista es constante
+	aiVector3D origin;             // esquina mnima de la caja
+	aiVector3D step;               // tamao de la caja / 65535 (cero en una pista constante: origin es el valor exacto)
+};
+
+// Rotaciones de un canal con "smallest three": se omite la componente ms grande (se reconstruye porque
+// el cuaternin es unitario) y las otras tres van en 15 bits; el ndice de la omitida usa los bits altos
+struct QuantizedRotationTrack
+{
+	KeyTimes times;
+	std::vector<uint16_t> values;  // 3 por clave
+};
+
+struct ClipTrack
+{
+	int node;                      // nodo del esqueleto aplanado que anima
+	QuantizedVectorTrack position;
+	QuantizedRotationTrack rotation;
+	QuantizedVectorTrack scaling;
+};
+
+// Tramo de claves vigente de cada pista de un clip para una reproduccin, ya decodificado, en estructura
+// de arreglos por pista. Mientras el instante no salga del tramo, muestrear la pista es una interpolacin
+// sin buscar ni decodificar claves, y las pistas se interpolan de cuatro en cuatro (AnimationClip::SamplePose).
+// Cada grupo (posicin, rotacin, escala) guarda el inicio del tramo, 1 / duracin, el intervalo de
+// instantes en que sigue vigente, el valor inicial y la diferencia hasta el final
+struct SegmentCache
+{
+	enum
+	{
+		P_START, P_INVERSE, P_LOW, P_HIGH, PX, PY, PZ, PDX, PDY, PDZ,
+		R_START, R_INVERSE, R_LOW, R_HIGH, RX, RY, RZ, RW, RDX, RDY, RDZ, RDW,
+		S_START, S_INVERSE, S_LOW, S_HIGH, SX, SY, SZ, SDX, SDY, SDZ,
+		CHANNELS
+	};
+
+	unsigned int stride = 0;       // pistas redondeadas a mltiplo de 4
+	std::vector<float> data;       // CHANNELS arreglos de stride floats
+	std::vector<KeyCursor> cursors;
+
+	float* Channel(unsigned int channel) { return &this->data[channel * this->stride]; }
+};
+
+// Clip de animacin compactado al cargar el modelo; una vez horneado ya no hace falta la escena de Assimp.
+// Con sample_rate = 0 cada pista conserva sus claves con su tiempo (bsqueda con cursor, ver KeyTimes);
+// con sample_rate > 0 las claves son muestras uniformes y la clave de un instante sale de un ndice (O(1)).
+class AnimationClip
+{
+public:
+	static const unsigned int MIN_FIXED_KEY_GAP = 64;
+
+	std::string name;
+	float duration;                // en ticks
+	float ticks_per_second;
+	float sample_rate;             // muestras por tick (0 = claves con tiempo)
+	std::vector<ClipTrack> tracks;
+	std::vector<int> node_track;   // pista que anima cada nodo del esqueleto (-1 = ninguna)
+
+	AnimationClip(const std::string& name, float duration, float ticks_per_second, float sample_rate, unsigned int num_nodes)
+		: name(name), duration(duration), ticks_per_second(ticks_per_second), sample_rate(sample_rate), node_track(num_nodes, -1)
+	{
+	}
+
+	// Agrega la pista de node. Los tiempos van en ticks y se ignoran en un clip de frecuencia fija
+	// (ah la clave j es el instante j / sample_rate). Las pistas constantes se reducen a una clave
+	void AddTrack(int node, const std::vector<float>& position_times, const std::vector<aiVector3D>& positions,
+		const std::vector<float>& rotation_times, const std::vector<aiQuaternion>& rotations,
+		const std::vector<float>& scaling_times, const std::vector<aiVector3D>& scalings)
+	{
+		ClipTrack track;
+		track.node = node;
+		QuantizeVectors(position_times, positions, track.position);
+		QuantizeRotations(rotation_times, rotations, track.rotation);
+		QuantizeVectors(scaling_times, scalings, track.scaling);
+
+		this->node_track[node] = (int)this->tracks.size();
+		this->tracks.push_back(track);
+	}
+
+	// Traslacin, rotacin y escala de la pista en el instante time (en ticks)
+	void Sample(unsigned int track_index, float time, KeyCursor& cursor, aiVector3D& position, aiQuaternion& rotation, aiVector3D& scaling) const
+	{
+		const ClipTrack& track = this->tracks[track_index];
+		position = SampleVector(track.position, time, cursor.position);
+		rotation = SampleRotation(track.rotation, time, cursor.rotation);
+		scaling = SampleVector(track.scaling, time, cursor.scaling);
+	}
+
+	// Deja cache sin tramos vigentes: el primer SamplePose los busca y decodifica todos
+	void ResetCache(SegmentCache& cache) const
+	{
+		unsigned int count = (unsigned int)this->tracks.size();
+		cache.stride = (count + 3) & ~3u;
+		cache.data.assign(SegmentCache::CHANNELS * cache.stride, 0.0f);
+		cache.cursors.assign(count, KeyCursor());
+		const float infinity = std::numeric_limits<float>::infinity();
+		const unsigned int bounds[] = { SegmentCache::P_LOW, SegmentCache::R_LOW, SegmentCache::S_LOW };
+		for (unsigned int b = 0; b < 3; b++)
+		{
+			std::fill_n(cache.Channel(bounds[b]), count, infinity);
+			std::fill_n(cache.Channel(bounds[b] + 1), count, -infinity);
+		}
+		// El relleno interpola una rotacin identidad
+		std::fill_n(cache.Channel(SegmentCache::RW), cache.stride, 1.0f);
+	}
+
+	// Muestrea todas las pistas en pose; los nodos sin pista conservan lo que ya tenan (normalmente la pose
+	// de reposo). Solo las pistas que salieron de su tramo vuelven a buscar y decodificar claves; la
+	// interpolacin (lineal en posicin y escala, nlerp en rotacin) es SIMD sobre cuatro pistas a la vez
+	void SamplePose(float time, SegmentCache& cache, LocalPose& pose) const
+	{
+		unsigned int count = (unsigned int)this->tracks.size();
+		const float* position_low = cache.Channel(SegmentCache::P_LOW);
+		const float* rotation_low = cache.Channel(SegmentCache::R_LOW);
+		const float* scaling_low = cache.Channel(SegmentCache::S_LOW);
+		for (unsigned int i = 0; i < count; i++)
+		{
+			const ClipTrack& track = this->tracks[i];
+			if (!(time >= position_low[i] && time < position_low[i + cache.stride]))
+				FillVectorSegment(track.position, time, i, SegmentCache::P_START, cache.cursors[i].position, cache);
+			if (!(time >= rotation_low[i] && time < rotation_low[i + cache.stride]))
+				FillRotationSegment(track.rotation, time, i, cache.cursors[i].rotation, cache);
+			if (!(time >= scaling_low[i] && time < scaling_low[i + cache.stride]))
+				FillVectorSegment(track.scaling, time, i, SegmentCache::S_START, cache.cursors[i].scaling, cache);
+		}
+
+		const float4 t = splat4(time);
+		const float4 zero = splat4(0.0f);
+		const float4 one = splat4(1.0f);
+		float values[LocalPose::CHANNELS][4];
+		for (unsigned int i = 0; i < count; i += 4)
+		{
+			const float* c = &cache.data[i];
+			const unsigned int n = cache.stride;
+			float4 position_factor = min4(max4(mul4(sub4(t, load4(c + SegmentCache::P_START * n)), load4(c + SegmentCache::P_INVERSE * n)), zero), one);
+			float4 rotation_factor = min4(max4(mul4(sub4(t, load4(c + SegmentCache::R_START * n)), load4(c + SegmentCache::R_INVERSE * n)), zero), one);
+			float4 scaling_factor = min4(max4(mul4(sub4(t, load4(c + SegmentCache::S_START * n)), load4(c + SegmentCache::S_INVERSE * n)), zero), one);
+			for (unsigned int k = 0; k < 3; k++)
+			{
+				store4(values[LocalPose::TX + k], madd4(position_factor, load4(c + (SegmentCache::PDX + k) * n), load4(c + (SegmentCache::PX + k) * n)));
+				store4(values[LocalPose::SX + k], madd4(scaling_factor, load4(c + (SegmentCache::SDX + k) * n), load4(c + (SegmentCache::SX + k) * n)));
+			}
+			float4 q[4];
+			for (unsigned int k = 0; k < 4; k++)
+				q[k] = madd4(rotation_factor, load4(c + (SegmentCache::RDX + k) * n), load4(c + (SegmentCache::RX + k) * n));
+			float4 length = sqrt4(madd4(q[0], q[0], madd4(q[1], q[1], madd4(q[2], q[2], mul4(q[3], q[3])))));
+			for (unsigned int k = 0; k < 4; k++)
+				store4(values[LocalPose::RX + k], div4(q[k], length));
+
+			unsigned int lanes = count - i < 4 ? count - i : 4;
+			for (unsigned int lane = 0; lane < lanes; lane++)
+			{
+				float* node = &pose.data[this->tracks[i + lane].node];
+				for (unsigned int k = 0; k < LocalPose::CHANNELS; k++)
+					node[k * pose.stride] = values[k][lane];
+			}
+		}
+	}
+
+	// Bytes que ocupa el clip en memoria (datos de las pistas ms los encabezados)
+	size_t MemoryBytes() const
+	{
+		size_t bytes = sizeof(AnimationClip) + this->name.capacity() + this->node_track.capacity() * sizeof(int)
+			+ this->tracks.capacity() * sizeof(ClipTrack);
+		for (unsigned int i = 0; i < this->tracks.size(); i++)
+		{
+			const ClipTrack& track = this->tracks[i];
+			bytes += TimesBytes(track.position.times) + TimesBytes(track.rotation.times) + TimesBytes(track.scaling.times)
+				+ (track.position.values.capacity() + track.rotation.values.capacity() + track.scaling.values.capacity()) * sizeof(uint16_t);
+		}
+		return bytes;
+	}
+
+	static aiQuaternion Nlerp(aiQuaternion a, const aiQuaternion& b, float blend)
+	{
+		float sign = (a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w) < 0.0f ? -1.0f : 1.0f;
+		a.x = a.x * (1.0f - blend) + sign * blend * b.x;
+		a.y = a.y * (1.0f - blend) + sign * blend * b.y;
+		a.z = a.z * (1.0f - blend) + sign * blend * b.z;
+		a.w = a.w * (1.0f - blend) + sign * blend * b.w;
+		return a.Normalize();
+	}
+
+private:
+	static size_t TimesBytes(const KeyTimes& times)
+	{
+		return times.fixed.capacity() * sizeof(uint16_t) + times.ticks.capacity() * sizeof(float);
+	}
+
+	// Instante en ticks de la clave index
+	float KeyTick(const KeyTimes& times, unsigned int index) const
+	{
+		if (this->sample_rate > 0.0f)
+			return index / this->sample_rate;
+		if (!times.ticks.empty())
+			return times.ticks[index];
+		return times.fixed[index] * (this->duration * (1.0f / 65535.0f));
+	}
+
+	// Tramo de claves de time en los canales start.. de cache (inicio, 1 / duracin e intervalo vigente, como
+	// FindSegment: el primer tramo vale hacia atrs y el ltimo hacia adelante). Devuelve la clave inicial
+	unsigned int FillSegment(const KeyTimes& times, unsigned int num_keys, float time, unsigned int track, unsigned int start,
+		unsigned int& cursor, SegmentCache& cache) const
+	{
+		const float infinity = std::numeric_limits<float>::infinity();
+		unsigned int index = 0;
+		float start_time = 0.0f, inverse = 0.0f, low = -infinity, high = infinity;
+		if (num_keys > 1)
+		{
+			index = SegmentIndex(times, num_keys, time, cursor);
+			start_time = KeyTick(times, index);
+			float end_time = KeyTick(times, index + 1);
+			inverse = end_time > start_time ? 1.0f / (end_time - start_time) : 0.0f;
+			if (index > 0)
+				low = start_time;
+			if (index < num_keys - 2)
+				high = end_time;
+		}
+		cache.Channel(start)[track] = start_time;
+		cache.Channel(start + 1)[track] = inverse;
+		cache.Channel(start + 2)[track] = low;
+		cache.Channel(start + 3)[track] = high;
+		return index;
+	}
+
+	void FillVectorSegment(const QuantizedVectorTrack& vectors, float time, unsigned int track, unsigned int start,
+		unsigned int& cursor, SegmentCache& cache) const
+	{
+		unsigned int num_keys = (unsigned int)vectors.values.size() / 3;
+		unsigned int index = FillSegment(vectors.times, num_keys, time, track, start, cursor, cache);
+		aiVector3D from = DecodeVector(vectors, index);
+		aiVector3D delta = num_keys > 1 ? DecodeVector(vectors, index + 1) - from : aiVector3D(0.0f, 0.0f, 0.0f);
+		for (unsigned int k = 0; k < 3; k++)
+		{
+			cache.Channel(start + 4 + k)[track] = from[k];
+			cache.Channel(start + 7 + k)[track] = delta[k];
+		}
+	}
+
+	// Como Nlerp: la clave final se toma en el hemisferio de la inicial
+	void FillRotationSegment(const QuantizedRotationTrack& rotations, float time, unsigned int track, unsigned int& cursor,
+		SegmentCache& cache) const
+	{
+		unsigned int num_keys = (unsigned int)rotations.values.size() / 3;
+		unsigned int index = FillSegment(rotations.times, num_keys, time, track, SegmentCache::R_START, cursor, cache);
+		aiQuaternion from = DecodeRotation(&rotations.values[index * 3]);
+		aiQuaternion to = num_keys > 1 ? DecodeRotation(&rotations.values[index * 3 + 3]) : from;
+		float sign = (from.x * to.x + from.y * to.y + from.z * to.z + from.w * to.w) < 0.0f ? -1.0f : 1.0f;
+		const float start[4] = { from.x, from.y, from.z, from.w };
+		const float end[4] = { sign * to.x, sign * to.y, sign * to.z, sign * to.w };
+		for (unsigned int k = 0; k < 4; k++)
+		{
+			cache.Channel(SegmentCache::RX + k)[track] = start[k];
+			cache.Channel(SegmentCache::RDX + k)[track] = end[k] - start[k];
+		}
+	}
+
+	// Clave inicial del tramo que contiene time y la fraccin recorrida hacia la siguiente
+	unsigned int FindSegment(const KeyTimes& times, unsigned int num_keys, float time, unsigned int& cursor, float& factor) const
+	{
+		factor = 0.0f;
+		if (num_keys == 1)
+			return 0;
+
+		unsigned int index = SegmentIndex(times, num_keys, time, cursor);
+		if (this->sample_rate > 0.0f)
+			factor = std::min(std::max(time, 0.0f) * this->sample_rate - index, 1.0f);
+		else if (!times.ticks.empty())
+			factor = keyFactor(time, times.ticks[index], times.ticks[index + 1]);
+		else
+			factor = keyFactor(FixedTime(time), keyTime(times.fixed[index]), keyTime(times.fixed[index + 1]));
+		return index;
+	}
+
+	// Solo la clave inicial del tramo (num_keys > 1)
+	unsigned int SegmentIndex(const KeyTimes& times, unsigned int num_keys, float time, unsigned int& cursor) const
+	{
+		if (this->sample_rate > 0.0f)
+			return std::min((unsigned int)(std::max(time, 0.0f) * this->sample_rate), num_keys - 2);
+		if (!times.ticks.empty())
+			return findKey(time, &times.ticks[0], num_keys, cursor);
+		return findKey(FixedTime(time), &times.fixed[0], num_keys, cursor);
+	}
+
+	float FixedTime(float time) const
+	{
+		return this->duration > 0.0f ? time * 65535.0f / this->duration : 0.0f;
+	}
+
+	aiVector3D SampleVector(const QuantizedVectorTrack& track, float time, unsigned int& cursor) const
+	{
+		float factor;
+		unsigned int index = FindSegment(track.times, (unsigned int)track.values.size() / 3, time, cursor, factor);
+		aiVector3D start = DecodeVector(track, index);
+		if (factor == 0.0f)
+			return start;
+		return start + factor * (DecodeVector(track, index + 1) - start);
+	}
+
+	aiQuaternion SampleRotation(const QuantizedRotationTrack& track, float time, unsigned int& cursor) const
+	{
+		float factor;
+		unsigned int index = FindSegment(track.times, (unsigned int)track.values.size() / 3, time, cursor, factor);
+		aiQuaternion start = DecodeRotation(&track.values[index * 3]);
+		if (factor == 0.0f)
+			return start;
+		return Nlerp(start, DecodeRotation(&track.values[index * 3 + 3]), factor);
+	}
+
+	void QuantizeTimes(const std::vector<float>& source, unsigned int num_keys, KeyTimes& times)
+	{
+		if (this->sample_rate > 0.0f)
+			return;
+		for (unsigned int i = 0; i < num_keys; i++)
+		{
+			float normalized = this->duration > 0.0f ? source[i] / this->duration : 0.0f;
+			times.fixed.push_back((uint16_t)std::lround(std::min(std::max(normalized, 0.0f), 1.0f) * 65535.0f));
+		}
+		for (unsigned int i = 1; i < num_keys; i++)
+		{
+			if ((unsigned int)(times.fixed[i] - times.fixed[i - 1]) < MIN_FIXED_KEY_GAP)
+			{
+				times.fixed.clear();
+				times.ticks.assign(source.begin(), source.begin() + num_keys);
+				return;
+			}
+		}
+	}
+
+	void QuantizeVectors(const std::vector<float>& source_times, const std::vector<aiVector3D>& source, QuantizedVectorTrack& track)
+	{
+		aiVector3D low = source[0], high = source[0];
+		for (unsigned int i = 1; i < source.size(); i++)
+		{
+			low = aiVector3D(std::min(low.x, source[i].x), std::min(low.y, source[i].y), std::min(low.z, source[i].z));
+			high = aiVector3D(std::max(high.x, source[i].x), std::max(high.y, source[i].y), std::max(high.z, source[i].z));
+		}
+
+		track.origin = low;
+		track.step = (high - low) / 65535.0f;
+		bool constant = std::max(high.x - low.x, std::max(high.y - low.y, high.z - low.z)) <= 1e-6f;
+		if (constant)
+		{
+			track.origin = source[0];
+			track.step = aiVector3D(0.0f, 0.0f, 0.0f);
+		}
+
+		unsigned int num_keys = constant ? 1 : (unsigned int)source.size();
+		QuantizeTimes(source_times, num_keys, track.times);
+		for (unsigned int i = 0; i < num_keys; i++)
+		{
+			const ai_real* value = &source[i].x;
+			const ai_real* origin = &track.origin.x;
+			const ai_real* step = &track.step.x;
+			for (unsigned int c = 0; c < 3; c++)
+				track.values.push_back(step[c] > 0.0f ? (uint16_t)std::lround((value[c] - origin[c]) / step[c]) : 0);
+		}
+	}
+
+	void QuantizeRotations(const std::vector<float>& source_times, const std::vector<aiQuaternion>& source, QuantizedRotationTrack& track)
+	{
+		// Constante si todas las rotaciones son la primera (q y -q son la misma rotacin)
+		aiQuaternion first = source[0];
+		first.Normalize();
+		bool constant = true;
+		for (unsigned int i = 1; i < source.size() && constant; i++)
+		{
+			aiQuaternion q = source[i];
+			q.Normalize();
+			double dot = (double)first.x * q.x + (double)first.y * q.y + (double)first.z * q.z + (double)first.w * q.w;
+			constant = std::fabs(dot) >= 1.0 - 1e-10;
+		}
+
+		unsigned int num_keys = constant ? 1 : (unsigned int)source.size();
+		QuantizeTimes(source_times, num_keys, track.times);
+		track.values.resize(num_keys * 3);
+		for (unsigned int i = 0; i < num_keys; i++)
+			EncodeRotation(source[i], &track.values[i * 3]);
+	}
+
+	aiVector3D DecodeVector(const QuantizedVectorTrack& track, unsigned int index) const
+	{
+		const uint16_t* value = &track.values[index * 3];
+		return aiVector3D(track.origin.x + value[0] * track.step.x, track.origin.y + value[1] * track.step.y,
+			track.origin.z + value[2] * track.step.z);
+	}
+
+	static void EncodeRotation(aiQuaternion q, uint16_t* out)
+	{
+		q.Normalize();
+		const float components[4] = { q.x, q.y, q.z, q.w };
+		unsigned int largest = 0;
+		for (unsigned int i = 1; i < 4; i++)
+		{
+			if (std::fabs(components[i]) > std::fabs(components[largest]))
+				largest = i;
+		}
+
+		// La omitida se guarda positiva: si es negativa se usa -q, que es la misma rotacin.
+		// Las otras tres estn en [-1/raz(2), 1/raz(2)] y se llevan a [0, 32767]
+		float sign = components[largest] < 0.0f ? -1.0f : 1.0f;
+		unsigned int k = 0;
+		for (unsigned int i = 0; i < 4; i++)
+		{
+			if (i == largest)
+				continue;
+			float normalized = sign * components[i] * 0.70710678f + 0.5f;
+			out[k++] = (uint16_t)std::lround(std::min(std::max(normalized, 0.0f), 1.0f) * 32767.0f);
+		}
+		out[0] |= (uint16_t)((largest >> 1) << 15);
+		out[1] |= (uint16_t)((largest & 1) << 15);
+	}
+
+	static aiQuaternion DecodeRotation(const uint16_t* in)
+	{
+		// Posicin de las tres componentes guardadas segn cul se omiti (sin saltos que dependan del dato)
+		static const unsigned char stored[4][3] = { { 1, 2, 3 }, { 0, 2, 3 }, { 0, 1, 3 }, { 0, 1, 2 } };
+		const float scale = 1.41421356f / 32767.0f;
+		unsigned int largest = ((in[0] >> 15) << 1) | (in[1] >> 15);
+		float a = (in[0] & 0x7FFF) * scale - 0.70710678f;
+		float b = (in[1] & 0x7FFF) * scale - 0.70710678f;
+		float c = (in[2] & 0x7FFF) * scale - 0.70710678f;
+		float components[4];
+		components[stored[largest][0]] = a;
+		components[stored[largest][1]] = b;
+		components[stored[largest][2]] = c;
+		components[largest] = std::sqrt(std::max(1.0f - (a * a + b * b + c * c), 0.0f));
+		return aiQuaternion(components[3], components[0], components[1], components[2]);
+	}
+};
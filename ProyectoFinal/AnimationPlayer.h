@@ -0,0 +1,257 @@
+#pragma once
+
+// Std. Includes
+#include <vector>
+#include <string>
+#include <cmath>
+
+#include "AnimationClip.h"
+#include "AnimationPose.h"
+
+// Reproduccin de un clip dentro de un AnimationPlayer: instante, velocidad, bucle y peso en la mezcla
+struct ClipPlayback
+{
+	unsigned int clip;
+	float time = 0.0f;            // en ticks del clip
+	float speed = 1.0f;           // 1 = velocidad original, 0 = detenido, negativa = en reversa
+	bool loop = true;             // sin bucle se detiene en el primer o ltimo instante
+	float weight = 1.0f;          // peso actual en la mezcla
+	float target_weight = 1.0f;   // peso al que se acerca con fade_rate
+	float fade_rate = 0.0f;       // peso por segundo (0 = ya lleg)
+	SegmentCache cache;           // tramos de claves vigentes de cada pista del clip
+};
+
+// Estado de animacin de una instancia sobre clips que no le pertenecen: una o varias reproducciones
+// (capas) con su propio tiempo que se mezclan por peso. Play hace un crossfade hacia un clip; AddLayer
+// suma capas para mezclas de N vas. Cada capa se muestrea a su pose SoA y blendPoses las combina
+class AnimationPlayer
+{
+public:
+	static const unsigned int MAX_LAYERS = 8;
+	static const unsigned int NO_CLIP = (unsigned int)-1;
+
+	AnimationPlayer() : clips(NULL), paused(false)
+	{
+	}
+
+	// clips deben vivir ms que el reproductor; bind_pose es la pose de reposo del esqueleto
+	void Reset(const std::vector<AnimationClip>* clips, const LocalPose& bind_pose)
+	{
+		this->clips = clips;
+		this->bindPose = &bind_pose;
+		this->layers.clear();
+		this->poses.clear();
+		this->blended = LocalPose();
+	}
+
+	// ndice del clip con ese nombre, o NO_CLIP si no existe
+	unsigned int FindClip(const std::string& name) const
+	{
+		for (unsigned int i = 0; i < this->clips->size(); i++)
+		{
+			if ((*this->clips)[i].name == name)
+				return i;
+		}
+		return NO_CLIP;
+	}
+
+	// Pasa a reproducir clip desde el inicio: las dems capas se desvanecen en fade_seconds (0 = corte)
+	unsigned int Play(unsigned int clip, float fade_seconds = 0.0f, float speed = 1.0f, bool loop = true)
+	{
+		for (unsigned int i = 0; i < this->layers.size(); i++)
+			SetWeight(i, 0.0f, fade_seconds);
+		unsigned int layer = AddLayer(clip, fade_seconds > 0.0f ? 0.0f : 1.0f, speed, loop);
+		SetWeight(layer, 1.0f, fade_seconds);
+		RemoveFinishedLayers();
+		return (unsigned int)this->layers.size() - 1;
+	}
+
+	// Agrega una capa ms a la mezcla; devuelve su ndice (cambia cuando se eliminan capas desvanecidas)
+	unsigned int AddLayer(unsigned int clip, float weight, float speed = 1.0f, bool loop = true)
+	{
+		// Sin lugar se descarta la capa ms antigua
+		if (this->layers.size() == MAX_LAYERS)
+		{
+			this->layers.erase(this->layers.begin());
+			this->poses.erase(this->poses.begin());
+		}
+
+		ClipPlayback playback;
+		playback.clip = clip;
+		playback.speed = speed;
+		playback.loop = loop;
+		playback.weight = playback.target_weight = weight;
+		(*this->clips)[clip].ResetCache(playback.cache);
+		this->layers.push_back(playback);
+
+		this->poses.resize(this->layers.size());
+		for (unsigned int i = 0; i < this->poses.size(); i++)
+		{
+			if (this->poses[i].count != this->bindPose->count)
+				this->poses[i] = *this->bindPose;
+		}
+		this->changed = true;
+		return (unsigned int)this->layers.size() - 1;
+	}
+
+	// Peso de una capa, alcanzado linealmente en fade_seconds (0 = inmediato)
+	void SetWeight(unsigned int layer, float weight, float fade_seconds = 0.0f)
+	{
+		ClipPlayback& playback = this->layers[layer];
+		playback.target_weight = weight;
+		if (fade_seconds > 0.0f)
+		{
+			playback.fade_rate = std::fabs(weight - playback.weight) / fade_seconds;
+		}
+		else
+		{
+			playback.weight = weight;
+			playback.fade_rate = 0.0f;
+		}
+		this->changed = true;
+	}
+
+	void SetSpeed(unsigned int layer, float speed) { this->layers[layer].speed = speed; }
+	void SetLoop(unsigned int layer, bool loop) { this->layers[layer].loop = loop; }
+
+	void SetTime(unsigned int layer, float seconds)
+	{
+		ClipPlayback& playback = this->layers[layer];
+		playback.time = WrapTime(playback, seconds * (*this->clips)[playback.clip].ticks_per_second);
+		this->changed = true;
+	}
+
+	// Detiene (o reanuda) todas las capas sin perder su velocidad
+	void SetPaused(bool paused) { this->paused = paused; }
+	bool IsPaused() const { return this->paused; }
+
+	const std::vector<ClipPlayback>& Layers() const { return this->layers; }
+
+	// Avanza el tiempo de cada capa y los desvanecimientos; devuelve true si la pose puede haber cambiado
+	bool Advance(float delta_seconds)
+	{
+		if (this->paused || delta_seconds == 0.0f)
+			return this->changed;
+
+		for (unsigned int i = 0; i < this->layers.size(); i++)
+		{
+			ClipPlayback& playback = this->layers[i];
+			const AnimationClip& clip = (*this->clips)[playback.clip];
+			if (playback.speed != 0.0f)
+			{
+				playback.time = WrapTime(playback, playback.time + delta_seconds * playback.speed * clip.ticks_per_second);
+				this->changed = true;
+			}
+			if (playback.fade_rate > 0.0f)
+			{
+				float step = playback.fade_rate * std::fabs(delta_seconds);
+				if (std::fabs(playback.target_weight - playback.weight) <= step)
+				{
+					playback.weight = playback.target_weight;
+					playback.fade_rate = 0.0f;
+				}
+				else
+				{
+					playback.weight += playback.target_weight > playback.weight ? step : -step;
+				}
+				this->changed = true;
+			}
+		}
+		RemoveFinishedLayers();
+		return this->changed;
+	}
+
+	// Pose local mezclada de todas las capas. Sin capas con peso devuelve la pose de reposo. Con una sola
+	// capa la pose muestreada se usa tal cual, sin pasar por la mezcla
+	const LocalPose& Evaluate()
+	{
+		this->changed = false;
+
+		const LocalPose* active[MAX_LAYERS];
+		float weights[MAX_LAYERS];
+		unsigned int count = 0;
+		float total = 0.0f;
+		for (unsigned int i = 0; i < this->layers.size(); i++)
+		{
+			ClipPlayback& playback = this->layers[i];
+			if (playback.weight <= 0.0f)
+				continue;
+			(*this->clips)[playback.clip].SamplePose(playback.time, playback.cache, this->poses[i]);
+			active[count] = &this->poses[i];
+			weights[count] = playback.weight;
+			total += playback.weight;
+			count++;
+		}
+
+		if (count == 0)
+			return *this->bindPose;
+		if (count == 1)
+			return *active[0];
+
+		// La pose mezclada solo ocupa memoria en las instancias que alguna vez mezclan
+		if (this->blended.count != this->bindPose->count)
+			this->blended.Resize(this->bindPose->count);
+		for (unsigned int i = 0; i < count; i++)
+			weights[i] /= total;
+		blendPoses(active, weights, count, this->blended);
+		return this->blended;
+	}
+
+	// true si algn clip con peso anima el nodo; los dems nodos conservan su transformacin de reposo
+	bool Animates(unsigned int node) const
+	{
+		for (unsigned int i = 0; i < this->layers.size(); i++)
+		{
+			if (this->layers[i].weight > 0.0f && (*this->clips)[this->layers[i].clip].node_track[node] >= 0)
+				return true;
+		}
+		return false;
+	}
+
+	// Bytes del estado de reproduccin: capas, sus tramos de claves y poses muestreadas
+	size_t MemoryBytes() const
+	{
+		size_t bytes = sizeof(AnimationPlayer) + this->layers.capacity() * sizeof(ClipPlayback)
+			+ this->poses.capacity() * sizeof(LocalPose) + this->blended.data.capacity() * sizeof(float);
+		for (unsigned int i = 0; i < this->layers.size(); i++)
+		{
+			const SegmentCache& cache = this->layers[i].cache;
+			bytes += cache.data.capacity() * sizeof(float) + cache.cursors.capacity() * sizeof(KeyCursor)
+				+ this->poses[i].data.capacity() * sizeof(float);
+		}
+		return bytes;
+	}
+
+private:
+	const std::vector<AnimationClip>* clips;
+	const LocalPose* bindPose = NULL;
+	std::vector<ClipPlayback> layers;
+	std::vector<LocalPose> poses;     // pose muestreada de cada capa (los nodos sin pista quedan en reposo)
+	LocalPose blended;
+	bool paused;
+	bool changed = true;
+
+	float WrapTime(const ClipPlayback& playback, float time) const
+	{
+		float duration = (*this->clips)[playback.clip].duration;
+		if (duration <= 0.0f)
+			return 0.0f;
+		if (!playback.loop)
+			return std::min(std::max(time, 0.0f), duration);
+		time = std::fmod(time, duration);
+		return time < 0.0f ? time + duration : time;
+	}
+
+	// Quita las capas que terminaron de desvanecerse
+	void RemoveFinishedLayers()
+	{
+		for (unsigned int i = (unsigned int)this->layers.size(); i-- > 0;)
+		{
+			if (this->layers[i].weight <= 0.0f && this->layers[i].target_weight <= 0.0f && this->layers[i].fade_rate == 0.0f)
+			{
+				this->layers.erase(this->layers.begin() + i);
+				this->poses.erase(this->poses.begin() + i);
+			}
+		}
+	}
+};
@@ -0,0 +1,247 @@
+#pragma once
+
+// Std. Includes
+#include <vector>
+#include <cmath>
+
+#include <assimp/scene.h>
+
+// SIMD de 4 floats: SSE en x86/x64 (MSVC siempre lo tiene en x64 y con /arch:SSE2 en Win32) y NEON en AArch64.
+// En cualquier otra plataforma float4 es un arreglo y las mismas funciones recorren sus cuatro elementos
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define ANIMATION_SIMD_SSE
+#include <xmmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define ANIMATION_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+#if defined(ANIMATION_SIMD_SSE)
+typedef __m128 float4;
+inline float4 load4(const float* p) { return _mm_loadu_ps(p); }
+inline void store4(float* p, float4 v) { _mm_storeu_ps(p, v); }
+inline float4 splat4(float v) { return _mm_set1_ps(v); }
+inline float4 add4(float4 a, float4 b) { return _mm_add_ps(a, b); }
+inline float4 sub4(float4 a, float4 b) { return _mm_sub_ps(a, b); }
+inline float4 mul4(float4 a, float4 b) { return _mm_mul_ps(a, b); }
+inline float4 div4(float4 a, float4 b) { return _mm_div_ps(a, b); }
+inline float4 sqrt4(float4 a) { return _mm_sqrt_ps(a); }
+inline float4 madd4(float4 a, float4 b, float4 c) { return _mm_add_ps(_mm_mul_ps(a, b), c); } // a * b + c
+inline float4 min4(float4 a, float4 b) { return _mm_min_ps(a, b); }
+inline float4 max4(float4 a, float4 b) { return _mm_max_ps(a, b); }
+// a con el signo invertido en los elementos donde reference < 0
+inline float4 flipSign4(float4 a, float4 reference)
+{
+	__m128 negative = _mm_cmplt_ps(reference, _mm_setzero_ps());
+	return _mm_xor_ps(a, _mm_and_ps(negative, _mm_set1_ps(-0.0f)));
+}
+#elif defined(ANIMATION_SIMD_NEON)
+typedef float32x4_t float4;
+inline float4 load4(const float* p) { return vld1q_f32(p); }
+inline void store4(float* p, float4 v) { vst1q_f32(p, v); }
+inline float4 splat4(float v) { return vdupq_n_f32(v); }
+inline float4 add4(float4 a, float4 b) { return vaddq_f32(a, b); }
+inline float4 sub4(float4 a, float4 b) { return vsubq_f32(a, b); }
+inline float4 mul4(float4 a, float4 b) { return vmulq_f32(a, b); }
+inline float4 div4(float4 a, float4 b) { return vdivq_f32(a, b); }
+inline float4 sqrt4(float4 a) { return vsqrtq_f32(a); }
+inline float4 madd4(float4 a, float4 b, float4 c) { return vmlaq_f32(c, a, b); }
+inline float4 min4(float4 a, float4 b) { return vminq_f32(a, b); }
+inline float4 max4(float4 a, float4 b) { return vmaxq_f32(a, b); }
+inline float4 flipSign4(float4 a, float4 reference)
+{
+	uint32x4_t negative = vcltq_f32(reference, vdupq_n_f32(0.0f));
+	return vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(a), vandq_u32(negative, vdupq_n_u32(0x80000000u))));
+}
+#else
+struct float4 { float v[4]; };
+inline float4 load4(const float* p) { float4 r; for (int i = 0; i < 4; i++) r.v[i] = p[i]; return r; }
+inline void store4(float* p, float4 a) { for (int i = 0; i < 4; i++) p[i] = a.v[i]; }
+inline float4 splat4(float v) { float4 r; for (int i = 0; i < 4; i++) r.v[i] = v; return r; }
+inline float4 add4(float4 a, float4 b) { for (int i = 0; i < 4; i++) a.v[i] += b.v[i]; return a; }
+inline float4 sub4(float4 a, float4 b) { for (int i = 0; i < 4; i++) a.v[i] -= b.v[i]; return a; }
+inline float4 mul4(float4 a, float4 b) { for (int i = 0; i < 4; i++) a.v[i] *= b.v[i]; return a; }
+inline float4 div4(float4 a, float4 b) { for (int i = 0; i < 4; i++) a.v[i] /= b.v[i]; return a; }
+inline float4 sqrt4(float4 a) { for (int i = 0; i < 4; i++) a.v[i] = std::sqrt(a.v[i]); return a; }
+inline float4 madd4(float4 a, float4 b, float4 c) { for (int i = 0; i < 4; i++) a.v[i] = a.v[i] * b.v[i] + c.v[i]; return a; }
+inline float4 min4(float4 a, float4 b) { for (int i = 0; i < 4; i++) a.v[i] = a.v[i] < b.v[i] ? a.v[i] : b.v[i]; return a; }
+inline float4 max4(float4 a, float4 b) { for (int i = 0; i < 4; i++) a.v[i] = a.v[i] > b.v[i] ? a.v[i] : b.v[i]; return a; }
+inline float4 flipSign4(float4 a, float4 reference) { for (int i = 0; i < 4; i++) if (reference.v[i] < 0.0f) a.v[i] = -a.v[i]; return a; }
+#endif
+
+// Transformacin afn por filas: las tres primeras filas de un aiMatrix4x4 (la cuarta siempre es 0 0 0 1)
+struct AffineTransform
+{
+	float m[12];
+
+	AffineTransform()
+	{
+		for (int i = 0; i < 12; i++)
+			m[i] = (i % 5 == 0) ? 1.0f : 0.0f;
+	}
+
+	explicit AffineTransform(const aiMatrix4x4& matrix)
+	{
+		for (int i = 0; i < 12; i++)
+			m[i] = matrix[i / 4][i % 4];
+	}
+
+	void ToMatrix(aiMatrix4x4& matrix) const
+	{
+		for (int i = 0; i < 12; i++)
+			matrix[i / 4][i % 4] = m[i];
+		matrix.d1 = matrix.d2 = matrix.d3 = 0.0f;
+		matrix.d4 = 1.0f;
+	}
+};
+
+// out = a * b con las tres filas de cada una (12 floats). Cada fila del resultado es una combinacin de las
+// filas de b ms la traslacin de a; out puede ser las primeras filas de un aiMatrix4x4 (&matrix.a1)
+inline void multiplyAffine(const float* a, const float* b, float* out)
+{
+	float4 b0 = load4(b);
+	float4 b1 = load4(b + 4);
+	float4 b2 = load4(b + 8);
+	const float translation[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+	float4 b3 = load4(translation);
+	for (int row = 0; row < 3; row++)
+	{
+		const float* r = a + row * 4;
+		float4 result = mul4(splat4(r[0]), b0);
+		result = madd4(splat4(r[1]), b1, result);
+		result = madd4(splat4(r[2]), b2, result);
+		result = madd4(splat4(r[3]), b3, result);
+		store4(out + row * 4, result);
+	}
+}
+
+inline void multiplyAffine(const AffineTransform& a, const AffineTransform& b, AffineTransform& out)
+{
+	multiplyAffine(a.m, b.m, out.m);
+}
+
+// Pose local (traslacin, rotacin y escala) de todos los nodos del esqueleto aplanado en estructura de
+// arreglos: cada componente es un arreglo contiguo, con relleno hasta mltiplo de 4, para operar cuatro
+// nodos por instruccin
+struct LocalPose
+{
+	enum { TX, TY, TZ, RX, RY, RZ, RW, SX, SY, SZ, CHANNELS };
+
+	unsigned int count = 0;  // nodos
+	unsigned int stride = 0; // count redondeado a mltiplo de 4
+	std::vector<float> data; // CHANNELS arreglos de stride floats
+
+	void Resize(unsigned int nodes)
+	{
+		this->count = nodes;
+		this->stride = (nodes + 3) & ~3u;
+		// El relleno queda en identidad (rotacin w = 1, escala 1) para que nunca produzca NaN
+		this->data.assign(CHANNELS * this->stride, 0.0f);
+		for (unsigned int i = 0; i < this->stride; i++)
+		{
+			Channel(RW)[i] = 1.0f;
+			Channel(SX)[i] = Channel(SY)[i] = Channel(SZ)[i] = 1.0f;
+		}
+	}
+
+	float* Channel(unsigned int channel) { return &this->data[channel * this->stride]; }
+	const float* Channel(unsigned int channel) const { return &this->data[channel * this->stride]; }
+
+	void Set(unsigned int node, const aiVector3D& position, const aiQuaternion& rotation, const aiVector3D& scaling)
+	{
+		float* d = &this->data[node];
+		d[TX * stride] = position.x; d[TY * stride] = position.y; d[TZ * stride] = position.z;
+		d[RX * stride] = rotation.x; d[RY * stride] = rotation.y; d[RZ * stride] = rotation.z; d[RW * stride] = rotation.w;
+		d[SX * stride] = scaling.x; d[SY * stride] = scaling.y; d[SZ * stride] = scaling.z;
+	}
+};
+
+// out = suma de weights[k] * poses[k]. Las rotaciones se alinean al hemisferio de la primera pose antes de
+// sumarlas (q y -q son la misma rotacin) y se renormalizan al final; con pesos que suman 1 es un nlerp
+// de N vas. Los pesos deben sumar ms que 0
+inline void blendPoses(const LocalPose* const* poses, const float* weights, unsigned int count, LocalPose& out)
+{
+	const unsigned int stride = out.stride;
+	for (unsigned int node = 0; node < stride; node += 4)
+	{
+		float4 acc[LocalPose::CHANNELS];
+		float4 weight = splat4(weights[0]);
+		for (unsigned int c = 0; c < LocalPose::CHANNELS; c++)
+			acc[c] = mul4(weight, load4(poses[0]->Channel(c) + node));
+
+		float4 rx0 = load4(poses[0]->Channel(LocalPose::RX) + node);
+		float4 ry0 = load4(poses[0]->Channel(LocalPose::RY) + node);
+		float4 rz0 = load4(poses[0]->Channel(LocalPose::RZ) + node);
+		float4 rw0 = load4(poses[0]->Channel(LocalPose::RW) + node);
+		for (unsigned int k = 1; k < count; k++)
+		{
+			const LocalPose& pose = *poses[k];
+			weight = splat4(weights[k]);
+			for (unsigned int c = LocalPose::TX; c <= LocalPose::TZ; c++)
+				acc[c] = madd4(weight, load4(pose.Channel(c) + node), acc[c]);
+			for (unsigned int c = LocalPose::SX; c <= LocalPose::SZ; c++)
+				acc[c] = madd4(weight, load4(pose.Channel(c) + node), acc[c]);
+
+			float4 rx = load4(pose.Channel(LocalPose::RX) + node);
+			float4 ry = load4(pose.Channel(LocalPose::RY) + node);
+			float4 rz = load4(pose.Channel(LocalPose::RZ) + node);
+			float4 rw = load4(pose.Channel(LocalPose::RW) + node);
+			float4 dot = madd4(rx0, rx, madd4(ry0, ry, madd4(rz0, rz, mul4(rw0, rw))));
+			weight = flipSign4(weight, dot);
+			acc[LocalPose::RX] = madd4(weight, rx, acc[LocalPose::RX]);
+			acc[LocalPose::RY] = madd4(weight, ry, acc[LocalPose::RY]);
+			acc[LocalPose::RZ] = madd4(weight, rz, acc[LocalPose::RZ]);
+			acc[LocalPose::RW] = madd4(weight, rw, acc[LocalPose::RW]);
+		}
+
+		float4 length = sqrt4(madd4(acc[LocalPose::RX], acc[LocalPose::RX], madd4(acc[LocalPose::RY], acc[LocalPose::RY],
+			madd4(acc[LocalPose::RZ], acc[LocalPose::RZ], mul4(acc[LocalPose::RW], acc[LocalPose::RW])))));
+		for (unsigned int c = LocalPose::RX; c <= LocalPose::RW; c++)
+			acc[c] = div4(acc[c], length);
+		for (unsigned int c = 0; c < LocalPose::CHANNELS; c++)
+			store4(out.Channel(c) + node, acc[c]);
+	}
+}
+
+// Transformacin local de cada nodo: traslacin * rotacin * escala, como composeTransform en ModelAnim
+inline void composePose(const LocalPose& pose, std::vector<AffineTransform>& out)
+{
+	const float4 one = splat4(1.0f);
+	const float4 two = splat4(2.0f);
+	float rows[12][4];
+	for (unsigned int node = 0; node < pose.count; node += 4)
+	{
+		float4 x = load4(pose.Channel(LocalPose::RX) + node);
+		float4 y = load4(pose.Channel(LocalPose::RY) + node);
+		float4 z = load4(pose.Channel(LocalPose::RZ) + node);
+		float4 w = load4(pose.Channel(LocalPose::RW) + node);
+		float4 sx = load4(pose.Channel(LocalPose::SX) + node);
+		float4 sy = load4(pose.Channel(LocalPose::SY) + node);
+		float4 sz = load4(pose.Channel(LocalPose::SZ) + node);
+
+		// Misma frmula que aiQuaternion::GetMatrix; cada columna de la rotacin se multiplica por su escala
+		float4 xx = mul4(x, x), yy = mul4(y, y), zz = mul4(z, z);
+		float4 xy = mul4(x, y), xz = mul4(x, z), yz = mul4(y, z);
+		float4 xw = mul4(x, w), yw = mul4(y, w), zw = mul4(z, w);
+		store4(rows[0], mul4(sub4(one, mul4(two, add4(yy, zz))), sx));
+		store4(rows[1], mul4(mul4(two, sub4(xy, zw)), sy));
+		store4(rows[2], mul4(mul4(two, add4(xz, yw)), sz));
+		store4(rows[3], load4(pose.Channel(LocalPose::TX) + node));
+		store4(rows[4], mul4(mul4(two, add4(xy, zw)), sx));
+		store4(rows[5], mul4(sub4(one, mul4(two, add4(xx, zz))), sy));
+		store4(rows[6], mul4(mul4(two, sub4(yz, xw)), sz));
+		store4(rows[7], load4(pose.Channel(LocalPose::TY) + node));
+		store4(rows[8], mul4(mul4(two, sub4(xz, yw)), sx));
+		store4(rows[9], mul4(mul4(two, add4(yz, xw)), sy));
+		store4(rows[10], mul4(sub4(one, mul4(two, add4(xx, yy))), sz));
+		store4(rows[11], load4(pose.Channel(LocalPose::TZ) + node));
+
+		unsigned int lanes = pose.count - node < 4 ? pose.count - node : 4;
+		for (unsigned int lane = 0; lane < lanes; lane++)
+		{
+			float* m = out[node + lane].m;
+			for (unsigned int k = 0; k < 12; k++)
+				m[k] = rows[k][lane];
+		}
+	}
+}
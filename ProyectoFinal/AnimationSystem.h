@@ -0,0 +1,250 @@
+#pragma once
+
+// Std. Includes
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+
+// GL Includes
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "Shader.h"
+#include "AnimatedInstance.h"
+#include "AnimationPose.h"
+#include "Frustum.h"
+#include "JobPool.h"
+#include "Profiler.h"
+
+// Etapa de actualizacin de la animacin, antes de dibujar: todas las instancias registradas se avanzan y
+// evalan en paralelo en un JobPool, sin OpenGL. Despus Draw sube las paletas y dibuja en el hilo de render.
+// Cada instancia recibe un nivel de detalle segn su esfera (ModelAnim::m_bounds_*) contra la cmara:
+//  - LOD_FULL, LOD_HALF, LOD_QUARTER: visible, evaluada cada 1, 2 o 4 frames segn la distancia. Entre dos
+//    evaluaciones los huesos se interpolan desde la pose que se vea hacia la nueva.
+//  - LOD_OFFSCREEN: fuera del frustum pero cerca de la cmara (puede entrar en cualquier momento), cada 8 frames.
+//  - LOD_CULLED: fuera del frustum y lejos, o ms all de maxDistance. Solo avanza su tiempo; se evala
+//    de nuevo en cuanto vuelve a otro nivel.
+class AnimationSystem
+{
+public:
+	enum Lod { LOD_FULL, LOD_HALF, LOD_QUARTER, LOD_OFFSCREEN, LOD_CULLED, LOD_LEVELS };
+
+	// Lo que pas en el ltimo Update
+	struct Stats
+	{
+		unsigned int instances = 0;
+		unsigned int evaluated = 0;     // muestrearon sus clips y recorrieron el esqueleto
+		unsigned int interpolated = 0;  // nivel reducido: mezcla de la pose anterior y la ltima evaluada
+		unsigned int skipped = 0;       // sin trabajo: pose sin cambio, esperando su turno o descartadas
+		unsigned int levels[LOD_LEVELS] = {};
+		double updateMs = 0.0;
+	};
+
+	// Distancias (unidades de la escena) a partir de las que se baja a LOD_HALF y LOD_QUARTER
+	float halfRateDistance = 10.0f;
+	float quarterRateDistance = 30.0f;
+	float offscreenDistance = 15.0f;  // fuera del frustum: ms cerca que esto es LOD_OFFSCREEN, ms lejos LOD_CULLED
+	float maxDistance = 150.0f;
+	float boundsScale = 1.5f;         // margen de la esfera de reposo para las poses que se salen de ella
+	bool lodEnabled = true;           // false = todas a frecuencia completa (referencia para comparar)
+
+	// threads = hilos de la etapa contando el de render (0 = uno por ncleo)
+	AnimationSystem(unsigned int threads = 0) : pool(threads), frame(0)
+	{
+	}
+
+	// instance debe vivir mientras est registrada; devuelve el id para SetTransform
+	unsigned int Add(AnimatedInstance& instance, const glm::mat4& transform = glm::mat4(1.0f))
+	{
+		Entry entry;
+		entry.instance = &instance;
+		entry.transform = transform;
+		entry.phase = (unsigned int)this->entries.size();
+		this->entries.push_back(entry);
+		return (unsigned int)this->entries.size() - 1;
+	}
+
+	void SetTransform(unsigned int id, const glm::mat4& transform) { this->entries[id].transform = transform; }
+	Lod LevelOf(unsigned int id) const { return this->entries[id].lod; }
+	unsigned int Count() const { return (unsigned int)this->entries.size(); }
+	unsigned int Threads() const { return this->pool.Threads(); }
+	const Stats& LastStats() const { return this->stats; }
+
+	void Clear()
+	{
+		this->entries.clear();
+	}
+
+	// Clasifica, avanza y evala todas las instancias para timeInSec
+	void Update(double timeInSec, const glm::mat4& view, const glm::mat4& projection)
+	{
+		PROFILE_SCOPE("AnimationSystem::Update");
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		this->frame++;
+		this->frustum.Extract(projection * view);
+		this->eye = glm::vec3(glm::inverse(view)[3]);
+
+		this->pool.ParallelFor((unsigned int)this->entries.size(), 16, [this, timeInSec](unsigned int begin, unsigned int end)
+		{
+			PROFILE_SCOPE("AnimationSystem::UpdateChunk");
+			for (unsigned int i = begin; i < end; i++)
+				UpdateEntry(this->entries[i], timeInSec);
+		});
+
+		Stats result;
+		result.instances = (unsigned int)this->entries.size();
+		for (unsigned int i = 0; i < this->entries.size(); i++)
+		{
+			const Entry& entry = this->entries[i];
+			result.levels[entry.lod]++;
+			if (entry.work == WORK_EVALUATED)
+				result.evaluated++;
+			else if (entry.work == WORK_INTERPOLATED)
+				result.interpolated++;
+			else
+				result.skipped++;
+		}
+		result.updateMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		this->stats = result;
+	}
+
+	// Dibuja las instancias visibles del ltimo Update; modelLocation es el uniform model de shader
+	void Draw(Shader shader, GLint modelLocation)
+	{
+		shader.Use();
+		for (unsigned int i = 0; i < this->entries.size(); i++)
+		{
+			const Entry& entry = this->entries[i];
+			if (entry.lod > LOD_QUARTER)
+				continue;
+			RenderStats::UniformMatrix4fv(modelLocation, 1, GL_FALSE, glm::value_ptr(entry.transform));
+			entry.instance->Draw(shader);
+		}
+	}
+
+private:
+	enum Work { WORK_NONE, WORK_EVALUATED, WORK_INTERPOLATED };
+
+	struct Entry
+	{
+		AnimatedInstance* instance;
+		glm::mat4 transform;
+		Lod lod = LOD_FULL;
+		Work work = WORK_NONE;
+		unsigned int phase = 0;        // reparte las evaluaciones de los niveles reducidos entre frames
+		unsigned int step = 0;         // frames desde la ltima evaluacin
+		bool pending = true;           // la pose cambi desde la ltima evaluacin
+		bool history = false;          // los huesos de la instancia son de una evaluacin reciente
+		bool blending = false;         // interpolando de from a to
+		std::vector<AffineTransform> from, to;  // solo los usan los niveles reducidos
+	};
+
+	JobPool pool;
+	std::vector<Entry> entries;
+	unsigned int frame;
+	Frustum frustum;
+	glm::vec3 eye;
+	Stats stats;
+
+	Lod Classify(const Entry& entry) const
+	{
+		const ModelAnim& model = entry.instance->Asset();
+		glm::vec3 center = glm::vec3(entry.transform * glm::vec4(model.m_bounds_center, 1.0f));
+		float scale = std::max(glm::length(glm::vec3(entry.transform[0])), std::max(glm::length(glm::vec3(entry.transform[1])), glm::length(glm::vec3(entry.transform[2]))));
+		float radius = model.m_bounds_radius * scale * this->boundsScale;
+		float distance = std::max(glm::length(center - this->eye) - radius, 0.0f);
+		if (distance > this->maxDistance)
+			return LOD_CULLED;
+
+		if (!this->frustum.IntersectsSphere(center, radius))
+			return distance < this->offscreenDistance ? LOD_OFFSCREEN : LOD_CULLED;
+		if (!this->lodEnabled || distance < this->halfRateDistance)
+			return LOD_FULL;
+		return distance < this->quarterRateDistance ? LOD_HALF : LOD_QUARTER;
+	}
+
+	// Frames entre evaluaciones de cada nivel (LOD_CULLED no se evala)
+	static unsigned int Interval(Lod lod)
+	{
+		static const unsigned int intervals[LOD_LEVELS] = { 1, 2, 4, 8, 0 };
+		return intervals[lod];
+	}
+
+	// Corre en los hilos del pool: solo toca la entrada y su instancia
+	void UpdateEntry(Entry& entry, double timeInSec)
+	{
+		AnimatedInstance& instance = *entry.instance;
+		entry.pending = instance.Advance(timeInSec) || entry.pending;
+		entry.lod = this->lodEnabled ? Classify(entry) : LOD_FULL;
+		entry.work = WORK_NONE;
+		if (entry.lod == LOD_CULLED)
+		{
+			// Al volver a verse se evala de inmediato, sin interpolar desde una pose vieja
+			entry.history = false;
+			entry.blending = false;
+			return;
+		}
+
+		if (entry.lod == LOD_FULL)
+		{
+			if (entry.pending || !entry.history)
+			{
+				instance.Evaluate();
+				entry.work = WORK_EVALUATED;
+			}
+			entry.pending = false;
+			entry.history = true;
+			entry.blending = false;
+			entry.step = 0;
+			return;
+		}
+
+		// Le toca en los frames de su fase; si cambi de nivel y se desfas, a lo ms un intervalo despus
+		unsigned int interval = Interval(entry.lod);
+		entry.step++;
+		bool aligned = (this->frame + entry.phase) % interval == 0;
+		if (!entry.history || (entry.step >= interval && (aligned || entry.step >= 2 * interval)))
+		{
+			if (entry.pending || !entry.history)
+			{
+				std::vector<AffineTransform>& bones = instance.Bones();
+				if (entry.history)
+					entry.from = bones;
+				instance.Evaluate();
+				entry.to = bones;
+				entry.blending = entry.history;
+				entry.work = WORK_EVALUATED;
+			}
+			entry.pending = false;
+			entry.history = true;
+			entry.step = 0;
+		}
+		if (!entry.blending)
+			return;
+
+		// Pose mostrada = from + (to - from) * t fila por fila, desde la que se vea hasta la nueva en un
+		// intervalo. La matriz no queda ortonormal, pero dos evaluaciones seguidas difieren poco
+		float t = (entry.step + 1) / (float)interval;
+		if (entry.step + 1 >= interval)
+		{
+			t = 1.0f;
+			entry.blending = false;
+		}
+		std::vector<AffineTransform>& bones = instance.Bones();
+		const float4 factor = splat4(t);
+		for (unsigned int b = 0; b < bones.size(); b++)
+		{
+			for (unsigned int row = 0; row < 3; row++)
+			{
+				float4 a = load4(&entry.from[b].m[row * 4]);
+				float4 c = load4(&entry.to[b].m[row * 4]);
+				store4(&bones[b].m[row * 4], madd4(factor, sub4(c, a), a));
+			}
+		}
+		if (entry.work == WORK_NONE)
+			entry.work = WORK_INTERPOLATED;
+	}
+};
@@ -0,0 +1,162 @@
+#pragma once
+
+// Std. Includes
+#include <vector>
+#include <string>
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+// GL Includes
+#include <GL/glew.h>
+
+#include "modelAnim.h"
+#include "AnimationPlayer.h"
+#include "AnimationPose.h"
+
+// Clips de un ModelAnim horneados una sola vez en una textura de huesos (animacin en textura) para
+// multitudes de fondo (BakedCrowd): cada frame guarda las tres filas de cada hueso, evaluadas con el mismo
+// esqueleto que usa el reproductor, y Shaders/skinning.vs con BAKED las lee e interpola entre dos frames.
+// Se hornean matrices de huesos y no posiciones de vrtices: la textura depende de los huesos y frames, no
+// del tamao de la malla, y el stream de huesos empaquetado de la malla se reutiliza tal cual.
+// Textura RGBA32F: bones * 3 texels por frame; si no caben en una fila se acomodan varios frames por fila
+class BakedAnimation
+{
+public:
+	static const GLint TEXTURE_UNIT = 14; // junto a la de BonePalette, lejos de las de los materiales
+
+	// Frames de un clip dentro de la textura; el ltimo frame no repite el primero (el clip se cierra en el shader)
+	struct ClipRange
+	{
+		std::string name;
+		GLuint firstFrame;
+		GLuint frames;
+	};
+
+	GLuint texture;
+	GLuint numBones;
+	GLuint rowTexels;       // texels por frame
+	GLuint framesPerRow;
+	GLfloat framesPerSecond;
+	std::vector<ClipRange> clips;
+	std::vector<GLfloat> rows; // copia en la CPU: 12 floats por hueso y frame, en orden de frame
+
+	// Evala todos los clips de model a framesPerSecond y sube la textura
+	BakedAnimation(const ModelAnim& model, GLfloat framesPerSecond = 30.0f)
+		: texture(0), numBones(model.m_num_bones), rowTexels(model.m_num_bones * 3), framesPerRow(1), framesPerSecond(framesPerSecond),
+		textureBytes(0)
+	{
+		AnimationPlayer player;
+		player.Reset(&model.m_clips, model.m_bind_pose);
+		SkeletonState state;
+		model.initSkeletonState(state);
+		std::vector<AffineTransform> bones(this->numBones);
+
+		GLuint totalFrames = 0;
+		for (unsigned int c = 0; c < model.m_clips.size(); c++)
+		{
+			const AnimationClip& clip = model.m_clips[c];
+			float seconds = clip.duration / clip.ticks_per_second;
+			ClipRange range;
+			range.name = clip.name;
+			range.firstFrame = totalFrames;
+			range.frames = std::max((GLuint)std::lround(seconds * framesPerSecond), 1u);
+
+			player.Play(c);
+			for (GLuint f = 0; f < range.frames; f++)
+			{
+				player.SetTime(0, f / framesPerSecond);
+				if (this->numBones > 0)
+					model.evaluatePlayer(player, state, bones[0].m, 12);
+				for (GLuint b = 0; b < this->numBones; b++)
+					this->rows.insert(this->rows.end(), bones[b].m, bones[b].m + 12);
+			}
+			this->clips.push_back(range);
+			totalFrames += range.frames;
+		}
+		Upload(totalFrames);
+	}
+
+	~BakedAnimation()
+	{
+		RenderStats::TrackTextureMemory(-this->textureBytes);
+		glDeleteTextures(1, &this->texture);
+	}
+
+	// Rango del clip con ese nombre, o NULL si no existe
+	const ClipRange* FindClip(const std::string& name) const
+	{
+		for (unsigned int i = 0; i < this->clips.size(); i++)
+		{
+			if (this->clips[i].name == name)
+				return &this->clips[i];
+		}
+		return NULL;
+	}
+
+	// Liga la textura y asigna los uniforms de BAKED en program (ya activo)
+	void Bind(GLuint program) const
+	{
+		glActiveTexture(GL_TEXTURE0 + TEXTURE_UNIT);
+		RenderStats::BindTexture(GL_TEXTURE_2D, this->texture);
+		glActiveTexture(GL_TEXTURE0);
+		RenderStats::Uniform1i(glGetUniformLocation(program, "bakedBones"), TEXTURE_UNIT);
+		RenderStats::Uniform1i(glGetUniformLocation(program, "bakedRowTexels"), (GLint)this->rowTexels);
+		RenderStats::Uniform1i(glGetUniformLocation(program, "bakedFramesPerRow"), (GLint)this->framesPerRow);
+		RenderStats::Uniform1f(glGetUniformLocation(program, "bakedFramesPerSecond"), this->framesPerSecond);
+	}
+
+	// Lo mismo que calcula el shader para el hueso bone en seconds del clip: 12 floats en out
+	void SampleBone(const ClipRange& clip, float seconds, GLuint bone, GLfloat* out) const
+	{
+		float frame = seconds * this->framesPerSecond;
+		frame -= clip.frames * std::floor(frame / clip.frames);
+		GLuint local0 = std::min((GLuint)frame, clip.frames - 1);
+		GLuint local1 = (local0 + 1) % clip.frames;
+		float blend = frame - local0;
+		const GLfloat* a = &this->rows[((clip.firstFrame + local0) * this->numBones + bone) * 12];
+		const GLfloat* b = &this->rows[((clip.firstFrame + local1) * this->numBones + bone) * 12];
+		for (int i = 0; i < 12; i++)
+			out[i] = a[i] + (b[i] - a[i]) * blend;
+	}
+
+	size_t MemoryBytes() const
+	{
+		return this->rows.size() * sizeof(GLfloat);
+	}
+
+private:
+	GLint64 textureBytes;
+
+	BakedAnimation(const BakedAnimation&);
+	BakedAnimation& operator=(const BakedAnimation&);
+
+	void Upload(GLuint totalFrames)
+	{
+		GLint maxSize = 0;
+		glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+		GLuint rowTexels = std::max(this->rowTexels, 1u);
+		if (rowTexels > (GLuint)maxSize)
+		{
+			std::cout << "ERROR::ANIM:: " << this->numBones << " huesos no caben en una fila de textura de " << maxSize << " texels" << std::endl;
+			return;
+		}
+		this->framesPerRow = std::max(std::min((GLuint)maxSize / rowTexels, totalFrames), 1u);
+		GLuint width = this->framesPerRow * rowTexels;
+		GLuint height = (totalFrames + this->framesPerRow - 1) / this->framesPerRow;
+
+		// Los frames van seguidos en memoria; la ltima fila se completa con ceros
+		std::vector<GLfloat> pixels((size_t)width * std::max(height, 1u) * 4, 0.0f);
+		std::copy(this->rows.begin(), this->rows.end(), pixels.begin());
+
+		glGenTextures(1, &this->texture);
+		glBindTexture(GL_TEXTURE_2D, this->texture);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, width, std::max(height, 1u), 0, GL_RGBA, GL_FLOAT, &pixels[0]);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		this->textureBytes = (GLint64)pixels.size() * sizeof(GLfloat);
+		RenderStats::TrackTextureMemory(this->textureBytes);
+	}
+};
@@ -0,0 +1,135 @@
+#pragma once
+
+// Std. Includes
+#include <vector>
+#include <string>
+#include <cstddef>
+
+// GL Includes
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "Shader.h"
+#include "modelAnim.h"
+#include "BakedAnimation.h"
+
+// Multitud de fondo sobre una animacin horneada: cientos de personajes del mismo ModelAnim en un solo
+// glDrawElementsInstanced por malla, sin evaluar esqueletos en la CPU. Cada instancia solo guarda su matriz
+// de modelo y qu clip reproduce, con qu desfase y velocidad; el vertex shader (skinning.vs con BAKED)
+// calcula su frame con el uniform time. Para los personajes cercanos o que mezclan clips se sigue usando
+// AnimatedInstance. Los VAO instanciados son de las mallas: una sola BakedCrowd por modelo
+class BakedCrowd
+{
+public:
+	// Lo que lee el shader por instancia (ubicaciones 7 a 11)
+	struct Instance
+	{
+		glm::mat4 model;
+		glm::vec4 clip;  // primer frame, frames, desfase (s), velocidad
+	};
+
+	// model y baked deben vivir ms que la multitud; baked debe ser el horneado de model
+	BakedCrowd(ModelAnim& model, const BakedAnimation& baked) : model(&model), baked(&baked), buffer(0), capacity(0), dirty(false)
+	{
+		glGenBuffers(1, &this->buffer);
+		std::vector<GLuint> locations;
+		std::vector<size_t> offsets;
+		for (GLuint i = 0; i < 4; i++)
+		{
+			locations.push_back(7 + i);
+			offsets.push_back(offsetof(Instance, model) + i * sizeof(glm::vec4));
+		}
+		locations.push_back(11);
+		offsets.push_back(offsetof(Instance, clip));
+		for (unsigned int i = 0; i < model.meshes.size(); i++)
+			model.meshes[i].enableInstancing(this->buffer, sizeof(Instance), locations, offsets);
+	}
+
+	~BakedCrowd()
+	{
+		RenderStats::TrackBufferMemory(-(GLint64)MemoryBytes());
+		glDeleteBuffers(1, &this->buffer);
+	}
+
+	// Agrega un personaje con el clip de ese nombre; devuelve su id, o -1 si el clip no existe
+	int Add(const glm::mat4& transform, const std::string& clipName, float offsetSeconds = 0.0f, float speed = 1.0f)
+	{
+		const BakedAnimation::ClipRange* clip = this->baked->FindClip(clipName);
+		if (clip == NULL)
+		{
+			std::cout << "ERROR::ANIM:: no hay un clip horneado llamado '" << clipName << "'" << std::endl;
+			return -1;
+		}
+		Instance instance;
+		instance.model = transform;
+		instance.clip = glm::vec4((float)clip->firstFrame, (float)clip->frames, offsetSeconds, speed);
+		this->instances.push_back(instance);
+		this->dirty = true;
+		return (int)this->instances.size() - 1;
+	}
+
+	void SetTransform(unsigned int id, const glm::mat4& transform)
+	{
+		this->instances[id].model = transform;
+		this->dirty = true;
+	}
+
+	unsigned int Count() const { return (unsigned int)this->instances.size(); }
+
+	void Clear()
+	{
+		this->instances.clear();
+		this->dirty = true;
+	}
+
+	// Dibuja todos los personajes en timeInSec. shader es skinning.vs compilado con "#define BAKED\n", ya con
+	// view y projection asignados; los materiales de las mallas se ligan igual que en MeshAnim::Draw
+	void Draw(Shader shader, double timeInSec)
+	{
+		if (this->instances.empty())
+			return;
+		if (this->dirty)
+			Upload();
+
+		shader.Use();
+		this->baked->Bind(shader.Program);
+		RenderStats::Uniform1f(glGetUniformLocation(shader.Program, "time"), (GLfloat)timeInSec);
+		for (unsigned int i = 0; i < this->model->meshes.size(); i++)
+			this->model->meshes[i].DrawInstanced(shader, (GLsizei)this->instances.size());
+	}
+
+	// Bytes en la GPU del buffer de instancias (la textura es de BakedAnimation::MemoryBytes)
+	size_t MemoryBytes() const
+	{
+		return this->capacity * sizeof(Instance);
+	}
+
+private:
+	ModelAnim* model;
+	const BakedAnimation* baked;
+	std::vector<Instance> instances;
+	GLuint buffer;
+	size_t capacity;  // instancias que caben en buffer
+	bool dirty;       // instances cambi desde la ltima subida
+
+	BakedCrowd(const BakedCrowd&);
+	BakedCrowd& operator=(const BakedCrowd&);
+
+	// Las instancias solo cambian al agregarlas o moverlas, no cada frame
+	void Upload()
+	{
+		glBindBuffer(GL_ARRAY_BUFFER, this->buffer);
+		if (this->instances.size() > this->capacity)
+		{
+			RenderStats::TrackBufferMemory(-(GLint64)MemoryBytes());
+			this->capacity = this->instances.capacity();
+			RenderStats::TrackBufferMemory(MemoryBytes());
+			glBufferData(GL_ARRAY_BUFFER, this->capacity * sizeof(Instance), NULL, GL_STATIC_DRAW);
+		}
+		RenderStats::BufferSubData(GL_ARRAY_BUFFER, 0, this->instances.size() * sizeof(Instance), &this->instances[0]);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		this->dirty = false;
+	}
+};
@@ -0,0 +1,175 @@
+#pragma once
+
+// Std. Includes
+#include <vector>
+#include <cstring>
+
+// GL Includes
+#include <GL/glew.h>
+
+#include "meshAnim.h"
+#include "RenderStats.h"
+
+// Paleta de huesos de un esqueleto en un texture buffer (samplerBuffer bonePalette en Shaders/skinning.vs).
+// Cada hueso ocupa tres texels RGBA32F con las tres primeras filas de su matriz. El buffer tiene tres
+// segmentos que se usan por turnos, cada uno protegido por una fence, as la CPU nunca escribe el que la
+// GPU todava puede estar leyendo. Cada frame la paleta completa se copia con una sola pasada sobre
+// memoria mapeada: con ARB_buffer_storage el buffer queda mapeado de forma persistente; sin la extensin
+// (OpenGL 3.3) se mapea solo el segmento, sin sincronizar, porque la fence ya garantiza que est libre.
+class BonePalette
+{
+public:
+	static const GLuint SEGMENTS = 3;
+	static const GLint TEXTURE_UNIT = 15; // lejos de las unidades que usa MeshAnim::Draw para los materiales
+
+	// El buffer se crea en el primer Upload, cuando ya se sabe cuntos huesos tiene el esqueleto
+	BonePalette() : numBones(0), segmentBytes(0), current(0), buffer(0), mapped(NULL)
+	{
+		for (GLuint i = 0; i < SEGMENTS; i++)
+			this->fences[i] = 0;
+		glGenTextures(1, &this->texture);
+	}
+
+	~BonePalette()
+	{
+		Release();
+		glDeleteTextures(1, &this->texture);
+	}
+
+	// Copia las matrices finales de los huesos al siguiente segmento libre
+	void Upload(const std::vector<BoneMatrix>& bones)
+	{
+		// aiMatrix4x4 se guarda por filas: las tres primeras son los 12 primeros floats
+		Upload(bones.empty() ? NULL : &bones[0].final_world_transform.a1, (GLuint)bones.size(), sizeof(BoneMatrix) / sizeof(GLfloat));
+	}
+
+	// Igual, con las tres filas de cada hueso cada stride floats a partir de rows (AnimatedInstance usa 12)
+	void Upload(const GLfloat* rows, GLuint count, size_t stride)
+	{
+		if (count > this->numBones || this->buffer == 0)
+			Allocate(count > 0 ? count : 1);
+
+		GLuint segment = (this->current + 1) % SEGMENTS;
+		if (this->fences[segment])
+		{
+			glClientWaitSync(this->fences[segment], GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+			glDeleteSync(this->fences[segment]);
+			this->fences[segment] = 0;
+		}
+
+		GLfloat* target;
+		if (this->mapped)
+		{
+			target = (GLfloat*)(this->mapped + segment * this->segmentBytes);
+		}
+		else
+		{
+			glBindBuffer(GL_TEXTURE_BUFFER, this->buffer);
+			target = (GLfloat*)glMapBufferRange(GL_TEXTURE_BUFFER, segment * this->segmentBytes, this->segmentBytes,
+				GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+		}
+
+		if (stride == 12)
+		{
+			memcpy(target, rows, count * 12 * sizeof(GLfloat));
+		}
+		else
+		{
+			for (GLuint i = 0; i < count; i++)
+				memcpy(target + i * 12, rows + i * stride, 12 * sizeof(GLfloat));
+		}
+
+		RenderStats::CountBufferUpload(count * 12 * sizeof(GLfloat));
+
+		if (!this->mapped)
+		{
+			glUnmapBuffer(GL_TEXTURE_BUFFER);
+			glBindBuffer(GL_TEXTURE_BUFFER, 0);
+		}
+		this->current = segment;
+	}
+
+	// Deja el segmento actual en la unidad TEXTURE_UNIT; boneOffsetLocation es el uniform boneOffset del shader
+	void Bind(GLint boneOffsetLocation)
+	{
+		glActiveTexture(GL_TEXTURE0 + TEXTURE_UNIT);
+		RenderStats::BindTexture(GL_TEXTURE_BUFFER, this->texture);
+		glActiveTexture(GL_TEXTURE0);
+		RenderStats::Uniform1i(boneOffsetLocation, (GLint)(this->current * this->numBones * 3));
+	}
+
+	// Despus de los draws que leen el segmento actual: no se vuelve a escribir hasta que la GPU termine con l
+	void Fence()
+	{
+		if (this->fences[this->current])
+			glDeleteSync(this->fences[this->current]);
+		this->fences[this->current] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+
+	// Bytes en la GPU de la paleta de un esqueleto con ese nmero de huesos (los tres segmentos)
+	static size_t MemoryBytes(GLuint bones)
+	{
+		return SEGMENTS * bones * 3 * 4 * sizeof(GLfloat);
+	}
+
+private:
+	GLuint numBones;
+	GLuint segmentBytes;
+	GLuint current;
+	GLuint buffer;
+	GLuint texture;
+	GLubyte* mapped;
+	GLsync fences[SEGMENTS];
+
+	BonePalette(const BonePalette&);
+	BonePalette& operator=(const BonePalette&);
+
+	void Allocate(GLuint bones)
+	{
+		Release();
+		this->numBones = bones;
+		this->segmentBytes = bones * 3 * 4 * sizeof(GLfloat);
+
+		glGenBuffers(1, &this->buffer);
+		glBindBuffer(GL_TEXTURE_BUFFER, this->buffer);
+		if (GLEW_ARB_buffer_storage)
+		{
+			const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+			glBufferStorage(GL_TEXTURE_BUFFER, SEGMENTS * this->segmentBytes, NULL, flags);
+			this->mapped = (GLubyte*)glMapBufferRange(GL_TEXTURE_BUFFER, 0, SEGMENTS * this->segmentBytes, flags);
+		}
+		else
+		{
+			glBufferData(GL_TEXTURE_BUFFER, SEGMENTS * this->segmentBytes, NULL, GL_STREAM_DRAW);
+		}
+		glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+		glBindTexture(GL_TEXTURE_BUFFER, this->texture);
+		glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, this->buffer);
+		glBindTexture(GL_TEXTURE_BUFFER, 0);
+		RenderStats::TrackBufferMemory(SEGMENTS * this->segmentBytes);
+	}
+
+	void Release()
+	{
+		for (GLuint i = 0; i < SEGMENTS; i++)
+		{
+			if (this->fences[i])
+				glDeleteSync(this->fences[i]);
+			this->fences[i] = 0;
+		}
+		if (this->mapped)
+		{
+			glBindBuffer(GL_TEXTURE_BUFFER, this->buffer);
+			glUnmapBuffer(GL_TEXTURE_BUFFER);
+			glBindBuffer(GL_TEXTURE_BUFFER, 0);
+			this->mapped = NULL;
+		}
+		if (this->buffer)
+		{
+			glDeleteBuffers(1, &this->buffer);
+			RenderStats::TrackBufferMemory(-(GLint64)(SEGMENTS * this->segmentBytes));
+		}
+		this->buffer = 0;
+	}
+};
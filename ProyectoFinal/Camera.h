@@ -68,6 +68,15 @@ public:
 	}
 
 
+	// Places the camera at a given position and orientation (scripted camera paths, e.g. --flythrough)
+	void SetPose(glm::vec3 position, GLfloat yaw, GLfloat pitch)
+	{
+		this->position = position;
+		this->yaw = yaw;
+		this->pitch = pitch;
+		this->updateCameraVectors();
+	}
+
 	// Processes input received from any keyboard-like input system. Accepts input parameter in the form of camera defined ENUM (to abstract it from windowing systems)
 	void ProcessKeyboard(Camera_Movement direction, GLfloat deltaTime)
 	{
@@ -0,0 +1,121 @@
+#pragma once
+
+// Std. Includes
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cmath>
+
+#include <glm/glm.hpp>
+
+// Recorrido de cmara para --flythrough: cuadros clave (tiempo, posicin, yaw y pitch) ledos de un archivo
+// de texto, una lnea por cuadro y '#' para comentarios:
+//   # tiempo(s)  x     y     z      yaw   pitch
+//   0.0         10.0  3.0   0.0    180   -10
+//   4.0          4.0  1.7   0.0    180    0
+// Entre cuadros se interpola con Catmull-Rom (pasa por todos los cuadros sin esquinas); el yaw se
+// desenrolla al cargar para que de 170 a -170 gire 20 grados y no 340
+class CameraPath
+{
+public:
+	struct Key
+	{
+		float time;
+		glm::vec3 position;
+		float yaw;
+		float pitch;
+	};
+
+	// false si no se pudo leer o tiene menos de dos cuadros
+	bool Load(const std::string& path)
+	{
+		this->keys.clear();
+		std::ifstream file(path.c_str());
+		if (!file)
+		{
+			std::cout << "ERROR::FLYTHROUGH:: no se pudo abrir " << path << std::endl;
+			return false;
+		}
+
+		std::string line;
+		unsigned int number = 0;
+		while (std::getline(file, line))
+		{
+			number++;
+			size_t comment = line.find('#');
+			if (comment != std::string::npos)
+				line.erase(comment);
+			std::istringstream fields(line);
+			Key key;
+			if (!(fields >> key.time))
+				continue;
+			if (!(fields >> key.position.x >> key.position.y >> key.position.z >> key.yaw >> key.pitch))
+			{
+				std::cout << "ERROR::FLYTHROUGH:: " << path << ":" << number << ": se esperaba tiempo x y z yaw pitch" << std::endl;
+				return false;
+			}
+			if (!this->keys.empty())
+			{
+				if (key.time <= this->keys.back().time)
+				{
+					std::cout << "ERROR::FLYTHROUGH:: " << path << ":" << number << ": los tiempos deben ir en aumento" << std::endl;
+					return false;
+				}
+				key.yaw += 360.0f * std::round((this->keys.back().yaw - key.yaw) / 360.0f);
+			}
+			this->keys.push_back(key);
+		}
+		if (this->keys.size() < 2)
+		{
+			std::cout << "ERROR::FLYTHROUGH:: " << path << " necesita al menos dos cuadros" << std::endl;
+			return false;
+		}
+		return true;
+	}
+
+	// Segundos del primer al ltimo cuadro
+	float Duration() const
+	{
+		return this->keys.empty() ? 0.0f : this->keys.back().time - this->keys.front().time;
+	}
+
+	// Pose en seconds desde el primer cuadro (se detiene en los extremos)
+	Key Sample(float seconds) const
+	{
+		float time = this->keys.front().time + seconds;
+		if (time <= this->keys.front().time)
+			return this->keys.front();
+		if (time >= this->keys.back().time)
+			return this->keys.back();
+
+		unsigned int i = 0;
+		while (this->keys[i + 1].time <= time)
+			i++;
+		const Key& k0 = this->keys[i > 0 ? i - 1 : i];
+		const Key& k1 = this->keys[i];
+		const Key& k2 = this->keys[i + 1];
+		const Key& k3 = this->keys[i + 2 < this->keys.size() ? i + 2 : i + 1];
+		float u = (time - k1.time) / (k2.time - k1.time);
+
+		Key key;
+		key.time = time;
+		key.position = CatmullRom(k0.position, k1.position, k2.position, k3.position, u);
+		key.yaw = CatmullRom(glm::vec3(k0.yaw), glm::vec3(k1.yaw), glm::vec3(k2.yaw), glm::vec3(k3.yaw), u).x;
+		key.pitch = glm::clamp(CatmullRom(glm::vec3(k0.pitch), glm::vec3(k1.pitch), glm::vec3(k2.pitch), glm::vec3(k3.pitch), u).x, -89.0f, 89.0f);
+		return key;
+	}
+
+	const std::vector<Key>& Keys() const { return this->keys; }
+
+private:
+	std::vector<Key> keys;
+
+	static glm::vec3 CatmullRom(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2, const glm::vec3& p3, float u)
+	{
+		float u2 = u * u;
+		float u3 = u2 * u;
+		return 0.5f * (2.0f * p1 + (p2 - p0) * u + (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * u2 + (3.0f * p1 - p0 - 3.0f * p2 + p3) * u3);
+	}
+};
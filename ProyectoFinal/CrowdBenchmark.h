@@ -0,0 +1,366 @@
+#pragma once
+
+// Std. Includes
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cmath>
+
+// GL Includes
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "Shader.h"
+#include "modelAnim.h"
+#include "AnimatedInstance.h"
+#include "AnimationSystem.h"
+#include "BakedAnimation.h"
+#include "BakedCrowd.h"
+#include "Framebuffer.h"
+
+// Multitud de personajes animados con el mismo modelo: cargar una copia completa (ModelAnim) por personaje
+// contra un solo ModelAnim compartido por AnimatedInstance. Reporta tiempo de creacin y memoria por
+// personaje, y el costo por frame de actualizar y dibujar 1 a 1000 instancias desfasadas en el tiempo.
+// Despus mide la etapa de actualizacin (AnimationSystem) con una cuadrcula de instancias vista desde
+// un extremo: en serie, en paralelo y en paralelo con niveles de detalle y descarte. Al final compara la
+// multitud horneada (BakedCrowd, un draw instanciado por malla) contra AnimatedInstance por densidad.
+// Como en AnimationBenchmark los tringulos se descartan despus del vertex shader: se mide la animacin
+// y el skinning de cada instancia, no la cobertura de pantalla
+class CrowdBenchmark
+{
+public:
+	CrowdBenchmark(unsigned int copies = 8, GLuint frames = 60) : copies(copies), frames(frames)
+	{
+	}
+
+	void Run(const std::string& path)
+	{
+		// Copias completas: cada personaje vuelve a leer el archivo, subir las mallas y cargar las texturas
+		std::vector<ModelAnim*> models;
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (unsigned int i = 0; i < this->copies; i++)
+			models.push_back(new ModelAnim(path));
+		std::chrono::duration<double, std::milli> loadTime = std::chrono::steady_clock::now() - start;
+
+		ModelAnim& shared = *models[0];
+		if (shared.m_clips.empty())
+		{
+			std::cout << "CrowdBenchmark: el modelo no tiene esqueleto animado" << std::endl;
+			ReleaseModels(models);
+			return;
+		}
+		size_t modelBytes = shared.MemoryBytes();
+
+		// Instancias: el modelo ya cargado ms el estado propio de cada personaje
+		std::vector<AnimatedInstance*> instances;
+		start = std::chrono::steady_clock::now();
+		for (unsigned int i = 0; i < this->copies; i++)
+			instances.push_back(new AnimatedInstance(shared));
+		std::chrono::duration<double, std::milli> instanceTime = std::chrono::steady_clock::now() - start;
+		size_t instanceBytes = instances[0]->MemoryBytes();
+		size_t paletteBytes = instances[0]->PaletteBytes();
+		ReleaseInstances(instances);
+
+		std::cout << std::endl << "Crowd benchmark (" << shared.m_num_bones << " huesos, " << shared.m_clips.size() << " clips, "
+			<< this->copies << " personajes, " << this->frames << " frames)" << std::endl;
+		std::cout << std::left << std::setw(14) << "creacion" << std::setw(12) << "copias"
+			<< std::right << std::fixed << std::setprecision(3) << std::setw(10) << loadTime.count() / this->copies << " ms c/u"
+			<< std::setw(12) << modelBytes / 1024.0 << " KB c/u" << std::endl;
+		std::cout << std::left << std::setw(14) << "creacion" << std::setw(12) << "instancias"
+			<< std::right << std::setw(10) << instanceTime.count() / this->copies << " ms c/u"
+			<< std::setw(12) << (instanceBytes + paletteBytes) / 1024.0 << " KB c/u (" << instanceBytes / 1024.0 << " KB + paleta "
+			<< paletteBytes / 1024.0 << " KB) " << std::setprecision(2) << (double)modelBytes / (instanceBytes + paletteBytes)
+			<< "x menos memoria" << std::endl;
+
+		// Desde aqu solo se usa el modelo compartido
+		for (unsigned int i = 1; i < models.size(); i++)
+			delete models[i];
+		models.resize(1);
+
+		Shader shader("Shaders/skinning.vs", "Shaders/depth.frag");
+		shared.initShaders(shader.Program);
+		glm::mat4 view = glm::lookAt(glm::vec3(16.0f, 20.0f, -10.0f), glm::vec3(16.0f, 0.0f, 16.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+		SetCameraUniforms(shader.Program, view, glm::perspective(glm::radians(45.0f), 1.0f, 0.1f, 100.0f));
+		GLint modelLoc = glGetUniformLocation(shader.Program, "model");
+
+		Framebuffer target(64, 64);
+		target.Bind();
+		glEnable(GL_CULL_FACE);
+		glCullFace(GL_FRONT_AND_BACK);
+
+		std::cout << std::left << std::setw(14) << "instancias" << std::right << std::setw(12) << "update ms"
+			<< std::setw(12) << "wall ms" << std::setw(14) << "us/instancia" << std::setw(12) << "total KB" << std::endl;
+		const unsigned int counts[] = { 1, 10, 100, 1000 };
+		for (unsigned int c = 0; c < 4; c++)
+		{
+			std::mt19937 random(counts[c]);
+			std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+			for (unsigned int i = 0; i < counts[c]; i++)
+			{
+				AnimatedInstance* instance = new AnimatedInstance(shared);
+				// Cada personaje con otro clip, otro instante y otra velocidad
+				AnimationPlayer& player = instance->Player();
+				unsigned int clip = i % shared.m_clips.size();
+				player.Play(clip, 0.0f, 0.8f + 0.4f * unit(random));
+				player.SetTime(0, unit(random) * shared.m_clips[clip].duration / shared.m_clips[clip].ticks_per_second);
+				instances.push_back(instance);
+			}
+			size_t totalBytes = modelBytes;
+			for (unsigned int i = 0; i < instances.size(); i++)
+				totalBytes += instances[i]->MemoryBytes() + instances[i]->PaletteBytes();
+
+			std::chrono::duration<double, std::milli> update(0.0);
+			glFinish();
+			start = std::chrono::steady_clock::now();
+			for (GLuint frame = 1; frame <= this->frames; frame++)
+			{
+				std::chrono::steady_clock::time_point updateStart = std::chrono::steady_clock::now();
+				for (unsigned int i = 0; i < instances.size(); i++)
+					instances[i]->Update(frame / 60.0);
+				update += std::chrono::steady_clock::now() - updateStart;
+
+				glClear(GL_DEPTH_BUFFER_BIT);
+				shader.Use();
+				for (unsigned int i = 0; i < instances.size(); i++)
+				{
+					glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3((GLfloat)(i % 32), 0.0f, (GLfloat)(i / 32)));
+					glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
+					instances[i]->Draw(shader);
+				}
+			}
+			glFinish();
+			std::chrono::duration<double, std::milli> wall = std::chrono::steady_clock::now() - start;
+
+			std::cout << std::left << std::setw(14) << counts[c] << std::right << std::setprecision(3)
+				<< std::setw(12) << update.count() / this->frames << std::setw(12) << wall.count() / this->frames
+				<< std::setw(14) << 1000.0 * update.count() / this->frames / counts[c] << std::setw(12) << totalBytes / 1024.0 << std::endl;
+			ReleaseInstances(instances);
+		}
+		RunSystem(shared, shader, modelLoc);
+		RunBaked(shared, shader, modelLoc, view);
+		std::cout << std::endl;
+
+		glCullFace(GL_BACK);
+		glDisable(GL_CULL_FACE);
+		Framebuffer::Unbind();
+		glUseProgram(0);
+		ReleaseModels(models);
+	}
+
+private:
+	unsigned int copies;
+	GLuint frames;
+
+	// 500 instancias en una cuadrcula de 25 x 20 separadas por dos veces su radio; la cmara est frente
+	// a la primera fila mirando hacia el fondo, as hay instancias cerca, lejos y fuera del frustum
+	void RunSystem(ModelAnim& shared, Shader& shader, GLint modelLoc)
+	{
+		const unsigned int columns = 25, rows = 20;
+		float spacing = std::max(2.0f * shared.m_bounds_radius, 1e-3f);
+		glm::mat4 view = glm::lookAt(glm::vec3(0.0f, spacing, -4.0f * spacing), glm::vec3(0.0f, 0.0f, 10.0f * spacing), glm::vec3(0.0f, 1.0f, 0.0f));
+		glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f * spacing, 100.0f * spacing);
+		SetCameraUniforms(shader.Program, view, projection);
+
+		std::vector<AnimatedInstance*> instances;
+		std::mt19937 random(7);
+		std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+		for (unsigned int i = 0; i < columns * rows; i++)
+		{
+			AnimatedInstance* instance = new AnimatedInstance(shared);
+			unsigned int clip = i % shared.m_clips.size();
+			instance->Player().Play(clip, 0.0f, 0.8f + 0.4f * unit(random));
+			instance->Player().SetTime(0, unit(random) * shared.m_clips[clip].duration / shared.m_clips[clip].ticks_per_second);
+			instances.push_back(instance);
+		}
+
+		std::cout << std::left << std::setw(14) << "etapa" << std::setw(12) << "hilos" << std::right << std::setw(12) << "update ms"
+			<< std::setw(12) << "wall ms" << std::setw(10) << "evaluadas" << std::setw(14) << "interpoladas" << std::setw(10) << "omitidas"
+			<< "  (por frame, " << columns * rows << " instancias)" << std::endl;
+		const char* names[] = { "serie", "paralelo", "LOD" };
+		for (unsigned int mode = 0; mode < 3; mode++)
+		{
+			AnimationSystem system(mode == 0 ? 1 : 0);
+			system.lodEnabled = mode == 2;
+			system.halfRateDistance = 6.0f * spacing;
+			system.quarterRateDistance = 14.0f * spacing;
+			system.offscreenDistance = 3.0f * spacing;
+			system.maxDistance = 40.0f * spacing;
+			for (unsigned int i = 0; i < instances.size(); i++)
+			{
+				glm::vec3 position((i % columns - columns / 2.0f) * spacing, 0.0f, (i / columns) * spacing);
+				system.Add(*instances[i], glm::translate(glm::mat4(1.0f), position));
+			}
+
+			double update = 0.0;
+			double evaluated = 0.0, interpolated = 0.0, skipped = 0.0;
+			glFinish();
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			for (GLuint frame = 1; frame <= this->frames; frame++)
+			{
+				glClear(GL_DEPTH_BUFFER_BIT);
+				system.Update(frame / 60.0, view, projection);
+				system.Draw(shader, modelLoc);
+
+				const AnimationSystem::Stats& stats = system.LastStats();
+				update += stats.updateMs;
+				evaluated += stats.evaluated;
+				interpolated += stats.interpolated;
+				skipped += stats.skipped;
+			}
+			glFinish();
+			std::chrono::duration<double, std::milli> wall = std::chrono::steady_clock::now() - start;
+
+			std::cout << std::left << std::setw(14) << names[mode] << std::setw(12) << system.Threads() << std::right << std::setprecision(3)
+				<< std::setw(12) << update / this->frames << std::setw(12) << wall.count() / this->frames << std::setprecision(1)
+				<< std::setw(10) << evaluated / this->frames << std::setw(14) << interpolated / this->frames << std::setw(10) << skipped / this->frames;
+			if (mode == 2)
+			{
+				const AnimationSystem::Stats& stats = system.LastStats();
+				std::cout << "  (niveles: " << stats.levels[AnimationSystem::LOD_FULL] << " completas, " << stats.levels[AnimationSystem::LOD_HALF]
+					<< " 1/2, " << stats.levels[AnimationSystem::LOD_QUARTER] << " 1/4, " << stats.levels[AnimationSystem::LOD_OFFSCREEN]
+					<< " fuera de vista, " << stats.levels[AnimationSystem::LOD_CULLED] << " descartadas)";
+			}
+			std::cout << std::endl;
+		}
+		ReleaseInstances(instances);
+	}
+
+	// Mismos personajes (clip, desfase y velocidad) con evaluacin completa por instancia y con la animacin
+	// horneada; el cruce es la densidad a partir de la que el draw instanciado siempre gana en tiempo total
+	void RunBaked(ModelAnim& shared, Shader& shader, GLint modelLoc, const glm::mat4& view)
+	{
+		glm::mat4 projection = glm::perspective(glm::radians(45.0f), 1.0f, 0.1f, 100.0f);
+		SetCameraUniforms(shader.Program, view, projection);
+		Shader bakedShader("Shaders/skinning.vs", "Shaders/depth.frag", "#define BAKED\n");
+		SetCameraUniforms(bakedShader.Program, view, projection);
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		BakedAnimation baked(shared);
+		std::chrono::duration<double, std::milli> bakeTime = std::chrono::steady_clock::now() - start;
+		GLuint totalFrames = baked.clips.back().firstFrame + baked.clips.back().frames;
+
+		// Error del horneado: huesos interpolados entre frames contra el esqueleto evaluado en el mismo instante
+		float maxError = 0.0f;
+		AnimatedInstance probe(shared);
+		std::mt19937 random(11);
+		std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+		for (unsigned int sample = 0; sample < 64; sample++)
+		{
+			unsigned int clip = sample % shared.m_clips.size();
+			float seconds = unit(random) * shared.m_clips[clip].duration / shared.m_clips[clip].ticks_per_second;
+			probe.Player().Play(clip);
+			probe.Player().SetTime(0, seconds);
+			probe.Evaluate();
+			for (GLuint b = 0; b < shared.m_num_bones; b++)
+			{
+				GLfloat row[12];
+				baked.SampleBone(baked.clips[clip], seconds, b, row);
+				for (int k = 0; k < 12; k++)
+					maxError = std::max(maxError, std::abs(row[k] - probe.Bones()[b].m[k]));
+			}
+		}
+
+		std::cout << std::left << std::setw(14) << "horneado" << std::right << std::setprecision(3) << std::setw(12) << bakeTime.count() << " ms"
+			<< std::setw(12) << baked.MemoryBytes() / 1024.0 << " KB  (" << totalFrames << " frames a " << std::setprecision(0)
+			<< baked.framesPerSecond << " fps, error max " << std::scientific << std::setprecision(2) << maxError << ")" << std::fixed << std::endl;
+		std::cout << std::left << std::setw(14) << "densidad" << std::right << std::setw(12) << "completa ms" << std::setw(12) << "cpu ms"
+			<< std::setw(12) << "horneada ms" << std::setw(12) << "cpu ms" << std::setw(16) << "draws c/h" << std::endl;
+
+		const unsigned int counts[] = { 1, 10, 50, 100, 250, 500, 1000 };
+		unsigned int crossover = 0;
+		for (unsigned int c = 0; c < 7; c++)
+		{
+			std::vector<AnimatedInstance*> instances;
+			BakedCrowd crowd(shared, baked);
+			std::mt19937 placement(counts[c]);
+			for (unsigned int i = 0; i < counts[c]; i++)
+			{
+				unsigned int clip = i % shared.m_clips.size();
+				float speed = 0.8f + 0.4f * unit(placement);
+				float offset = unit(placement) * shared.m_clips[clip].duration / shared.m_clips[clip].ticks_per_second;
+				AnimatedInstance* instance = new AnimatedInstance(shared);
+				instance->Player().Play(clip, 0.0f, speed);
+				instance->Player().SetTime(0, offset);
+				instances.push_back(instance);
+				crowd.Add(glm::translate(glm::mat4(1.0f), glm::vec3((GLfloat)(i % 32), 0.0f, (GLfloat)(i / 32))), shared.m_clips[clip].name, offset, speed);
+			}
+
+			double wall[2], cpu[2];
+			for (unsigned int mode = 0; mode < 2; mode++)
+			{
+				std::chrono::duration<double, std::milli> submit(0.0);
+				glFinish();
+				start = std::chrono::steady_clock::now();
+				for (GLuint frame = 1; frame <= this->frames; frame++)
+				{
+					glClear(GL_DEPTH_BUFFER_BIT);
+					std::chrono::steady_clock::time_point cpuStart = std::chrono::steady_clock::now();
+					if (mode == 0)
+					{
+						shader.Use();
+						for (unsigned int i = 0; i < instances.size(); i++)
+						{
+							instances[i]->Update(frame / 60.0);
+							glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3((GLfloat)(i % 32), 0.0f, (GLfloat)(i / 32)));
+							glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
+							instances[i]->Draw(shader);
+						}
+					}
+					else
+						crowd.Draw(bakedShader, frame / 60.0);
+					submit += std::chrono::steady_clock::now() - cpuStart;
+				}
+				glFinish();
+				wall[mode] = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / this->frames;
+				cpu[mode] = submit.count() / this->frames;
+			}
+			// Cruce estable: gana aqu y en todas las densidades mayores
+			if (wall[1] < wall[0])
+			{
+				if (crossover == 0)
+					crossover = counts[c];
+			}
+			else
+				crossover = 0;
+
+			std::cout << std::left << std::setw(14) << counts[c] << std::right << std::setprecision(3)
+				<< std::setw(12) << wall[0] << std::setw(12) << cpu[0] << std::setw(12) << wall[1] << std::setw(12) << cpu[1]
+				<< std::setw(10) << counts[c] * shared.meshes.size() << " / " << shared.meshes.size() << std::endl;
+			ReleaseInstances(instances);
+		}
+		if (crossover > 0)
+			std::cout << "la animacion horneada gana desde " << crossover << " instancias" << std::endl;
+		else
+			std::cout << "la animacion horneada no gano en ninguna densidad" << std::endl;
+	}
+
+	static void SetCameraUniforms(GLuint program, const glm::mat4& view, const glm::mat4& projection)
+	{
+		glm::mat3 normalMatrix(1.0f);
+		glUseProgram(program);
+		glUniformMatrix4fv(glGetUniformLocation(program, "view"), 1, GL_FALSE, glm::value_ptr(view));
+		glUniformMatrix4fv(glGetUniformLocation(program, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+		glUniformMatrix3fv(glGetUniformLocation(program, "normalMatrix"), 1, GL_FALSE, glm::value_ptr(normalMatrix));
+	}
+
+	static void ReleaseInstances(std::vector<AnimatedInstance*>& instances)
+	{
+		for (unsigned int i = 0; i < instances.size(); i++)
+			delete instances[i];
+		instances.clear();
+	}
+
+	static void ReleaseModels(std::vector<ModelAnim*>& models)
+	{
+		for (unsigned int i = 0; i < models.size(); i++)
+			delete models[i];
+		models.clear();
+	}
+};
@@ -0,0 +1,194 @@
+#pragma once
+
+// Std. Includes
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+
+// GL Includes
+#include <GL/glew.h>
+
+#include "Camera.h"
+#include "CameraPath.h"
+#include "RenderStats.h"
+#include "Percentile.h"
+
+// Recorrido de cmara repetible sobre la escena completa (--flythrough <ruta>): el bucle principal dibuja
+// con pasos de tiempo fijos y la cmara sigue un CameraPath, as dos corridas ven exactamente lo mismo y
+// se pueden comparar entre commits. Por frame guarda:
+//  - cpu ms: de BeginFrame a EndFrame, lo que tarda el hilo de render en enviar el frame
+//  - gpu ms: GL_TIME_ELAPSED del mismo tramo; las consultas rotan y se leen varios frames despus
+//  - wall ms: entre el inicio de un frame y el del siguiente (incluye el intercambio de buffers)
+//  - los contadores de RenderStats del frame (draws, tringulos, uniforms, ...), solo en el CSV
+// Al final imprime min/media/p50/p95/p99/max y escribe un CSV con todos los frames
+class FlythroughBenchmark
+{
+public:
+	FlythroughBenchmark(GLuint warmupFrames = 10, double frameSeconds = 1.0 / 60.0)
+		: warmupFrames(warmupFrames), frameSeconds(frameSeconds), frame(0), active(false), open(false)
+	{
+		for (int i = 0; i < QUERIES; i++)
+			this->queries[i] = 0;
+	}
+
+	~FlythroughBenchmark()
+	{
+		if (this->queries[0] != 0)
+			glDeleteQueries(QUERIES, this->queries);
+	}
+
+	bool Load(const std::string& path)
+	{
+		this->name = path;
+		this->active = this->path.Load(path);
+		return this->active;
+	}
+
+	bool Active() const { return this->active; }
+
+	// El siguiente frame ya caera despus del ltimo cuadro del recorrido
+	bool Finished() const
+	{
+		return this->frame >= this->warmupFrames && (this->frame - this->warmupFrames) * this->frameSeconds > this->path.Duration() + 1e-6;
+	}
+
+	// Al inicio de cada frame: coloca la cmara y empieza a medir. Los primeros warmupFrames se quedan en
+	// el primer cuadro y no cuentan (compilacin de shaders, subidas de texturas, cachs fras)
+	void BeginFrame(Camera& camera)
+	{
+		if (this->queries[0] == 0)
+			glGenQueries(QUERIES, this->queries);
+
+		std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		if (this->open && Recording())
+			this->samples.back().wallMs = std::chrono::duration<double, std::milli>(now - this->frameStart).count();
+		this->frame++;
+		this->frameStart = now;
+		this->open = true;
+
+		CameraPath::Key key = this->path.Sample((float)PathSeconds());
+		camera.SetPose(key.position, key.yaw, key.pitch);
+
+		if (Recording())
+		{
+			Sample sample;
+			sample.seconds = PathSeconds();
+			this->samples.push_back(sample);
+			glBeginQuery(GL_TIME_ELAPSED, this->queries[(this->samples.size() - 1) % QUERIES]);
+		}
+	}
+
+	// Despus de enviar el frame y antes de intercambiar buffers
+	void EndFrame()
+	{
+		if (!Recording())
+			return;
+		glEndQuery(GL_TIME_ELAPSED);
+		Sample& sample = this->samples.back();
+		sample.cpuMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - this->frameStart).count();
+		sample.stats = RenderStats::Current();
+
+		// La consulta ms vieja ya debera estar lista; si no, esperarla solo detiene este frame
+		if (this->samples.size() >= QUERIES)
+			ReadQuery(this->samples.size() - QUERIES);
+	}
+
+	// Termina las mediciones pendientes, imprime el resumen y escribe el CSV (si csvPath no est vaco)
+	void Report(const std::string& csvPath, GLsizei width, GLsizei height)
+	{
+		glFinish();
+		if (this->open && Recording() && !this->samples.empty())
+			this->samples.back().wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - this->frameStart).count();
+		this->open = false;
+		for (size_t i = this->samples.size() > QUERIES ? this->samples.size() - QUERIES + 1 : 0; i < this->samples.size(); i++)
+			ReadQuery(i);
+
+		std::cout << std::endl << "Flythrough (" << this->name << ", " << this->samples.size() << " frames a " << width << "x" << height
+			<< ", " << this->warmupFrames << " de calentamiento)" << std::endl;
+		if (this->samples.empty())
+			return;
+		std::cout << std::left << std::setw(10) << "" << std::right << std::setw(10) << "min" << std::setw(10) << "media"
+			<< std::setw(10) << "p50" << std::setw(10) << "p95" << std::setw(10) << "p99" << std::setw(10) << "max" << std::endl;
+		PrintRow("cpu ms", &Sample::cpuMs);
+		PrintRow("gpu ms", &Sample::gpuMs);
+		PrintRow("wall ms", &Sample::wallMs);
+
+		if (csvPath.empty())
+			return;
+		std::ofstream csv(csvPath.c_str());
+		if (!csv)
+		{
+			std::cout << "ERROR::FLYTHROUGH:: no se pudo escribir " << csvPath << std::endl;
+			return;
+		}
+		csv << "frame,time_s,cpu_ms,gpu_ms,wall_ms," << RenderStats::CsvHeader() << std::endl << std::fixed << std::setprecision(4);
+		for (size_t i = 0; i < this->samples.size(); i++)
+		{
+			const Sample& sample = this->samples[i];
+			csv << i << "," << sample.seconds << "," << sample.cpuMs << "," << sample.gpuMs << "," << sample.wallMs << ",";
+			RenderStats::WriteCsv(csv, sample.stats);
+			csv << std::endl;
+		}
+		std::cout << "CSV: " << csvPath << std::endl;
+	}
+
+private:
+	static const int QUERIES = 4;
+
+	struct Sample
+	{
+		double seconds = 0.0;
+		double cpuMs = 0.0;
+		double gpuMs = 0.0;
+		double wallMs = 0.0;
+		RenderStats::Counters stats;
+	};
+
+	CameraPath path;
+	std::string name;
+	GLuint warmupFrames;
+	double frameSeconds;
+	GLuint frame;              // frames empezados, contando el calentamiento
+	bool active;
+	bool open;                 // hay un frame empezado cuyo wall ms falta
+	GLuint queries[QUERIES];
+	std::chrono::steady_clock::time_point frameStart;
+	std::vector<Sample> samples;
+
+	FlythroughBenchmark(const FlythroughBenchmark&);
+	FlythroughBenchmark& operator=(const FlythroughBenchmark&);
+
+	bool Recording() const { return this->frame > this->warmupFrames; }
+
+	double PathSeconds() const
+	{
+		return this->frame > this->warmupFrames ? (this->frame - this->warmupFrames - 1) * this->frameSeconds : 0.0;
+	}
+
+	void ReadQuery(size_t sample)
+	{
+		GLuint64 elapsed = 0;
+		glGetQueryObjectui64v(this->queries[sample % QUERIES], GL_QUERY_RESULT, &elapsed);
+		this->samples[sample].gpuMs = elapsed / 1.0e6;
+	}
+
+	void PrintRow(const char* label, double Sample::* field) const
+	{
+		std::vector<double> values;
+		double sum = 0.0;
+		for (size_t i = 0; i < this->samples.size(); i++)
+		{
+			values.push_back(this->samples[i].*field);
+			sum += values.back();
+		}
+		std::sort(values.begin(), values.end());
+		std::cout << std::left << std::setw(10) << label << std::right << std::fixed << std::setprecision(3)
+			<< std::setw(10) << values.front() << std::setw(10) << sum / values.size() << std::setw(10) << Percentile(values, 50.0)
+			<< std::setw(10) << Percentile(values, 95.0) << std::setw(10) << Percentile(values, 99.0) << std::setw(10) << values.back() << std::endl;
+	}
+};
@@ -0,0 +1,63 @@
+#pragma once
+
+// GL Includes
+#include <GL/glew.h>
+
+// Cuenta los fragmentos que pasan la prueba de profundidad (GL_SAMPLES_PASSED) en un tramo del frame.
+// Usa dos consultas alternadas: el resultado que se lee es el del frame anterior, as no se detiene el pipeline.
+class FragmentCounter
+{
+public:
+	FragmentCounter() : current(0), pending(false), lastCount(0)
+	{
+		glGenQueries(2, this->queries);
+	}
+
+	~FragmentCounter()
+	{
+		glDeleteQueries(2, this->queries);
+	}
+
+	void Begin()
+	{
+		glBeginQuery(GL_SAMPLES_PASSED, this->queries[this->current]);
+	}
+
+	void End()
+	{
+		glEndQuery(GL_SAMPLES_PASSED);
+
+		// Lee la consulta del frame anterior si ya est disponible
+		GLuint previous = this->queries[1 - this->current];
+		if (this->pending)
+		{
+			GLuint available = 0;
+			glGetQueryObjectuiv(previous, GL_QUERY_RESULT_AVAILABLE, &available);
+			if (available)
+				glGetQueryObjectuiv(previous, GL_QUERY_RESULT, &this->lastCount);
+		}
+		this->pending = true;
+		this->current = 1 - this->current;
+	}
+
+	// Fragmentos sombreados en el ltimo resultado disponible
+	GLuint GetCount() const
+	{
+		return this->lastCount;
+	}
+
+	// Fragmentos sombreados por pxel de pantalla (1.0 = sin sobre-dibujo)
+	double GetOverdraw(GLsizei width, GLsizei height) const
+	{
+		return (double)this->lastCount / ((double)width * height);
+	}
+
+private:
+	GLuint queries[2];
+	int current;
+	bool pending;
+	GLuint lastCount;
+
+	FragmentCounter(const FragmentCounter&);
+	FragmentCounter& operator=(const FragmentCounter&);
+};
@@ -0,0 +1,120 @@
+#pragma once
+
+// Std. Includes
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+// GL Includes
+#include <GL/glew.h>
+
+#include "SOIL2/stb_image_write.h"
+
+#include "RenderStats.h"
+
+// Framebuffer fuera de pantalla con una textura de color RGBA8 y una textura de profundidad de 24 bits
+// (textura para que otros pases, como las partculas, puedan leer la profundidad de la escena)
+class Framebuffer
+{
+public:
+	GLuint FBO;
+	GLuint colorTexture;
+	GLuint depthTexture;
+	GLsizei width, height;
+
+	Framebuffer(GLsizei width, GLsizei height) : width(width), height(height)
+	{
+		glGenFramebuffers(1, &this->FBO);
+		glBindFramebuffer(GL_FRAMEBUFFER, this->FBO);
+
+		// Color
+		glGenTextures(1, &this->colorTexture);
+		glBindTexture(GL_TEXTURE_2D, this->colorTexture);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, this->colorTexture, 0);
+
+		// Profundidad
+		glGenTextures(1, &this->depthTexture);
+		glBindTexture(GL_TEXTURE_2D, this->depthTexture);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, width, height, 0, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, NULL);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, this->depthTexture, 0);
+
+		if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		{
+			std::cout << "ERROR::FRAMEBUFFER:: Framebuffer is not complete (" << width << "x" << height << ")" << std::endl;
+		}
+
+		glBindTexture(GL_TEXTURE_2D, 0);
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		RenderStats::TrackTextureMemory(MemoryBytes());
+	}
+
+	~Framebuffer()
+	{
+		RenderStats::TrackTextureMemory(-MemoryBytes());
+		glDeleteTextures(1, &this->depthTexture);
+		glDeleteTextures(1, &this->colorTexture);
+		glDeleteFramebuffers(1, &this->FBO);
+	}
+
+	// Dibuja dentro del framebuffer usando todo su tamao como viewport
+	void Bind()
+	{
+		glBindFramebuffer(GL_FRAMEBUFFER, this->FBO);
+		glViewport(0, 0, this->width, this->height);
+	}
+
+	// Copia el color a otro framebuffer (0 = la ventana), escalando si cambia el tamao
+	void BlitColor(GLuint target, GLsizei targetWidth, GLsizei targetHeight)
+	{
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, this->FBO);
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, target);
+		glBlitFramebuffer(0, 0, this->width, this->height, 0, 0, targetWidth, targetHeight, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+		glBindFramebuffer(GL_FRAMEBUFFER, target);
+		glViewport(0, 0, targetWidth, targetHeight);
+	}
+
+	// Guarda el color en un PNG con el stb_image_write de SOIL2 (--headless --dump). OpenGL lee las filas de
+	// abajo hacia arriba y el PNG las espera de arriba hacia abajo
+	bool SavePng(const std::string& path) const
+	{
+		size_t rowBytes = (size_t)this->width * 3;
+		std::vector<unsigned char> pixels(rowBytes * this->height);
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, this->FBO);
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		glReadPixels(0, 0, this->width, this->height, GL_RGB, GL_UNSIGNED_BYTE, &pixels[0]);
+		glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+		std::vector<unsigned char> flipped(pixels.size());
+		for (GLsizei y = 0; y < this->height; y++)
+			std::copy(&pixels[y * rowBytes], &pixels[y * rowBytes] + rowBytes, &flipped[(this->height - 1 - y) * rowBytes]);
+		if (!stbi_write_png(path.c_str(), this->width, this->height, 3, &flipped[0], (int)rowBytes))
+		{
+			std::cout << "ERROR::FRAMEBUFFER:: no se pudo escribir " << path << std::endl;
+			return false;
+		}
+		return true;
+	}
+
+	static void Unbind()
+	{
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	}
+
+private:
+	Framebuffer(const Framebuffer&);
+	Framebuffer& operator=(const Framebuffer&);
+
+	// RGBA8 ms DEPTH_COMPONENT24 (que los drivers guardan en 4 bytes)
+	GLint64 MemoryBytes() const
+	{
+		return (GLint64)this->width * this->height * (4 + 4);
+	}
+};
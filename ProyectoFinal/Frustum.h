@@ -0,0 +1,30 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+// Planos del frustum de una matriz proyeccin * vista (Gribb y Hartmann) con la normal hacia adentro y
+// normalizados, para descartar esferas envolventes: la usan AnimationSystem y los microbenchmarks
+struct Frustum
+{
+	glm::vec4 planes[6];
+
+	void Extract(const glm::mat4& m)
+	{
+		for (int i = 0; i < 3; i++)
+		{
+			this->planes[i * 2] = glm::vec4(m[0][3] + m[0][i], m[1][3] + m[1][i], m[2][3] + m[2][i], m[3][3] + m[3][i]);
+			this->planes[i * 2 + 1] = glm::vec4(m[0][3] - m[0][i], m[1][3] - m[1][i], m[2][3] - m[2][i], m[3][3] - m[3][i]);
+		}
+		for (int i = 0; i < 6; i++)
+			this->planes[i] /= glm::length(glm::vec3(this->planes[i]));
+	}
+
+	// false solo si la esfera est entera detrs de algn plano
+	bool IntersectsSphere(const glm::vec3& center, float radius) const
+	{
+		for (int i = 0; i < 6; i++)
+			if (glm::dot(glm::vec3(this->planes[i]), center) + this->planes[i].w < -radius)
+				return false;
+		return true;
+	}
+};
@@ -0,0 +1,277 @@
+#pragma once
+
+// Std. Includes
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+
+// GL Includes
+#include <GL/glew.h>
+
+// Tiempo de GPU por pase de render. BeginPass/EndPass encierran un pase y se pueden anidar (un modelo dentro
+// de "Opacos", todos los pases dentro de "Frame"). Cada pase lleva:
+//  - un grupo de depuracin de KHR_debug (glPushDebugGroup) con su nombre, que RenderDoc, Nsight y apitrace
+//    muestran como rbol de eventos; si el contexto no tiene KHR_debug solo se mide
+//  - un par de marcas GL_TIMESTAMP (glQueryCounter) al inicio y al final: a diferencia de GL_TIME_ELAPSED se
+//    pueden anidar y no chocan con la consulta de FlythroughBenchmark
+// Las consultas de un frame se leen FRAMES frames despus y solo si ya estn listas, as nunca se detiene el
+// pipeline esperando a la GPU: un frame que todava no termina se descarta y se cuenta.
+// Los nombres deben vivir hasta que se lea su frame (literales o cadenas de los modelos)
+class GpuPassTimer
+{
+public:
+	static const unsigned int FRAMES = 3;
+
+	// Acumulado de un pase segn su ruta ("Frame/Opacos/Models/sillon"); si la ruta se repite en el frame suma los tiempos
+	struct Stats
+	{
+		std::string name;
+		std::string path;
+		unsigned int depth = 0;
+		unsigned int frames = 0;
+		double lastMs = 0.0;
+		double sumMs = 0.0;
+		double maxMs = 0.0;
+		double frameMs = 0.0;
+		bool touched = false;
+	};
+
+	GpuPassTimer() : frame(0), debugGroups(false), frames(0), dropped(0) {}
+
+	~GpuPassTimer()
+	{
+		for (unsigned int i = 0; i < FRAMES; i++)
+			if (!this->slots[i].queries.empty())
+				glDeleteQueries((GLsizei)this->slots[i].queries.size(), &this->slots[i].queries[0]);
+	}
+
+	// Adems de la tabla, escribe una fila por pase (con su ruta) y frame ledo; false si no se pudo abrir
+	bool OpenCsv(const std::string& path)
+	{
+		this->csv.open(path.c_str());
+		if (!this->csv)
+		{
+			std::cout << "ERROR::GPU_PASS_TIMER:: no se pudo escribir " << path << std::endl;
+			return false;
+		}
+		this->csv << "frame,pass,depth,gpu_ms" << std::endl << std::fixed << std::setprecision(4);
+		this->csvPath = path;
+		return true;
+	}
+
+	// Al inicio del frame: lee el frame que ocupaba este espacio (si ya termin) y lo reutiliza
+	void BeginFrame()
+	{
+		this->debugGroups = glPushDebugGroup != NULL && glPopDebugGroup != NULL;
+		Slot& slot = this->slots[this->frame % FRAMES];
+		if (slot.pending)
+			Collect(slot, false);
+		slot.passes.clear();
+		slot.used = 0;
+		slot.pending = true;
+		slot.frame = this->frame;
+		this->open.clear();
+	}
+
+	void BeginPass(const char* name)
+	{
+		Slot& slot = this->slots[this->frame % FRAMES];
+		if (this->debugGroups)
+			glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, -1, name);
+		Pass pass;
+		pass.name = name;
+		pass.depth = (unsigned int)this->open.size();
+		pass.begin = NextQuery(slot);
+		pass.end = pass.begin;
+		glQueryCounter(slot.queries[pass.begin], GL_TIMESTAMP);
+		this->open.push_back((unsigned int)slot.passes.size());
+		slot.passes.push_back(pass);
+	}
+
+	void EndPass()
+	{
+		Slot& slot = this->slots[this->frame % FRAMES];
+		Pass& pass = slot.passes[this->open.back()];
+		this->open.pop_back();
+		pass.end = NextQuery(slot);
+		glQueryCounter(slot.queries[pass.end], GL_TIMESTAMP);
+		if (this->debugGroups)
+			glPopDebugGroup();
+	}
+
+	// Sin ventana no hay intercambio de buffers que enve el frame al driver: glFlush lo enva sin esperarlo
+	void EndFrame()
+	{
+		glFlush();
+		this->frame++;
+	}
+
+	// Al terminar: espera los frames pendientes para que la tabla y el CSV los incluyan
+	void Flush()
+	{
+		glFinish();
+		for (unsigned int i = 0; i < FRAMES; i++)
+		{
+			Slot& slot = this->slots[(this->frame + i) % FRAMES];
+			if (slot.pending)
+				Collect(slot, true);
+		}
+	}
+
+	// Pases en orden de rbol (cada padre seguido de todos sus hijos), para el HUD
+	const std::vector<Stats>& Passes() const
+	{
+		return this->stats;
+	}
+
+	// ltimo valor ledo del pase con esa ruta, o 0 si todava no hay
+	double LastMs(const std::string& path) const
+	{
+		std::map<std::string, size_t>::const_iterator found = this->index.find(path);
+		return found == this->index.end() ? 0.0 : this->stats[found->second].lastMs;
+	}
+
+	// Tabla con el ltimo valor, la media y el mximo de cada pase; los anidados van sangrados bajo su padre
+	void PrintTable() const
+	{
+		std::cout << std::endl << "Tiempo de GPU por pase (" << this->frames << " frames ledos, " << this->dropped
+			<< " descartados" << (this->debugGroups ? "" : ", sin KHR_debug") << ")" << std::endl;
+		std::cout << std::left << std::setw(36) << "pase" << std::right << std::setw(10) << "ultimo" << std::setw(10) << "media"
+			<< std::setw(10) << "max" << std::setw(10) << "frames" << std::endl;
+		for (size_t i = 0; i < this->stats.size(); i++)
+		{
+			const Stats& pass = this->stats[i];
+			std::cout << std::left << std::setw(36) << std::string(2 * pass.depth, ' ') + pass.name << std::right << std::fixed
+				<< std::setprecision(3) << std::setw(10) << pass.lastMs << std::setw(10) << pass.sumMs / std::max(pass.frames, 1u)
+				<< std::setw(10) << pass.maxMs << std::setw(10) << pass.frames << std::endl;
+		}
+		if (!this->csvPath.empty())
+			std::cout << "CSV: " << this->csvPath << std::endl;
+	}
+
+private:
+	struct Pass
+	{
+		const char* name;
+		unsigned int depth;
+		unsigned int begin;  // ndices en las consultas del frame
+		unsigned int end;
+	};
+
+	// Consultas y pases de un frame en vuelo
+	struct Slot
+	{
+		std::vector<GLuint> queries;
+		unsigned int used = 0;
+		std::vector<Pass> passes;
+		bool pending = false;
+		unsigned int frame = 0;
+	};
+
+	Slot slots[FRAMES];
+	unsigned int frame;
+	bool debugGroups;
+	std::vector<unsigned int> open;  // pases empezados en el frame actual
+	std::vector<Stats> stats;        // en orden de rbol: un pase nuevo va al final del subrbol de su padre
+	std::map<std::string, size_t> index;
+	unsigned int frames;             // frames ledos
+	unsigned int dropped;
+	std::ofstream csv;
+	std::string csvPath;
+
+	GpuPassTimer(const GpuPassTimer&);
+	GpuPassTimer& operator=(const GpuPassTimer&);
+
+	unsigned int NextQuery(Slot& slot)
+	{
+		if (slot.used == slot.queries.size())
+		{
+			GLuint query = 0;
+			glGenQueries(1, &query);
+			slot.queries.push_back(query);
+		}
+		return slot.used++;
+	}
+
+	// Agrega entry despus del ltimo pase del subrbol de parent (al final si no tiene padre) y corre los ndices
+	size_t Insert(const Stats& entry, size_t parent)
+	{
+		size_t position = this->stats.size();
+		if (parent < this->stats.size())
+		{
+			position = parent + 1;
+			while (position < this->stats.size() && this->stats[position].depth > this->stats[parent].depth)
+				position++;
+		}
+		for (std::map<std::string, size_t>::iterator it = this->index.begin(); it != this->index.end(); ++it)
+			if (it->second >= position)
+				it->second++;
+		this->stats.insert(this->stats.begin() + position, entry);
+		return position;
+	}
+
+	// Sin wait, si la ltima marca del frame no est lista se descarta el frame entero (las marcas terminan en orden)
+	void Collect(Slot& slot, bool wait)
+	{
+		slot.pending = false;
+		if (slot.used == 0)
+			return;
+		if (!wait)
+		{
+			GLint available = 0;
+			glGetQueryObjectiv(slot.queries[slot.used - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+			if (!available)
+			{
+				this->dropped++;
+				return;
+			}
+		}
+
+		std::vector<GLuint64> stamps(slot.used);
+		for (unsigned int i = 0; i < slot.used; i++)
+			glGetQueryObjectui64v(slot.queries[i], GL_QUERY_RESULT, &stamps[i]);
+
+		// Los pases estn en el orden en que empezaron: el padre siempre va antes que sus hijos
+		std::vector<std::string> path;
+		for (size_t i = 0; i < slot.passes.size(); i++)
+		{
+			const Pass& pass = slot.passes[i];
+			path.resize(pass.depth);
+			path.push_back(pass.depth > 0 ? path.back() + "/" + pass.name : std::string(pass.name));
+			const std::string& key = path.back();
+			std::map<std::string, size_t>::iterator found = this->index.find(key);
+			if (found == this->index.end())
+			{
+				Stats entry;
+				entry.name = pass.name;
+				entry.path = key;
+				entry.depth = pass.depth;
+				size_t position = Insert(entry, pass.depth > 0 ? this->index[path[pass.depth - 1]] : this->stats.size());
+				found = this->index.insert(std::make_pair(key, position)).first;
+			}
+			Stats& entry = this->stats[found->second];
+			entry.frameMs += (stamps[pass.end] - stamps[pass.begin]) / 1.0e6;
+			entry.touched = true;
+		}
+
+		for (size_t i = 0; i < this->stats.size(); i++)
+		{
+			Stats& entry = this->stats[i];
+			if (!entry.touched)
+				continue;
+			entry.frames++;
+			entry.lastMs = entry.frameMs;
+			entry.sumMs += entry.frameMs;
+			entry.maxMs = std::max(entry.maxMs, entry.frameMs);
+			if (this->csv)
+				this->csv << slot.frame << "," << entry.path << "," << entry.depth << "," << entry.frameMs << "\n";
+			entry.frameMs = 0.0;
+			entry.touched = false;
+		}
+		this->frames++;
+	}
+};
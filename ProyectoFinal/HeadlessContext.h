@@ -0,0 +1,204 @@
+#pragma once
+
+// Std. Includes
+#include <iostream>
+#include <cstring>
+#include <vector>
+
+// GL Includes
+#include <GL/glew.h>
+
+#if defined(HEADLESS_OSMESA)
+#include <GL/osmesa.h>
+#elif defined(__linux__)
+// Sin los encabezados de X11: sus macros (None, Bool, Status) chocan con el resto del proyecto
+#define EGL_NO_X11
+#define MESA_EGL_NO_X11_HEADERS
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#ifndef EGL_PLATFORM_SURFACELESS_MESA
+#define EGL_PLATFORM_SURFACELESS_MESA 0x31DD
+#endif
+#ifndef EGL_NO_CONFIG_KHR
+#define EGL_NO_CONFIG_KHR ((EGLConfig)0)
+#endif
+#else
+#include <GLFW/glfw3.h>
+#endif
+
+// Contexto OpenGL sin ventana para --headless: el laboratorio de rendimiento es Linux sin pantalla con Mesa
+// llvmpipe. En Linux es un display EGL surfaceless (EGL_MESA_platform_surfaceless) con un contexto sin
+// superficie; compilando con HEADLESS_OSMESA es un contexto de OSMesa (GLEW debe estar compilado con
+// GLEW_OSMESA para cargar las funciones de libOSMesa). En Windows es una ventana GLFW oculta.
+// En todos los casos no hay un framebuffer por defecto que se pueda mostrar: la escena se dibuja en un Framebuffer
+class HeadlessContext
+{
+public:
+	HeadlessContext()
+#if defined(HEADLESS_OSMESA)
+		: context(NULL)
+#elif defined(__linux__)
+		: display(EGL_NO_DISPLAY), surface(EGL_NO_SURFACE), context(EGL_NO_CONTEXT)
+#else
+		: window(NULL)
+#endif
+	{
+	}
+
+	~HeadlessContext()
+	{
+		Destroy();
+	}
+
+	// Crea un contexto de perfil ncleo (4.5, o 3.3 si el driver no llega) y lo hace actual; false si no se pudo
+	bool Create()
+	{
+		const int versions[][2] = { { 4, 5 }, { 3, 3 } };
+#if defined(HEADLESS_OSMESA)
+		for (int v = 0; v < 2 && this->context == NULL; v++)
+		{
+			const int attribs[] = { OSMESA_FORMAT, OSMESA_RGBA, OSMESA_DEPTH_BITS, 24, OSMESA_PROFILE, OSMESA_CORE_PROFILE,
+				OSMESA_CONTEXT_MAJOR_VERSION, versions[v][0], OSMESA_CONTEXT_MINOR_VERSION, versions[v][1], 0 };
+			this->context = OSMesaCreateContextAttribs(attribs, NULL);
+		}
+		if (this->context == NULL)
+			return Fail("OSMesaCreateContextAttribs");
+
+		// OSMesa necesita un buffer de color para hacerse actual; nunca se dibuja en l
+		this->buffer.assign(4, 0);
+		if (!OSMesaMakeCurrent(this->context, &this->buffer[0], GL_UNSIGNED_BYTE, 1, 1))
+			return Fail("OSMesaMakeCurrent");
+#elif defined(__linux__)
+		// El display surfaceless no necesita X11 ni un dispositivo DRM; si falta la extensin (otro driver),
+		// el display por defecto (EGL_PLATFORM=surfaceless tambin lo elige)
+		const char* clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+		PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+		if (getPlatformDisplay != NULL && clientExtensions != NULL && strstr(clientExtensions, "EGL_MESA_platform_surfaceless") != NULL)
+			this->display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+		else
+			this->display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+		EGLint major = 0, minor = 0;
+		if (this->display == EGL_NO_DISPLAY || !eglInitialize(this->display, &major, &minor))
+			return Fail("eglInitialize");
+		if (!eglBindAPI(EGL_OPENGL_API))
+			return Fail("eglBindAPI");
+
+		// Sin configuracin si el driver lo permite; si no, una cualquiera con un pbuffer de 1x1
+		EGLConfig config = EGL_NO_CONFIG_KHR;
+		const char* extensions = eglQueryString(this->display, EGL_EXTENSIONS);
+		bool noConfig = extensions != NULL && strstr(extensions, "EGL_KHR_no_config_context") != NULL;
+		bool surfaceless = extensions != NULL && strstr(extensions, "EGL_KHR_surfaceless_context") != NULL;
+		if (!noConfig || !surfaceless)
+		{
+			const EGLint configAttribs[] = { EGL_SURFACE_TYPE, EGL_PBUFFER_BIT, EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE };
+			EGLint count = 0;
+			if (!eglChooseConfig(this->display, configAttribs, &config, 1, &count) || count == 0)
+				return Fail("eglChooseConfig");
+		}
+		if (!surfaceless)
+		{
+			const EGLint surfaceAttribs[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+			this->surface = eglCreatePbufferSurface(this->display, config, surfaceAttribs);
+			if (this->surface == EGL_NO_SURFACE)
+				return Fail("eglCreatePbufferSurface");
+		}
+
+		for (int v = 0; v < 2 && this->context == EGL_NO_CONTEXT; v++)
+		{
+			const EGLint contextAttribs[] = { EGL_CONTEXT_MAJOR_VERSION, versions[v][0], EGL_CONTEXT_MINOR_VERSION, versions[v][1],
+				EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT, EGL_NONE };
+			this->context = eglCreateContext(this->display, config, EGL_NO_CONTEXT, contextAttribs);
+		}
+		if (this->context == EGL_NO_CONTEXT)
+			return Fail("eglCreateContext");
+		if (!eglMakeCurrent(this->display, this->surface, this->surface, this->context))
+			return Fail("eglMakeCurrent");
+#else
+		if (!glfwInit())
+			return Fail("glfwInit");
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+		for (int v = 0; v < 2 && this->window == NULL; v++)
+		{
+			glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, versions[v][0]);
+			glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, versions[v][1]);
+			glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+			this->window = glfwCreateWindow(1, 1, "Proyecto Final (headless)", nullptr, nullptr);
+		}
+		if (this->window == NULL)
+			return Fail("glfwCreateWindow");
+		glfwMakeContextCurrent(this->window);
+#endif
+		return true;
+	}
+
+	const char* Backend() const
+	{
+#if defined(HEADLESS_OSMESA)
+		return "OSMesa";
+#elif defined(__linux__)
+		return this->surface == EGL_NO_SURFACE ? "EGL surfaceless" : "EGL pbuffer";
+#else
+		return "GLFW (ventana oculta)";
+#endif
+	}
+
+	// glewInit tambin carga las extensiones de GLX: con un contexto de EGL y sin display de X devuelve
+	// GLEW_ERROR_NO_GLX_DISPLAY, pero las funciones de OpenGL ya quedaron cargadas
+	static bool GlewReady(GLenum status)
+	{
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+		if (status == GLEW_ERROR_NO_GLX_DISPLAY)
+			return true;
+#endif
+		return status == GLEW_OK;
+	}
+
+private:
+#if defined(HEADLESS_OSMESA)
+	OSMesaContext context;
+	std::vector<GLubyte> buffer;
+#elif defined(__linux__)
+	EGLDisplay display;
+	EGLSurface surface;
+	EGLContext context;
+#else
+	GLFWwindow* window;
+#endif
+
+	HeadlessContext(const HeadlessContext&);
+	HeadlessContext& operator=(const HeadlessContext&);
+
+	bool Fail(const char* step)
+	{
+		std::cout << "ERROR::HEADLESS:: fallo " << step << " (" << Backend() << ")" << std::endl;
+		Destroy();
+		return false;
+	}
+
+	void Destroy()
+	{
+#if defined(HEADLESS_OSMESA)
+		if (this->context != NULL)
+			OSMesaDestroyContext(this->context);
+		this->context = NULL;
+#elif defined(__linux__)
+		if (this->display != EGL_NO_DISPLAY)
+		{
+			eglMakeCurrent(this->display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+			if (this->context != EGL_NO_CONTEXT)
+				eglDestroyContext(this->display, this->context);
+			if (this->surface != EGL_NO_SURFACE)
+				eglDestroySurface(this->display, this->surface);
+			eglTerminate(this->display);
+		}
+		this->display = EGL_NO_DISPLAY;
+		this->surface = EGL_NO_SURFACE;
+		this->context = EGL_NO_CONTEXT;
+#else
+		if (this->window != NULL)
+			glfwDestroyWindow(this->window);
+		this->window = NULL;
+#endif
+	}
+};
@@ -0,0 +1,200 @@
+#pragma once
+
+// Std. Includes
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <cstring>
+#include <cstdint>
+
+// GLFW
+#include <GLFW/glfw3.h>
+
+// Grabacin de la entrada para repetir una sesin exactamente (--record <ruta> y --replay <ruta>). Por cada
+// frame se guarda el tiempo con el que corri (AppTime) y, en orden, los eventos que llegaron a KeyCallback y
+// MouseCallback durante ese frame. Al reproducir, cada frame toma el tiempo grabado (o un paso fijo con
+// --replay-fixed) y los eventos se entregan a los mismos callbacks en lugar de los de GLFW, as la cmara, las
+// animaciones (teclas 1 a 5) y los interruptores (P, I, H, F1, ...) pasan por el mismo cdigo que en vivo.
+// Formato binario en el orden de bytes de la mquina (x86/x64), tras el encabezado "PFIN" y la versin:
+//   'F' double segundos                                   inicio de frame, 9 bytes
+//   'K' int16 tecla, int16 scancode, uint8 accin, uint8 mods  evento de teclado, 7 bytes
+//   'M' double x, double y                                 posicin del cursor, 17 bytes
+// El cursor se guarda como GLFW lo entrega (posicin absoluta): MouseCallback calcula los desplazamientos y
+// con los mismos doubles da los mismos floats que en la sesin original
+class InputRecorder
+{
+public:
+	typedef void (*KeyHandler)(GLFWwindow* window, int key, int scancode, int action, int mods);
+	typedef void (*CursorHandler)(GLFWwindow* window, double x, double y);
+
+	InputRecorder() : mode(OFF), fixedStep(0.0), frameSeconds(0.0), frames(0), keyEvents(0), cursorEvents(0), finished(false) {}
+
+	~InputRecorder()
+	{
+		Close();
+	}
+
+	bool Record(const std::string& path)
+	{
+		this->file.open(path.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!this->file)
+		{
+			std::cout << "ERROR::INPUT:: no se pudo escribir " << path << std::endl;
+			return false;
+		}
+		this->file.write(MAGIC, 4);
+		Write<uint32_t>(VERSION);
+		this->path = path;
+		this->mode = RECORD;
+		return true;
+	}
+
+	// fixedStep > 0 ignora los tiempos grabados y avanza fixedStep segundos por frame
+	bool Replay(const std::string& path, double fixedStep = 0.0)
+	{
+		this->file.open(path.c_str(), std::ios::in | std::ios::binary);
+		char magic[4] = {};
+		uint32_t version = 0;
+		if (!this->file || !this->file.read(magic, 4) || std::memcmp(magic, MAGIC, 4) != 0 || !Read(version) || version != VERSION)
+		{
+			std::cout << "ERROR::INPUT:: " << path << " no es una grabacion de entrada (version " << VERSION << ")" << std::endl;
+			this->file.close();
+			return false;
+		}
+		this->path = path;
+		this->mode = REPLAY;
+		this->fixedStep = fixedStep;
+		this->finished = this->file.peek() == EOF;
+		return true;
+	}
+
+	bool Recording() const { return this->mode == RECORD; }
+	bool Replaying() const { return this->mode == REPLAY; }
+	bool Active() const { return this->mode != OFF; }
+
+	// Reproduciendo: ya se entreg el ltimo frame grabado
+	bool Finished() const { return this->finished; }
+
+	// Al inicio de cada frame. Grabando, liveSeconds queda como el tiempo del frame; reproduciendo se lee el
+	// tiempo grabado. Devuelve el tiempo del frame, el mismo que da FrameSeconds() hasta el siguiente
+	double BeginFrame(double liveSeconds)
+	{
+		if (this->mode == RECORD)
+		{
+			this->frameSeconds = liveSeconds;
+			this->file.put('F');
+			Write(liveSeconds);
+		}
+		else if (this->mode == REPLAY && !this->finished)
+		{
+			double recorded = 0.0;
+			if (this->file.get() != 'F' || !Read(recorded))
+			{
+				std::cout << "ERROR::INPUT:: " << this->path << " esta incompleto en el frame " << this->frames << std::endl;
+				this->finished = true;
+			}
+			this->frameSeconds = this->fixedStep > 0.0 ? this->frames * this->fixedStep : recorded;
+		}
+		this->frames++;
+		return this->frameSeconds;
+	}
+
+	double FrameSeconds() const { return this->frameSeconds; }
+
+	// Grabando: desde KeyCallback y MouseCallback, con los argumentos tal como llegaron
+	void RecordKey(int key, int scancode, int action, int mods)
+	{
+		if (this->mode != RECORD)
+			return;
+		this->file.put('K');
+		Write<int16_t>((int16_t)key);
+		Write<int16_t>((int16_t)scancode);
+		Write<uint8_t>((uint8_t)action);
+		Write<uint8_t>((uint8_t)mods);
+		this->keyEvents++;
+	}
+
+	void RecordCursor(double x, double y)
+	{
+		if (this->mode != RECORD)
+			return;
+		this->file.put('M');
+		Write(x);
+		Write(y);
+		this->cursorEvents++;
+	}
+
+	// Reproduciendo: entrega los eventos del frame actual, en el orden grabado, hasta el siguiente frame
+	void DispatchFrame(GLFWwindow* window, KeyHandler onKey, CursorHandler onCursor)
+	{
+		if (this->mode != REPLAY || this->finished)
+			return;
+		for (int tag = this->file.peek(); tag != EOF && tag != 'F'; tag = this->file.peek())
+		{
+			this->file.get();
+			if (tag == 'K')
+			{
+				int16_t key = 0, scancode = 0;
+				uint8_t action = 0, mods = 0;
+				if (!Read(key) || !Read(scancode) || !Read(action) || !Read(mods))
+					break;
+				onKey(window, key, scancode, action, mods);
+				this->keyEvents++;
+			}
+			else if (tag == 'M')
+			{
+				double x = 0.0, y = 0.0;
+				if (!Read(x) || !Read(y))
+					break;
+				onCursor(window, x, y);
+				this->cursorEvents++;
+			}
+			else
+			{
+				std::cout << "ERROR::INPUT:: " << this->path << " tiene un registro desconocido en el frame " << this->frames << std::endl;
+				this->finished = true;
+				return;
+			}
+		}
+		this->finished = this->file.peek() == EOF;
+	}
+
+	void Close()
+	{
+		if (this->mode == OFF)
+			return;
+		std::cout << "Entrada " << (this->mode == RECORD ? "grabada" : "reproducida") << ": " << this->frames << " frames, "
+			<< this->keyEvents << " eventos de teclado, " << this->cursorEvents << " del cursor (" << this->path << ")" << std::endl;
+		this->file.close();
+		this->mode = OFF;
+	}
+
+private:
+	enum Mode { OFF, RECORD, REPLAY };
+	static constexpr const char* MAGIC = "PFIN";
+	static const uint32_t VERSION = 1;
+
+	Mode mode;
+	std::fstream file;
+	std::string path;
+	double fixedStep;
+	double frameSeconds;
+	unsigned int frames;
+	unsigned int keyEvents, cursorEvents;
+	bool finished;
+
+	InputRecorder(const InputRecorder&);
+	InputRecorder& operator=(const InputRecorder&);
+
+	template <typename T>
+	void Write(T value)
+	{
+		this->file.write((const char*)&value, sizeof(T));
+	}
+
+	template <typename T>
+	bool Read(T& value)
+	{
+		return (bool)this->file.read((char*)&value, sizeof(T));
+	}
+};
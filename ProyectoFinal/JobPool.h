@@ -0,0 +1,120 @@
+#pragma once
+
+// Std. Includes
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <algorithm>
+
+#include "Profiler.h"
+
+// Hilos de trabajo fijos para repartir un ciclo entre ncleos (AnimationSystem). ParallelFor reparte
+// [0, count) en bloques que cada hilo toma con un contador atmico; el hilo que llama tambin trabaja y
+// regresa cuando terminaron todos los bloques. Los trabajos no deben usar OpenGL: el contexto es del hilo
+// de render. Con un solo ncleo no se crean hilos y todo corre en el que llama
+class JobPool
+{
+public:
+	// threads = hilos en total contando el que llama (0 = uno por ncleo)
+	JobPool(unsigned int threads = 0) : job(NULL), count(0), grain(1), generation(0), pending(0), stopping(false)
+	{
+		if (threads == 0)
+			threads = std::max(std::thread::hardware_concurrency(), 1u);
+		for (unsigned int i = 1; i < threads; i++)
+			this->workers.push_back(std::thread(&JobPool::WorkerLoop, this));
+	}
+
+	~JobPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			this->stopping = true;
+		}
+		this->wake.notify_all();
+		for (unsigned int i = 0; i < this->workers.size(); i++)
+			this->workers[i].join();
+	}
+
+	unsigned int Threads() const { return (unsigned int)this->workers.size() + 1; }
+
+	// Llama job(begin, end) sobre bloques de a lo ms grain elementos hasta cubrir [0, count)
+	void ParallelFor(unsigned int count, unsigned int grain, const std::function<void(unsigned int, unsigned int)>& job)
+	{
+		if (count == 0)
+			return;
+		grain = std::max(grain, 1u);
+		if (this->workers.empty() || count <= grain)
+		{
+			job(0, count);
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			this->job = &job;
+			this->count = count;
+			this->grain = grain;
+			this->next = 0;
+			this->pending = (unsigned int)this->workers.size();
+			this->generation++;
+		}
+		this->wake.notify_all();
+		RunChunks();
+
+		std::unique_lock<std::mutex> lock(this->mutex);
+		this->done.wait(lock, [this] { return this->pending == 0; });
+		this->job = NULL;
+	}
+
+private:
+	std::vector<std::thread> workers;
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::condition_variable done;
+	const std::function<void(unsigned int, unsigned int)>* job;
+	std::atomic<unsigned int> next;
+	unsigned int count;
+	unsigned int grain;
+	unsigned int generation;  // cambia con cada ParallelFor para despertar a los hilos
+	unsigned int pending;     // hilos que todava no terminan el ParallelFor actual
+	bool stopping;
+
+	JobPool(const JobPool&);
+	JobPool& operator=(const JobPool&);
+
+	void RunChunks()
+	{
+		for (;;)
+		{
+			unsigned int begin = this->next.fetch_add(this->grain);
+			if (begin >= this->count)
+				return;
+			(*this->job)(begin, std::min(begin + this->grain, this->count));
+		}
+	}
+
+	void WorkerLoop()
+	{
+		Profiler::SetThreadName("JobPool");
+		unsigned int seen = 0;
+		for (;;)
+		{
+			{
+				std::unique_lock<std::mutex> lock(this->mutex);
+				this->wake.wait(lock, [this, seen] { return this->stopping || this->generation != seen; });
+				if (this->stopping)
+					return;
+				seen = this->generation;
+			}
+			RunChunks();
+			{
+				std::lock_guard<std::mutex> lock(this->mutex);
+				if (--this->pending == 0)
+					this->done.notify_one();
+			}
+		}
+	}
+};
@@ -0,0 +1,254 @@
+#pragma once
+
+// Std. Includes
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <chrono>
+
+// GL Includes
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "Shader.h"
+#include "Mesh.h"
+#include "Lights.h"
+#include "Framebuffer.h"
+
+// Escena de prueba limitada por fragmentos para comparar el shader de iluminacin
+// anterior (Shaders/lightingLegacy.*) contra el optimizado (Shaders/lighting.*).
+// Dibuja varias capas de un plano de 20x20 que cubre toda la pantalla, sin prueba de
+// profundidad, para que cada capa sombree todos los pxeles del framebuffer.
+class LightingBenchmark
+{
+public:
+	LightingBenchmark(GLuint layers = 8, GLuint frames = 60, GLuint warmupFrames = 10)
+		: layers(layers), frames(frames), warmupFrames(warmupFrames)
+	{
+	}
+
+	// Mide ambos shaders a 1080p y 4K fuera de pantalla e imprime la tabla de resultados
+	void Run(LightBuffer& lights)
+	{
+		Shader legacyShader("Shaders/lightingLegacy.vs", "Shaders/lightingLegacy.frag");
+		Shader optimizedShader("Shaders/lighting.vs", "Shaders/lighting.frag");
+		LightBuffer::BindProgram(optimizedShader.Program);
+
+		Mesh plane = CreatePlane();
+
+		const GLsizei resolutions[][2] = { { 1920, 1080 }, { 3840, 2160 } };
+
+		std::cout << std::endl << "Lighting benchmark (" << this->layers << " capas, " << this->frames << " frames)" << std::endl;
+		std::cout << std::left << std::setw(12) << "resolucion" << std::setw(12) << "shader"
+			<< std::right << std::setw(12) << "gpu ms" << std::setw(12) << "wall ms" << std::setw(14) << "Mfrag/s" << std::setw(10) << "speedup" << std::endl;
+
+		for (unsigned int r = 0; r < 2; r++)
+		{
+			GLsizei width = resolutions[r][0];
+			GLsizei height = resolutions[r][1];
+			Framebuffer target(width, height);
+
+			Timing legacy = Measure(legacyShader, true, plane, target, lights);
+			Timing optimized = Measure(optimizedShader, false, plane, target, lights);
+
+			PrintRow(width, height, "legacy", legacy, 1.0);
+			PrintRow(width, height, "optimized", optimized, legacy.wallMs / optimized.wallMs);
+		}
+		std::cout << std::endl;
+
+		Framebuffer::Unbind();
+		for (unsigned int i = 0; i < plane.textures.size(); i++)
+		{
+			glDeleteTextures(1, &plane.textures[i].id);
+		}
+	}
+
+private:
+	GLuint layers;
+	GLuint frames;
+	GLuint warmupFrames;
+
+	// Promedios por frame: GPU con GL_TIME_ELAPSED y tiempo de pared entre dos glFinish
+	// (el segundo es el confiable en renderizadores por software como llvmpipe)
+	struct Timing
+	{
+		double gpuMs;
+		double wallMs;
+	};
+
+	Timing Measure(Shader& shader, bool legacy, Mesh& plane, Framebuffer& target, LightBuffer& lights)
+	{
+		target.Bind();
+		glDisable(GL_DEPTH_TEST);
+		glDisable(GL_BLEND);
+
+		shader.Use();
+		SetCommonUniforms(shader.Program);
+		if (legacy)
+			ApplyLegacyLightUniforms(shader.Program, lights.lights);
+		else
+			lights.Upload();
+
+		GLint modelLoc = glGetUniformLocation(shader.Program, "model");
+		GLint normalLoc = glGetUniformLocation(shader.Program, "normalMatrix");
+
+		std::vector<GLuint> queries(this->frames);
+		glGenQueries(this->frames, &queries[0]);
+
+		std::chrono::steady_clock::time_point wallStart;
+		for (GLuint frame = 0; frame < this->warmupFrames + this->frames; frame++)
+		{
+			bool timed = frame >= this->warmupFrames;
+			if (frame == this->warmupFrames)
+			{
+				glFinish();
+				wallStart = std::chrono::steady_clock::now();
+			}
+			if (timed)
+				glBeginQuery(GL_TIME_ELAPSED, queries[frame - this->warmupFrames]);
+
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+			for (GLuint layer = 0; layer < this->layers; layer++)
+			{
+				glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.01f * layer, 0.0f));
+				glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
+				if (normalLoc != -1)
+					glUniformMatrix3fv(normalLoc, 1, GL_FALSE, glm::value_ptr(glm::mat3(glm::transpose(glm::inverse(model)))));
+				plane.Draw(shader);
+			}
+
+			if (timed)
+				glEndQuery(GL_TIME_ELAPSED);
+		}
+		glFinish();
+		std::chrono::duration<double, std::milli> wall = std::chrono::steady_clock::now() - wallStart;
+
+		// Los resultados se leen al final para no detener el pipeline entre frames
+		GLuint64 total = 0;
+		for (GLuint i = 0; i < this->frames; i++)
+		{
+			GLuint64 elapsed = 0;
+			glGetQueryObjectui64v(queries[i], GL_QUERY_RESULT, &elapsed);
+			total += elapsed;
+		}
+		glDeleteQueries(this->frames, &queries[0]);
+
+		glEnable(GL_DEPTH_TEST);
+
+		Timing timing;
+		timing.gpuMs = (double)total / this->frames / 1.0e6;
+		timing.wallMs = wall.count() / this->frames;
+		return timing;
+	}
+
+	void PrintRow(GLsizei width, GLsizei height, const char* name, Timing timing, double speedup)
+	{
+		double fragments = (double)width * height * this->layers;
+		std::string resolution = std::to_string(width) + "x" + std::to_string(height);
+		std::cout << std::left << std::setw(12) << resolution << std::setw(12) << name
+			<< std::right << std::fixed << std::setprecision(3) << std::setw(12) << timing.gpuMs << std::setw(12) << timing.wallMs
+			<< std::setprecision(1) << std::setw(14) << fragments / (timing.gpuMs * 1.0e3)
+			<< std::setprecision(2) << std::setw(9) << speedup << "x" << std::endl;
+	}
+
+	// Cmara ortogrfica mirando el plano desde arriba: el plano ocupa todo el viewport
+	void SetCommonUniforms(GLuint program)
+	{
+		glm::vec3 eye(0.0f, 20.0f, 0.0f);
+		glm::mat4 view = glm::lookAt(eye, glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f));
+		glm::mat4 projection = glm::ortho(-10.0f, 10.0f, -10.0f, 10.0f, 0.1f, 100.0f);
+
+		glUniformMatrix4fv(glGetUniformLocation(program, "view"), 1, GL_FALSE, glm::value_ptr(view));
+		glUniformMatrix4fv(glGetUniformLocation(program, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+		glUniform3f(glGetUniformLocation(program, "viewPos"), eye.x, eye.y, eye.z);
+		glUniform1f(glGetUniformLocation(program, "material.shininess"), 32.0f);
+		glUniform1i(glGetUniformLocation(program, "material.diffuse"), 0);
+		glUniform1i(glGetUniformLocation(program, "material.specular"), 1);
+		glUniform1i(glGetUniformLocation(program, "trans"), 0);
+		glUniform1i(glGetUniformLocation(program, "anim"), 0);
+	}
+
+	// El shader anterior usa uniforms sueltos: dirLight, pointLights[3] y spotLight
+	static void ApplyLegacyLightUniforms(GLuint program, const std::vector<PackedLight>& lights)
+	{
+		unsigned int point = 0;
+		for (unsigned int i = 0; i < lights.size(); i++)
+		{
+			const PackedLight& light = lights[i];
+			std::string name;
+			int type = (int)light.position.w;
+			if (type == LIGHT_DIRECTIONAL)
+				name = "dirLight";
+			else if (type == LIGHT_POINT && point < 3)
+				name = "pointLights[" + std::to_string(point++) + "]";
+			else if (type == LIGHT_SPOT)
+				name = "spotLight";
+			else
+				continue;
+
+			glUniform3fv(glGetUniformLocation(program, (name + ".position").c_str()), 1, glm::value_ptr(light.position));
+			glUniform3fv(glGetUniformLocation(program, (name + ".direction").c_str()), 1, glm::value_ptr(light.direction));
+			glUniform3fv(glGetUniformLocation(program, (name + ".ambient").c_str()), 1, glm::value_ptr(light.ambient));
+			glUniform3fv(glGetUniformLocation(program, (name + ".diffuse").c_str()), 1, glm::value_ptr(light.diffuse));
+			glUniform3fv(glGetUniformLocation(program, (name + ".specular").c_str()), 1, glm::value_ptr(light.specular));
+			glUniform1f(glGetUniformLocation(program, (name + ".constant").c_str()), light.attenuation.x);
+			glUniform1f(glGetUniformLocation(program, (name + ".linear").c_str()), light.attenuation.y);
+			glUniform1f(glGetUniformLocation(program, (name + ".quadratic").c_str()), light.attenuation.z);
+			glUniform1f(glGetUniformLocation(program, (name + ".cutOff").c_str()), light.cone.x);
+			glUniform1f(glGetUniformLocation(program, (name + ".outerCutOff").c_str()), light.cone.y);
+		}
+	}
+
+	// Plano de 20x20 en y = 0 con texturas difusa y especular generadas por cdigo
+	static Mesh CreatePlane()
+	{
+		vector<Vertex> vertices(4);
+		const GLfloat corners[4][2] = { { -10.0f, -10.0f }, { 10.0f, -10.0f }, { 10.0f, 10.0f }, { -10.0f, 10.0f } };
+		for (unsigned int i = 0; i < 4; i++)
+		{
+			vertices[i].Position = glm::vec3(corners[i][0], 0.0f, corners[i][1]);
+			vertices[i].Normal = glm::vec3(0.0f, 1.0f, 0.0f);
+			vertices[i].TexCoords = glm::vec2(corners[i][0], corners[i][1]) * 0.25f;
+			vertices[i].Tangent = glm::vec3(1.0f, 0.0f, 0.0f);
+			vertices[i].Bitangent = glm::vec3(0.0f, 0.0f, 1.0f);
+		}
+		vector<unsigned int> indices = { 0, 2, 1, 0, 3, 2 };
+
+		vector<Texture> textures(2);
+		textures[0].id = CreateNoiseTexture(1);
+		textures[0].type = "texture_diffuse";
+		textures[1].id = CreateNoiseTexture(2);
+		textures[1].type = "texture_specular";
+
+		return Mesh(vertices, indices, textures);
+	}
+
+	static GLuint CreateNoiseTexture(unsigned int seed)
+	{
+		const int size = 512;
+		std::vector<unsigned char> pixels(size * size * 4);
+		std::srand(seed);
+		for (unsigned int i = 0; i < pixels.size(); i++)
+		{
+			// Nunca por debajo de 0.1 para que el descarte por alfa no se active
+			pixels[i] = (unsigned char)(32 + std::rand() % 224);
+		}
+
+		GLuint textureID;
+		glGenTextures(1, &textureID);
+		glBindTexture(GL_TEXTURE_2D, textureID);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, size, size, 0, GL_RGBA, GL_UNSIGNED_BYTE, &pixels[0]);
+		glGenerateMipmap(GL_TEXTURE_2D);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		return textureID;
+	}
+};
@@ -0,0 +1,137 @@
+#pragma once
+
+// Std. Includes
+#include <vector>
+
+// GL Includes
+#include <GL/glew.h>
+
+#include "RenderStats.h"
+
+#include <glm/glm.hpp>
+
+// Tipos de luz, deben coincidir con los #define de Shaders/lighting.frag
+enum LightType
+{
+	LIGHT_DIRECTIONAL = 0,
+	LIGHT_POINT = 1,
+	LIGHT_SPOT = 2
+};
+
+// Mximo de luces en el bloque uniforme (igual que MAX_LIGHTS en lighting.frag)
+const unsigned int MAX_LIGHTS = 64;
+
+// Punto de enlace (binding) del bloque "LightBlock"
+const GLuint LIGHT_BLOCK_BINDING = 0;
+
+// Una luz empaquetada en vec4 para respetar el layout std140 del shader
+//  position    : xyz = posicin,  w = tipo de luz
+//  direction   : xyz = direccin, w = sin usar
+//  ambient/diffuse/specular : rgb = color, w = sin usar
+//  attenuation : x = constante, y = lineal, z = cuadrtica, w = escala de distancia
+//  cone        : x = cos(corte interior), y = cos(corte exterior)
+struct PackedLight
+{
+	glm::vec4 position;
+	glm::vec4 direction;
+	glm::vec4 ambient;
+	glm::vec4 diffuse;
+	glm::vec4 specular;
+	glm::vec4 attenuation;
+	glm::vec4 cone;
+};
+
+// Arreglo de luces que se sube completo al shader en una sola llamada (Uniform Buffer Object)
+class LightBuffer
+{
+public:
+	std::vector<PackedLight> lights;
+
+	LightBuffer()
+	{
+		glGenBuffers(1, &this->ubo);
+		glBindBuffer(GL_UNIFORM_BUFFER, this->ubo);
+		glBufferData(GL_UNIFORM_BUFFER, sizeof(glm::ivec4) + MAX_LIGHTS * sizeof(PackedLight), NULL, GL_DYNAMIC_DRAW);
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	}
+
+	~LightBuffer()
+	{
+		glDeleteBuffers(1, &this->ubo);
+	}
+
+	void Clear()
+	{
+		this->lights.clear();
+	}
+
+	void AddDirectional(glm::vec3 direction, glm::vec3 ambient, glm::vec3 diffuse, glm::vec3 specular)
+	{
+		PackedLight light = Make(LIGHT_DIRECTIONAL, glm::vec3(0.0f), direction, ambient, diffuse, specular);
+		light.attenuation = glm::vec4(1.0f, 0.0f, 0.0f, 1.0f);
+		this->lights.push_back(light);
+	}
+
+	// distanceScale multiplica la distancia antes de atenuar (hace la luz ms pequea)
+	void AddPoint(glm::vec3 position, glm::vec3 ambient, glm::vec3 diffuse, glm::vec3 specular,
+		GLfloat constant, GLfloat linear, GLfloat quadratic, GLfloat distanceScale = 1.0f)
+	{
+		PackedLight light = Make(LIGHT_POINT, position, glm::vec3(0.0f), ambient, diffuse, specular);
+		light.attenuation = glm::vec4(constant, linear, quadratic, distanceScale);
+		this->lights.push_back(light);
+	}
+
+	// cutOff y outerCutOff ya vienen como coseno del ngulo
+	void AddSpot(glm::vec3 position, glm::vec3 direction, glm::vec3 ambient, glm::vec3 diffuse, glm::vec3 specular,
+		GLfloat constant, GLfloat linear, GLfloat quadratic, GLfloat cutOff, GLfloat outerCutOff, GLfloat distanceScale = 1.0f)
+	{
+		PackedLight light = Make(LIGHT_SPOT, position, direction, ambient, diffuse, specular);
+		light.attenuation = glm::vec4(constant, linear, quadratic, distanceScale);
+		light.cone = glm::vec4(cutOff, outerCutOff, 0.0f, 0.0f);
+		this->lights.push_back(light);
+	}
+
+	// Sube el nmero de luces y el arreglo completo en una sola copia
+	void Upload()
+	{
+		glm::ivec4 count((GLint)glm::min((unsigned int)this->lights.size(), MAX_LIGHTS), 0, 0, 0);
+
+		glBindBuffer(GL_UNIFORM_BUFFER, this->ubo);
+		RenderStats::BufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(count), &count);
+		if (count.x > 0)
+		{
+			RenderStats::BufferSubData(GL_UNIFORM_BUFFER, sizeof(count), count.x * sizeof(PackedLight), &this->lights[0]);
+		}
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+		glBindBufferBase(GL_UNIFORM_BUFFER, LIGHT_BLOCK_BINDING, this->ubo);
+	}
+
+	// Conecta el bloque "LightBlock" de un programa con el punto de enlace del buffer
+	static void BindProgram(GLuint program)
+	{
+		GLuint index = glGetUniformBlockIndex(program, "LightBlock");
+		if (index != GL_INVALID_INDEX)
+		{
+			glUniformBlockBinding(program, index, LIGHT_BLOCK_BINDING);
+		}
+	}
+
+private:
+	GLuint ubo;
+
+	LightBuffer(const LightBuffer&);
+	LightBuffer& operator=(const LightBuffer&);
+
+	static PackedLight Make(LightType type, glm::vec3 position, glm::vec3 direction, glm::vec3 ambient, glm::vec3 diffuse, glm::vec3 specular)
+	{
+		PackedLight light;
+		light.position = glm::vec4(position, (GLfloat)type);
+		light.direction = glm::vec4(direction, 0.0f);
+		light.ambient = glm::vec4(ambient, 0.0f);
+		light.diffuse = glm::vec4(diffuse, 0.0f);
+		light.specular = glm::vec4(specular, 0.0f);
+		light.attenuation = glm::vec4(1.0f, 0.0f, 0.0f, 1.0f);
+		light.cone = glm::vec4(0.0f);
+		return light;
+	}
+};
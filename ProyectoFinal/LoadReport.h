@@ -0,0 +1,386 @@
+#pragma once
+
+// Std. Includes
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+
+// GL Includes
+#include <GL/glew.h>
+
+#include <assimp/DefaultIOSystem.h>
+#include <assimp/IOStream.hpp>
+
+// Desglose del tiempo de carga de los recursos (--load-report <ruta.json>). Cada modelo, o textura suelta, es
+// un recurso abierto con LoadReport::Asset; los cargadores encierran sus etapas con LoadReport::Stage:
+//  - leer: bytes del disco (Assimp lee el modelo y sus materiales por LoadReportIOSystem; las imgenes se
+//    leen completas antes de decodificarlas)
+//  - parseo y post-proceso de Assimp (ReadFile sin pasos y luego ApplyPostProcessing)
+//  - conversin de los vrtices de Assimp a los de Mesh en processMesh
+//  - decodificacin de imgenes con stbi, subida a OpenGL y generacin de mipmaps
+// Las etapas anidadas se restan de la de afuera (una textura cargada dentro de processMesh no cuenta como
+// conversin) y lo que no cae en ninguna sale como "otros". Las etapas de OpenGL terminan con glFinish para
+// medir el trabajo del driver y no solo el envo. Sin Enable() las clases no hacen nada; solo desde el hilo de render
+class LoadReport
+{
+public:
+	enum StageId { READ, PARSE, POST_PROCESS, CONVERT, DECODE, UPLOAD, MIPMAPS, STAGES };
+
+	struct TextureInfo
+	{
+		std::string path;
+		int width = 0, height = 0, components = 0;
+		size_t bytesRead = 0;
+		double stageMs[STAGES] = {};
+	};
+
+	struct Entry
+	{
+		std::string path;
+		std::string kind;            // "modelo", "modelo animado", "textura", "cubemap"
+		double totalMs = 0.0;
+		double stageMs[STAGES] = {};
+		size_t bytesRead = 0;
+		size_t meshes = 0, vertices = 0, indices = 0;
+		std::vector<TextureInfo> textures;
+
+		double OtherMs() const
+		{
+			double staged = 0.0;
+			for (int i = 0; i < STAGES; i++)
+				staged += this->stageMs[i];
+			return std::max(this->totalMs - staged, 0.0);
+		}
+	};
+
+	static const char* StageName(int stage)
+	{
+		static const char* names[STAGES] = { "leer", "parseo", "post-proceso", "vertices", "decodificar", "subida", "mipmaps" };
+		return names[stage];
+	}
+
+	// Con false (por omisin) Asset, Stage y los contadores no registran nada
+	static void Enable(bool enabled)
+	{
+		GetState().enabled = enabled;
+	}
+
+	static bool Enabled()
+	{
+		return GetState().enabled;
+	}
+
+	// Un recurso mientras vive el objeto; si ya hay uno abierto (las texturas de un modelo) se suma a ese
+	class Asset
+	{
+	public:
+		Asset(const std::string& path, const char* kind) : owner(false)
+		{
+			State& state = GetState();
+			if (!state.enabled || state.open)
+				return;
+			Entry entry;
+			entry.path = path;
+			entry.kind = kind;
+			state.entries.push_back(entry);
+			state.open = true;
+			state.stagedMs = 0.0;
+			this->owner = true;
+			this->start = std::chrono::steady_clock::now();
+		}
+
+		~Asset()
+		{
+			if (!this->owner)
+				return;
+			State& state = GetState();
+			state.entries.back().totalMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - this->start).count();
+			state.open = false;
+			state.texture = -1;
+		}
+
+	private:
+		bool owner;
+		std::chrono::steady_clock::time_point start;
+
+		Asset(const Asset&);
+		Asset& operator=(const Asset&);
+	};
+
+	// Una etapa del recurso abierto. gpu: la etapa enva trabajo a OpenGL y se espera con glFinish al terminar
+	class Stage
+	{
+	public:
+		Stage(StageId id, bool gpu = false) : id(id), gpu(gpu), active(Current() != NULL)
+		{
+			if (!this->active)
+				return;
+			this->stagedBefore = GetState().stagedMs;
+			this->start = std::chrono::steady_clock::now();
+		}
+
+		~Stage()
+		{
+			if (!this->active)
+				return;
+			if (this->gpu)
+				glFinish();
+			State& state = GetState();
+			double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - this->start).count();
+			double own = std::max(elapsed - (state.stagedMs - this->stagedBefore), 0.0);  // sin las etapas anidadas
+			state.stagedMs += own;
+			state.entries.back().stageMs[this->id] += own;
+			if (state.texture >= 0)
+				state.entries.back().textures[state.texture].stageMs[this->id] += own;
+		}
+
+	private:
+		StageId id;
+		bool gpu;
+		bool active;
+		double stagedBefore;
+		std::chrono::steady_clock::time_point start;
+
+		Stage(const Stage&);
+		Stage& operator=(const Stage&);
+	};
+
+	// Mientras vive, las etapas y los bytes tambin se anotan en esta textura del recurso abierto
+	class Texture
+	{
+	public:
+		Texture(const std::string& path) : active(Current() != NULL)
+		{
+			if (!this->active)
+				return;
+			State& state = GetState();
+			TextureInfo info;
+			info.path = path;
+			state.entries.back().textures.push_back(info);
+			state.texture = (int)state.entries.back().textures.size() - 1;
+		}
+
+		~Texture()
+		{
+			if (this->active)
+				GetState().texture = -1;
+		}
+
+		void SetSize(int width, int height, int components)
+		{
+			if (!this->active)
+				return;
+			TextureInfo& info = GetState().entries.back().textures.back();
+			info.width = width;
+			info.height = height;
+			info.components = components;
+		}
+
+	private:
+		bool active;
+
+		Texture(const Texture&);
+		Texture& operator=(const Texture&);
+	};
+
+	// El recurso abierto, o NULL si no hay ninguno o el reporte est apagado
+	static Entry* Current()
+	{
+		State& state = GetState();
+		return state.enabled && state.open ? &state.entries.back() : NULL;
+	}
+
+	static void AddBytes(size_t bytes)
+	{
+		Entry* entry = Current();
+		if (entry == NULL)
+			return;
+		entry->bytesRead += bytes;
+		if (GetState().texture >= 0)
+			entry->textures[GetState().texture].bytesRead += bytes;
+	}
+
+	static void AddMesh(size_t vertices, size_t indices)
+	{
+		Entry* entry = Current();
+		if (entry == NULL)
+			return;
+		entry->meshes++;
+		entry->vertices += vertices;
+		entry->indices += indices;
+	}
+
+	static const std::vector<Entry>& Entries()
+	{
+		return GetState().entries;
+	}
+
+	// Recursos de mayor a menor tiempo total, una fila de totales y la etapa que ms pesa en toda la carga
+	static void PrintTable()
+	{
+		std::vector<Entry> sorted = Entries();
+		std::sort(sorted.begin(), sorted.end(), [](const Entry& a, const Entry& b) { return a.totalMs > b.totalMs; });
+
+		Entry total;
+		total.path = "total";
+		for (size_t i = 0; i < sorted.size(); i++)
+		{
+			total.totalMs += sorted[i].totalMs;
+			for (int s = 0; s < STAGES; s++)
+				total.stageMs[s] += sorted[i].stageMs[s];
+			total.bytesRead += sorted[i].bytesRead;
+			total.meshes += sorted[i].meshes;
+			total.vertices += sorted[i].vertices;
+			total.indices += sorted[i].indices;
+			total.textures.insert(total.textures.end(), sorted[i].textures.begin(), sorted[i].textures.end());
+		}
+
+		std::cout << std::endl << "Carga de recursos (ms, " << sorted.size() << " recursos)" << std::endl;
+		std::cout << std::left << std::setw(40) << "recurso" << std::right << std::setw(9) << "total";
+		for (int s = 0; s < STAGES; s++)
+			std::cout << std::setw(13) << StageName(s);
+		std::cout << std::setw(9) << "otros" << std::setw(9) << "MB" << std::setw(10) << "vertices" << std::setw(10) << "indices"
+			<< std::setw(6) << "tex" << std::endl;
+		for (size_t i = 0; i < sorted.size(); i++)
+			PrintRow(sorted[i]);
+		PrintRow(total);
+
+		if (total.totalMs <= 0.0)
+			return;
+		int top = 0;
+		for (int s = 1; s < STAGES; s++)
+			if (total.stageMs[s] > total.stageMs[top])
+				top = s;
+		std::cout << "Etapa mas cara: " << StageName(top) << " (" << std::setprecision(1) << 100.0 * total.stageMs[top] / total.totalMs
+			<< "% de " << std::setprecision(1) << total.totalMs << " ms)" << std::endl;
+	}
+
+	// Un objeto por recurso, en el orden de carga, con sus etapas y sus texturas; false si no se pudo escribir
+	static bool WriteJson(const std::string& path)
+	{
+		std::ofstream file(path.c_str());
+		if (!file)
+		{
+			std::cout << "ERROR::LOAD_REPORT:: no se pudo escribir " << path << std::endl;
+			return false;
+		}
+
+		const std::vector<Entry>& entries = Entries();
+		file << "{\"assets\":[" << std::fixed << std::setprecision(3);
+		for (size_t i = 0; i < entries.size(); i++)
+		{
+			const Entry& entry = entries[i];
+			file << (i > 0 ? ",\n" : "\n") << "{\"path\":\"" << Escape(entry.path) << "\",\"kind\":\"" << entry.kind
+				<< "\",\"total_ms\":" << entry.totalMs;
+			WriteStages(file, entry.stageMs);
+			file << ",\"other_ms\":" << entry.OtherMs() << ",\"bytes_read\":" << entry.bytesRead << ",\"meshes\":" << entry.meshes
+				<< ",\"vertices\":" << entry.vertices << ",\"indices\":" << entry.indices << ",\"textures\":[";
+			for (size_t t = 0; t < entry.textures.size(); t++)
+			{
+				const TextureInfo& texture = entry.textures[t];
+				file << (t > 0 ? "," : "") << "{\"path\":\"" << Escape(texture.path) << "\",\"width\":" << texture.width
+					<< ",\"height\":" << texture.height << ",\"components\":" << texture.components << ",\"bytes_read\":" << texture.bytesRead;
+				WriteStages(file, texture.stageMs);
+				file << "}";
+			}
+			file << "]}";
+		}
+		file << "\n]}" << std::endl;
+		std::cout << "Reporte de carga: " << path << std::endl;
+		return true;
+	}
+
+private:
+	struct State
+	{
+		bool enabled = false;
+		bool open = false;
+		int texture = -1;        // textura abierta en el recurso actual
+		double stagedMs = 0.0;   // suma de las etapas del recurso actual, para descontar las anidadas
+		std::vector<Entry> entries;
+	};
+
+	static State& GetState()
+	{
+		static State state;
+		return state;
+	}
+
+	static void PrintRow(const Entry& entry)
+	{
+		std::string name = entry.path.size() > 38 ? "..." + entry.path.substr(entry.path.size() - 35) : entry.path;
+		std::cout << std::left << std::setw(40) << name << std::right << std::fixed << std::setprecision(1) << std::setw(9) << entry.totalMs;
+		for (int s = 0; s < STAGES; s++)
+			std::cout << std::setw(13) << entry.stageMs[s];
+		std::cout << std::setw(9) << entry.OtherMs() << std::setw(9) << std::setprecision(2) << entry.bytesRead / (1024.0 * 1024.0)
+			<< std::setw(10) << entry.vertices << std::setw(10) << entry.indices << std::setw(6) << entry.textures.size() << std::endl;
+	}
+
+	static void WriteStages(std::ostream& out, const double* stageMs)
+	{
+		static const char* keys[STAGES] = { "read_ms", "parse_ms", "post_process_ms", "convert_ms", "decode_ms", "upload_ms", "mipmaps_ms" };
+		for (int s = 0; s < STAGES; s++)
+			out << ",\"" << keys[s] << "\":" << stageMs[s];
+	}
+
+	static std::string Escape(const std::string& text)
+	{
+		std::string escaped;
+		for (size_t i = 0; i < text.size(); i++)
+		{
+			if (text[i] == '"' || text[i] == '\\')
+				escaped += '\\';
+			escaped += text[i];
+		}
+		return escaped;
+	}
+};
+
+// Archivo abierto por Assimp cuyas lecturas cuentan como la etapa "leer" del recurso abierto
+class LoadReportIOStream : public Assimp::IOStream
+{
+public:
+	LoadReportIOStream(Assimp::IOStream* file) : file(file) {}
+
+	~LoadReportIOStream()
+	{
+		delete this->file;
+	}
+
+	size_t Read(void* buffer, size_t size, size_t count)
+	{
+		LoadReport::Stage stage(LoadReport::READ);
+		size_t read = this->file->Read(buffer, size, count);
+		LoadReport::AddBytes(read * size);
+		return read;
+	}
+
+	size_t Write(const void* buffer, size_t size, size_t count) { return this->file->Write(buffer, size, count); }
+	aiReturn Seek(size_t offset, aiOrigin origin) { return this->file->Seek(offset, origin); }
+	size_t Tell() const { return this->file->Tell(); }
+	size_t FileSize() const { return this->file->FileSize(); }
+	void Flush() { this->file->Flush(); }
+
+private:
+	Assimp::IOStream* file;
+
+	LoadReportIOStream(const LoadReportIOStream&);
+	LoadReportIOStream& operator=(const LoadReportIOStream&);
+};
+
+// Sistema de archivos de Assimp para el reporte: el de siempre, con las lecturas medidas. El Importer lo
+// libera (SetIOHandler toma el puntero); Close de IOSystem borra el envoltorio y este al archivo
+class LoadReportIOSystem : public Assimp::DefaultIOSystem
+{
+public:
+	Assimp::IOStream* Open(const char* file, const char* mode = "rb")
+	{
+		LoadReport::Stage stage(LoadReport::READ);
+		Assimp::IOStream* opened = Assimp::DefaultIOSystem::Open(file, mode);
+		return opened != NULL ? new LoadReportIOStream(opened) : NULL;
+	}
+};
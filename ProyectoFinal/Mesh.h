@@ -6,7 +6,9 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
-#include "shader.h"
+#include "Shader.h"
+#include "Profiler.h"
+#include "RenderStats.h"
 
 #include <string>
 #include <fstream>
@@ -28,10 +30,18 @@ struct Vertex {
     glm::vec3 Bitangent;
 };
 
+// how a mesh has to be rendered, decided at load time from texture alpha and material opacity
+enum AlphaMode {
+    ALPHA_OPAQUE = 0,   // no transparency: depth pre-pass + equal-depth shading
+    ALPHA_TESTED = 1,   // binary alpha (cut-outs): shader variant with discard
+    ALPHA_BLENDED = 2   // translucent: blended last, sorted back-to-front
+};
+
 struct Texture {
     unsigned int id;
     string type;
     string path;
+    AlphaMode alphaMode = ALPHA_OPAQUE;
 };
 
 class Mesh {
@@ -41,14 +51,20 @@ public:
     vector<unsigned int> indices;
     vector<Texture> textures;
     unsigned int VAO;
+    AlphaMode alphaMode;
+    // object space bounding box
+    glm::vec3 boundsMin, boundsMax;
 
     /*  Functions  */
     // constructor
-    Mesh(vector<Vertex> vertices, vector<unsigned int> indices, vector<Texture> textures)
+    Mesh(vector<Vertex> vertices, vector<unsigned int> indices, vector<Texture> textures, AlphaMode alphaMode = ALPHA_OPAQUE)
     {
         this->vertices = vertices;
         this->indices = indices;
         this->textures = textures;
+        this->alphaMode = alphaMode;
+
+        computeBounds();
 
         // now that we have all the required data, set the vertex buffers and its attribute pointers.
         setupMesh();
@@ -57,6 +73,7 @@ public:
     // render the mesh
     void Draw(Shader shader) 
     {
+        PROFILE_SCOPE("Mesh::Draw");
         // bind appropriate textures
         unsigned int diffuseNr  = 1;
         unsigned int specularNr = 1;
@@ -78,14 +95,14 @@ public:
                 number = std::to_string(heightNr++); // transfer unsigned int to stream
 
             // now set the sampler to the correct texture unit
-            glUniform1i(glGetUniformLocation(shader.Program, (name + number).c_str()), i);    // AQUI ES DONDE SE ASIGNAN LOS UNIFORM A LOS SHADERS AHHHHHHHHHHHH
+            RenderStats::Uniform1i(glGetUniformLocation(shader.Program, (name + number).c_str()), i);    // AQUI ES DONDE SE ASIGNAN LOS UNIFORM A LOS SHADERS AHHHHHHHHHHHH
             // and finally bind the texture
-            glBindTexture(GL_TEXTURE_2D, textures[i].id);
+            RenderStats::BindTexture(GL_TEXTURE_2D, textures[i].id);
         }
         
         // draw mesh
-        glBindVertexArray(VAO);
-        glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
+        RenderStats::BindVertexArray(VAO);
+        RenderStats::DrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
         glBindVertexArray(0);
 
         // always good practice to set everything back to defaults once configured.
@@ -97,6 +114,16 @@ private:
     unsigned int VBO, EBO;
 
     /*  Functions    */
+    void computeBounds()
+    {
+        boundsMin = boundsMax = vertices.empty() ? glm::vec3(0.0f) : vertices[0].Position;
+        for (unsigned int i = 1; i < vertices.size(); i++)
+        {
+            boundsMin = glm::min(boundsMin, vertices[i].Position);
+            boundsMax = glm::max(boundsMax, vertices[i].Position);
+        }
+    }
+
     // initializes all the buffer objects/arrays
     void setupMesh()
     {
@@ -115,6 +142,7 @@ private:
 
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
         glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
+        RenderStats::TrackBufferMemory(vertices.size() * sizeof(Vertex) + indices.size() * sizeof(unsigned int));
 
         // set the vertex attribute pointers
         // vertex Positions
@@ -0,0 +1,209 @@
+#pragma once
+
+// Std. Includes
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+
+// Arns de los microbenchmarks de CPU (Microbenchmarks.cpp). Cada caso es una funcin que hace un lote de
+// `items` operaciones (vrtices convertidos, bsquedas, esferas, ...) y devuelve un valor que depende del
+// trabajo: se suma a un sumidero volatile para que el compilador no lo descarte.
+//  - Calibracin: un lote sin medir y otro medido deciden cuntos lotes caben en una repeticin de al menos
+//    minRepMs, as los casos rpidos no quedan por debajo de la resolucin del reloj.
+//  - warmup repeticiones sin medir (cachs, predictor, frecuencia del procesador) y luego repetitions medidas.
+//  - Cada repeticin da ns por operacin; el resultado es la mediana y la MAD (mediana de las desviaciones
+//    absolutas a la mediana), que no se mueven por unas pocas repeticiones interrumpidas por el sistema.
+// WriteJson guarda las muestras y la compilacin para comparar dos builds con los mismos casos
+class Microbenchmark
+{
+public:
+	struct Result
+	{
+		std::string name;
+		std::string unit;              // qu es una operacin: "vertex", "lookup", ...
+		size_t items = 0;              // operaciones por lote
+		unsigned int batches = 0;      // lotes por repeticin
+		std::vector<double> samples;   // ns por operacin de cada repeticin
+		double median = 0.0;
+		double mad = 0.0;
+		double min = 0.0;
+		double max = 0.0;
+	};
+
+	unsigned int warmup;
+	unsigned int repetitions;
+	double minRepMs;
+	std::string filter;  // si no est vaco, solo los casos cuyo nombre lo contiene
+
+	Microbenchmark(unsigned int warmup = 3, unsigned int repetitions = 21, double minRepMs = 10.0)
+		: warmup(warmup), repetitions(repetitions), minRepMs(minRepMs), sink(0.0)
+	{
+	}
+
+	bool Enabled(const std::string& name) const
+	{
+		return this->filter.empty() || name.find(this->filter) != std::string::npos;
+	}
+
+	// Contexto del JSON: modelo usado, tamaos de los datos, ...
+	void Note(const std::string& key, const std::string& value)
+	{
+		this->notes[key] = value;
+	}
+
+	template <typename Body>
+	void Run(const std::string& name, const std::string& unit, size_t items, Body body)
+	{
+		if (!Enabled(name) || items == 0)
+			return;
+
+		Result result;
+		result.name = name;
+		result.unit = unit;
+		result.items = items;
+
+		this->sink += (double)body();
+		double batchNs = std::max(TimeBatches(body, 1), 1.0);
+		result.batches = (unsigned int)std::max(1.0, std::ceil(this->minRepMs * 1.0e6 / batchNs));
+
+		for (unsigned int i = 0; i < this->warmup; i++)
+			TimeBatches(body, result.batches);
+		for (unsigned int i = 0; i < std::max(this->repetitions, 1u); i++)
+			result.samples.push_back(TimeBatches(body, result.batches) / ((double)result.batches * items));
+
+		std::vector<double> sorted(result.samples);
+		result.median = Median(sorted);
+		result.min = sorted.front();
+		result.max = sorted.back();
+		std::vector<double> deviations;
+		for (size_t i = 0; i < sorted.size(); i++)
+			deviations.push_back(std::fabs(sorted[i] - result.median));
+		result.mad = Median(deviations);
+
+		PrintRow(result);
+		this->results.push_back(result);
+	}
+
+	void PrintHeader() const
+	{
+		std::cout << std::endl << "Microbenchmarks (" << this->warmup << " de calentamiento, " << this->repetitions
+			<< " repeticiones de al menos " << this->minRepMs << " ms)" << std::endl;
+		std::cout << std::left << std::setw(40) << "caso" << std::setw(10) << "unidad" << std::right << std::setw(12) << "ns mediana"
+			<< std::setw(10) << "MAD" << std::setw(8) << "MAD %" << std::setw(12) << "min" << std::setw(14) << "Mops/s" << std::endl;
+	}
+
+	const std::vector<Result>& Results() const
+	{
+		return this->results;
+	}
+
+	bool WriteJson(const std::string& path) const
+	{
+		std::ofstream file(path.c_str());
+		if (!file)
+		{
+			std::cout << "ERROR::MICROBENCHMARK:: no se pudo escribir " << path << std::endl;
+			return false;
+		}
+
+		file << "{\n  \"build\": {\"compiler\": \"" << Escape(Compiler()) << "\", \"optimized\": "
+#ifdef NDEBUG
+			<< "true"
+#else
+			<< "false"
+#endif
+			<< ", \"profiler\": "
+#ifdef ENABLE_PROFILER
+			<< "true"
+#else
+			<< "false"
+#endif
+			<< "},\n";
+		file << "  \"warmup\": " << this->warmup << ",\n  \"repetitions\": " << this->repetitions << ",\n  \"min_rep_ms\": "
+			<< this->minRepMs << ",\n  \"notes\": {";
+		for (std::map<std::string, std::string>::const_iterator it = this->notes.begin(); it != this->notes.end(); ++it)
+			file << (it == this->notes.begin() ? "" : ", ") << "\"" << Escape(it->first) << "\": \"" << Escape(it->second) << "\"";
+		file << "},\n  \"benchmarks\": [" << std::setprecision(6);
+		for (size_t i = 0; i < this->results.size(); i++)
+		{
+			const Result& result = this->results[i];
+			file << (i > 0 ? ",\n" : "\n") << "    {\"name\": \"" << Escape(result.name) << "\", \"unit\": \"ns/" << result.unit
+				<< "\", \"items\": " << result.items << ", \"batches\": " << result.batches << ", \"median\": " << result.median
+				<< ", \"mad\": " << result.mad << ", \"min\": " << result.min << ", \"max\": " << result.max << ", \"samples\": [";
+			for (size_t s = 0; s < result.samples.size(); s++)
+				file << (s > 0 ? ", " : "") << result.samples[s];
+			file << "]}";
+		}
+		file << "\n  ]\n}" << std::endl;
+		std::cout << "Microbenchmarks: " << this->results.size() << " casos -> " << path << std::endl;
+		return true;
+	}
+
+private:
+	std::vector<Result> results;
+	std::map<std::string, std::string> notes;
+	volatile double sink;
+
+	Microbenchmark(const Microbenchmark&);
+	Microbenchmark& operator=(const Microbenchmark&);
+
+	// ns de pared de batches lotes seguidos
+	template <typename Body>
+	double TimeBatches(Body& body, unsigned int batches)
+	{
+		double accumulated = 0.0;
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (unsigned int i = 0; i < batches; i++)
+			accumulated += (double)body();
+		std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+		this->sink += accumulated;
+		return elapsed.count();
+	}
+
+	// Ordena values
+	static double Median(std::vector<double>& values)
+	{
+		std::sort(values.begin(), values.end());
+		size_t half = values.size() / 2;
+		return values.size() % 2 == 1 ? values[half] : 0.5 * (values[half - 1] + values[half]);
+	}
+
+	static void PrintRow(const Result& result)
+	{
+		std::cout << std::left << std::setw(40) << result.name << std::setw(10) << result.unit << std::right << std::fixed
+			<< std::setprecision(2) << std::setw(12) << result.median << std::setw(10) << result.mad << std::setprecision(1)
+			<< std::setw(8) << (result.median > 0.0 ? 100.0 * result.mad / result.median : 0.0) << std::setprecision(2)
+			<< std::setw(12) << result.min << std::setw(14) << (result.median > 0.0 ? 1.0e3 / result.median : 0.0) << std::endl;
+	}
+
+	static std::string Compiler()
+	{
+#if defined(_MSC_VER)
+		return "MSVC " + std::to_string(_MSC_VER);
+#elif defined(__clang__)
+		return "clang " __clang_version__;
+#elif defined(__GNUC__)
+		return "gcc " __VERSION__;
+#else
+		return "desconocido";
+#endif
+	}
+
+	static std::string Escape(const std::string& text)
+	{
+		std::string escaped;
+		for (size_t i = 0; i < text.size(); i++)
+		{
+			if (text[i] == '"' || text[i] == '\\')
+				escaped += '\\';
+			escaped += text[i];
+		}
+		return escaped;
+	}
+};
@@ -0,0 +1,370 @@
+// Microbenchmarks de CPU del motor, sin ventana: un ejecutable aparte (objetivo Microbenchmarks de CMake)
+// con casos repetibles de las rutas calientes de la carga y del frame. Los datos son sintticos con semilla
+// fija; solo los casos del esqueleto necesitan un modelo animado (--anim-model). Las mallas de prueba del
+// orden de transparentes y el modelo animado suben buffers, as que se crea un contexto de HeadlessContext;
+// si no se puede, esos casos se omiten y el resto corre igual.
+//
+//   Microbenchmarks [--json <ruta>] [--reps <n>] [--warmup <n>] [--min-rep-ms <ms>] [--filter <texto>]
+//                   [--anim-model <ruta>]
+//
+// El JSON (por omisin microbenchmarks.json) guarda mediana, MAD y muestras de cada caso para comparar builds.
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cmath>
+
+// GLEW
+#include <GL/glew.h>
+
+// Other Libs
+#include "stb_image.h"
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "Model.h"
+#include "modelAnim.h"
+#include "AnimationClip.h"
+#include "RenderQueue.h"
+#include "Frustum.h"
+#include "HeadlessContext.h"
+#include "Microbenchmark.h"
+
+// Los casos; miden las funciones del motor (Model, ModelAnim, RenderQueue) y no copias de ellas
+class MicrobenchmarkSuite
+{
+public:
+	MicrobenchmarkSuite(Microbenchmark& bench, bool gl) : bench(bench), gl(gl), random(1)
+	{
+	}
+
+	void Run(const std::string& animModel)
+	{
+		ConvertMesh();
+		TextureLookup();
+		KeyLookup();
+		FrustumCulling();
+		MatrixComposition();
+		if (this->gl)
+			BlendedSort();
+		if (this->gl && !animModel.empty())
+			Skeleton(animModel);
+	}
+
+private:
+	Microbenchmark& bench;
+	bool gl;
+	std::mt19937 random;
+
+	MicrobenchmarkSuite(const MicrobenchmarkSuite&);
+	MicrobenchmarkSuite& operator=(const MicrobenchmarkSuite&);
+
+	float Uniform(float low, float high)
+	{
+		return std::uniform_real_distribution<float>(low, high)(this->random);
+	}
+
+	// Model::processMesh sin materiales ni subida: una rejilla de 256 x 256 vrtices con normales y UV
+	void ConvertMesh()
+	{
+		const unsigned int side = 256;
+		aiMesh mesh;
+		mesh.mNumVertices = side * side;
+		mesh.mVertices = new aiVector3D[mesh.mNumVertices];
+		mesh.mNormals = new aiVector3D[mesh.mNumVertices];
+		mesh.mTextureCoords[0] = new aiVector3D[mesh.mNumVertices];
+		mesh.mNumUVComponents[0] = 2;
+		for (unsigned int y = 0; y < side; y++)
+		{
+			for (unsigned int x = 0; x < side; x++)
+			{
+				unsigned int i = y * side + x;
+				mesh.mVertices[i] = aiVector3D((float)x, Uniform(-0.5f, 0.5f), (float)y);
+				mesh.mNormals[i] = aiVector3D(0.0f, 1.0f, 0.0f);
+				mesh.mTextureCoords[0][i] = aiVector3D(x / (float)side, y / (float)side, 0.0f);
+			}
+		}
+		mesh.mNumFaces = (side - 1) * (side - 1) * 2;
+		mesh.mFaces = new aiFace[mesh.mNumFaces];
+		for (unsigned int y = 0, f = 0; y + 1 < side; y++)
+		{
+			for (unsigned int x = 0; x + 1 < side; x++)
+			{
+				unsigned int corner = y * side + x;
+				const unsigned int triangles[2][3] = { { corner, corner + side, corner + 1 }, { corner + 1, corner + side, corner + side + 1 } };
+				for (unsigned int t = 0; t < 2; t++, f++)
+				{
+					mesh.mFaces[f].mNumIndices = 3;
+					mesh.mFaces[f].mIndices = new unsigned int[3];
+					std::copy(triangles[t], triangles[t] + 3, mesh.mFaces[f].mIndices);
+				}
+			}
+		}
+		this->bench.Note("convert_vertices", std::to_string(mesh.mNumVertices));
+
+		// Vectores nuevos en cada lote, como en processMesh
+		this->bench.Run("Model::convertMesh", "vertex", mesh.mNumVertices, [&mesh]()
+		{
+			vector<Vertex> vertices;
+			vector<unsigned int> indices;
+			Model::convertMesh(&mesh, vertices, indices);
+			return vertices.size() + indices.back();
+		});
+	}
+
+	// Cach de texturas de un modelo (loadMaterialTextures): rutas con un prefijo comn, aciertos y fallos
+	void TextureLookup()
+	{
+		const unsigned int textures = 48;
+		Model model;
+		for (unsigned int i = 0; i < textures; i++)
+		{
+			char path[64];
+			std::snprintf(path, sizeof(path), "texturas/material_%02u_diffuse.png", i);
+			Texture texture;
+			texture.id = i;
+			texture.type = "texture_diffuse";
+			texture.path = path;
+			model.textures_loaded.push_back(texture);
+		}
+
+		std::vector<std::string> hits, misses;
+		for (unsigned int i = 0; i < 1024; i++)
+		{
+			hits.push_back(model.textures_loaded[this->random() % textures].path);
+			misses.push_back(hits.back().substr(0, hits.back().size() - 4) + ".jpg");
+		}
+		this->bench.Note("texture_cache_entries", std::to_string(textures));
+
+		this->bench.Run("FindLoadedTexture/hit", "lookup", hits.size(), [&model, &hits]()
+		{
+			int found = 0;
+			for (size_t i = 0; i < hits.size(); i++)
+				found += FindLoadedTexture(model.textures_loaded, hits[i].c_str());
+			return found;
+		});
+		this->bench.Run("FindLoadedTexture/miss", "lookup", misses.size(), [&model, &misses]()
+		{
+			int found = 0;
+			for (size_t i = 0; i < misses.size(); i++)
+				found += FindLoadedTexture(model.textures_loaded, misses[i].c_str());
+			return found;
+		});
+	}
+
+	// findKey sobre una pista de 512 claves con los tiempos de Assimp (double) y en punto fijo de 16 bits:
+	// reproduccin a 60 fps con el cursor de la pista y los mismos instantes en desorden (bsqueda binaria)
+	void KeyLookup()
+	{
+		const unsigned int keys = 512;
+		const float duration = 512.0f;
+		std::vector<aiVectorKey> sourceKeys(keys);
+		std::vector<uint16_t> fixedKeys(keys);
+		for (unsigned int i = 0; i < keys; i++)
+		{
+			sourceKeys[i].mTime = i * duration / (keys - 1);
+			fixedKeys[i] = (uint16_t)(i * 65535u / (keys - 1));
+		}
+
+		std::vector<float> playback;
+		for (float time = 0.0f; time < duration; time += 0.4f)
+			playback.push_back(time);
+		std::vector<float> seeks(playback);
+		std::shuffle(seeks.begin(), seeks.end(), this->random);
+		std::vector<float> fixedPlayback(playback), fixedSeeks(seeks);
+		for (size_t i = 0; i < playback.size(); i++)
+		{
+			fixedPlayback[i] = playback[i] * 65535.0f / duration;
+			fixedSeeks[i] = seeks[i] * 65535.0f / duration;
+		}
+		this->bench.Note("keyframes", std::to_string(keys));
+
+		RunKeyLookup("findKey/aiVectorKey/playback", &sourceKeys[0], keys, playback);
+		RunKeyLookup("findKey/aiVectorKey/seek", &sourceKeys[0], keys, seeks);
+		RunKeyLookup("findKey/fixed16/playback", &fixedKeys[0], keys, fixedPlayback);
+		RunKeyLookup("findKey/fixed16/seek", &fixedKeys[0], keys, fixedSeeks);
+	}
+
+	template <typename KeyType>
+	void RunKeyLookup(const std::string& name, const KeyType* keys, unsigned int numKeys, const std::vector<float>& times)
+	{
+		this->bench.Run(name, "lookup", times.size(), [keys, numKeys, &times]()
+		{
+			unsigned int cursor = 0, sum = 0;
+			for (size_t i = 0; i < times.size(); i++)
+				sum += findKey(times[i], keys, numKeys, cursor);
+			return sum;
+		});
+	}
+
+	// Esferas repartidas alrededor de la cmara contra el frustum de una proyeccin de 45 grados
+	void FrustumCulling()
+	{
+		const unsigned int spheres = 10000;
+		std::vector<glm::vec4> bounds(spheres);
+		for (unsigned int i = 0; i < spheres; i++)
+		{
+			bounds[i].x = Uniform(-100.0f, 100.0f);
+			bounds[i].y = Uniform(-20.0f, 20.0f);
+			bounds[i].z = Uniform(-100.0f, 100.0f);
+			bounds[i].w = Uniform(0.5f, 3.0f);
+		}
+		glm::mat4 viewProjection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 100.0f)
+			* glm::lookAt(glm::vec3(0.0f, 2.0f, 10.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+		this->bench.Note("frustum_spheres", std::to_string(spheres));
+
+		this->bench.Run("Frustum::IntersectsSphere", "sphere", spheres, [&bounds, &viewProjection]()
+		{
+			Frustum frustum;
+			frustum.Extract(viewProjection);
+			unsigned int visible = 0;
+			for (size_t i = 0; i < bounds.size(); i++)
+				visible += frustum.IntersectsSphere(glm::vec3(bounds[i]), bounds[i].w);
+			return visible;
+		});
+	}
+
+	// Matriz de modelo de cada objeto como en la escena (traslacin * rotacin * escala) y su matriz normal
+	void MatrixComposition()
+	{
+		const unsigned int objects = 4096;
+		std::vector<glm::vec4> placement(objects);
+		for (unsigned int i = 0; i < objects; i++)
+		{
+			placement[i].x = Uniform(-50.0f, 50.0f);
+			placement[i].y = Uniform(0.0f, 5.0f);
+			placement[i].z = Uniform(-50.0f, 50.0f);
+			placement[i].w = Uniform(0.0f, 360.0f);
+		}
+
+		this->bench.Run("RenderQueue::NormalMatrix/compose", "matrix", objects, [&placement]()
+		{
+			float sum = 0.0f;
+			for (size_t i = 0; i < placement.size(); i++)
+			{
+				glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(placement[i]));
+				model = glm::rotate(model, glm::radians(placement[i].w), glm::vec3(0.0f, 1.0f, 0.0f));
+				model = glm::scale(model, glm::vec3(1.5f));
+				glm::mat3 normal = RenderQueue::NormalMatrix(model);
+				sum += model[3][0] + normal[1][1];
+			}
+			return sum;
+		});
+	}
+
+	// Orden de atrs hacia adelante de DrawBlended: 512 objetos de un modelo con 8 mallas mezcladas
+	void BlendedSort()
+	{
+		const unsigned int objects = 512, meshes = 8;
+		Model model;
+		for (unsigned int m = 0; m < meshes; m++)
+		{
+			vector<Vertex> vertices(3);
+			vertices[0].Position = glm::vec3((float)m, 0.0f, 0.0f);
+			vertices[1].Position = glm::vec3(m + 1.0f, 0.0f, 0.0f);
+			vertices[2].Position = glm::vec3((float)m, 1.0f, 0.0f);
+			vector<unsigned int> indices = { 0, 1, 2 };
+			model.meshes.push_back(Mesh(vertices, indices, vector<Texture>(), ALPHA_BLENDED));
+		}
+
+		RenderQueue queue;
+		for (unsigned int i = 0; i < objects; i++)
+		{
+			glm::vec3 position(Uniform(-50.0f, 50.0f), 0.0f, 0.0f);
+			position.z = Uniform(-50.0f, 50.0f);
+			queue.Submit(model, glm::translate(glm::mat4(1.0f), position));
+		}
+		glm::vec3 cameraPos(0.0f, 2.0f, 10.0f);
+		this->bench.Note("blended_meshes", std::to_string(objects * meshes));
+
+		this->bench.Run("RenderQueue::SortBlended", "mesh", objects * meshes, [&queue, cameraPos]()
+		{
+			std::vector<RenderQueue::BlendedMesh> blended;
+			queue.SortBlended(cameraPos, blended);
+			return blended.front().mesh;
+		});
+	}
+
+	// Un esqueleto por operacin: el reproductor a 60 fps (boneTransform) y la ruta recursiva original sobre
+	// la escena de Assimp (readNodeHierarchy) en instantes repartidos a lo largo del clip
+	void Skeleton(const std::string& path)
+	{
+		ModelAnim model(path, false, 0.0f, true);
+		if (model.m_clips.empty())
+		{
+			std::cout << "Microbenchmarks: " << path << " no tiene esqueleto animado" << std::endl;
+			return;
+		}
+		this->bench.Note("anim_model", path);
+		this->bench.Note("anim_bones", std::to_string(model.m_num_bones));
+		this->bench.Note("anim_nodes", std::to_string(model.m_node_parent.size()));
+
+		double clock = 0.0;
+		model.m_clock = 0.0;
+		this->bench.Run("ModelAnim::boneTransform", "skeleton", 1, [&model, &clock]()
+		{
+			clock += 1.0 / 60.0;
+			model.boneTransform(clock);
+			return model.m_bone_matrices.empty() ? 0.0f : model.m_bone_matrices[0].final_world_transform.a4;
+		});
+
+		const aiAnimation* animation = model.scene->mAnimations[0];
+		unsigned int sample = 0;
+		this->bench.Run("ModelAnim::readNodeHierarchy", "skeleton", 1, [&model, animation, &sample]()
+		{
+			aiMatrix4x4 identity;
+			model.readNodeHierarchy((float)std::fmod(sample++ * 0.37, animation->mDuration), model.scene->mRootNode, identity);
+			return model.m_bone_matrices.empty() ? 0.0f : model.m_bone_matrices[0].final_world_transform.a4;
+		});
+	}
+};
+
+int main(int argc, char* argv[])
+{
+	Microbenchmark bench;
+	std::string jsonPath = "microbenchmarks.json";
+	std::string animModel;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		if (arg == "--json" && i + 1 < argc)
+			jsonPath = argv[++i];
+		else if (arg == "--reps" && i + 1 < argc)
+			bench.repetitions = (unsigned int)std::stoul(argv[++i]);
+		else if (arg == "--warmup" && i + 1 < argc)
+			bench.warmup = (unsigned int)std::stoul(argv[++i]);
+		else if (arg == "--min-rep-ms" && i + 1 < argc)
+			bench.minRepMs = std::stod(argv[++i]);
+		else if (arg == "--filter" && i + 1 < argc)
+			bench.filter = argv[++i];
+		else if (arg == "--anim-model" && i + 1 < argc)
+			animModel = argv[++i];
+		else
+		{
+			std::cout << "ERROR::MICROBENCHMARK:: argumento desconocido " << arg << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	// Contexto solo para los casos que crean mallas; los dems no tocan OpenGL
+	HeadlessContext context;
+	bool gl = context.Create();
+	if (gl)
+	{
+		glewExperimental = GL_TRUE;
+		gl = HeadlessContext::GlewReady(glewInit());
+	}
+	if (!gl)
+		std::cout << "Microbenchmarks: sin contexto de OpenGL, se omiten los casos con mallas" << std::endl;
+	else
+		bench.Note("renderer", (const char*)glGetString(GL_RENDERER));
+
+	bench.PrintHeader();
+	MicrobenchmarkSuite(bench, gl).Run(animModel);
+	std::cout << std::endl;
+	return bench.WriteJson(jsonPath) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -22,9 +22,15 @@
 
 
 
-#include "mesh.h"
+#include "Mesh.h"
 
-#include "shader.h"
+#include "Shader.h"
+
+#include "Profiler.h"
+
+#include "RenderStats.h"
+
+#include "LoadReport.h"
 
 
 
@@ -40,13 +46,17 @@
 
 #include <vector>
 
+#include <algorithm>
+
 //#include "stb_image.h"
 
 using namespace std;
 
 
 
-unsigned int TextureFromFile(const char* path, const string& directory, bool gamma = false);
+unsigned int TextureFromFile(const char* path, const string& directory, bool gamma = false, AlphaMode* alphaMode = nullptr);
+
+int FindLoadedTexture(const vector<Texture>& textures_loaded, const char* path);
 
 
 
@@ -82,117 +92,69 @@ public:
 
 
 
-    // draws the model, and thus all its meshes
+    // empty model, meshes are added by hand (procedural geometry, benchmarks)
 
-    void Draw(Shader shader)
+    Model() : gammaCorrection(false)
 
     {
 
-        for (unsigned int i = 0; i < meshes.size(); i++)
-
-            meshes[i].Draw(shader);
-
     }
 
 
 
-private:
-
-    /* Functions   */
-
-    // loads a model with supported ASSIMP extensions from file and stores the resulting meshes in the meshes vector.
+    // draws the model, and thus all its meshes
 
-    void loadModel(string const& path)
+    void Draw(Shader shader)
 
     {
 
-        // read file via ASSIMP
-
-        Assimp::Importer importer;
-
-        // MODIFICACION 1: Agregamos aiProcess_GenSmoothNormals para forzar calculo de normales
-
-        const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_CalcTangentSpace | aiProcess_GenSmoothNormals);
-
-
-
-        // check for errors
-
-        if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) // if is Not Zero
+        PROFILE_SCOPE("Model::Draw");
 
-        {
-
-            cout << "ERROR::ASSIMP:: " << importer.GetErrorString() << endl;
-
-            return;
-
-        }
-
-        // retrieve the directory path of the filepath
-
-        directory = path.substr(0, path.find_last_of('/'));
-
-
-
-        // process ASSIMP's root node recursively
+        for (unsigned int i = 0; i < meshes.size(); i++)
 
-        processNode(scene->mRootNode, scene);
+            meshes[i].Draw(shader);
 
     }
 
 
 
-    // processes a node in a recursive fashion. Processes each individual mesh located at the node and repeats this process on its children nodes (if any).
+    // draws only the meshes classified with the given alpha mode
 
-    void processNode(aiNode* node, const aiScene* scene)
+    void Draw(Shader shader, AlphaMode mode)
 
     {
 
-        // process each mesh located at the current node
-
-        for (unsigned int i = 0; i < node->mNumMeshes; i++)
-
-        {
+        PROFILE_SCOPE("Model::Draw");
 
-            // the node object only contains indices to index the actual objects in the scene. 
+        for (unsigned int i = 0; i < meshes.size(); i++)
 
-            // the scene contains all the data, node is just to keep stuff organized (like relations between nodes).
+            if (meshes[i].alphaMode == mode)
 
-            aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
+                meshes[i].Draw(shader);
 
-            meshes.push_back(processMesh(mesh, scene));
-
-        }
+    }
 
-        // after we've processed all of the meshes (if any) we then recursively process each of the children nodes
 
-        for (unsigned int i = 0; i < node->mNumChildren; i++)
 
-        {
+    // overrides the load time classification, e.g. glass that the scene wants blended
 
-            processNode(node->mChildren[i], scene);
+    void SetAlphaMode(AlphaMode mode)
 
-        }
+    {
 
+        for (unsigned int i = 0; i < meshes.size(); i++)
 
+            meshes[i].alphaMode = mode;
 
     }
 
 
 
-    Mesh processMesh(aiMesh* mesh, const aiScene* scene)
-
-    {
-
-        // data to fill
-
-        vector<Vertex> vertices;
-
-        vector<unsigned int> indices;
-
-        vector<Texture> textures;
+    // copies the vertices and indices of an assimp mesh into the engine layout (no materials, no GL)
 
+    static void convertMesh(const aiMesh* mesh, vector<Vertex>& vertices, vector<unsigned int>& indices)
 
+    {
 
         // Walk through each of the mesh's vertices
 
@@ -308,6 +270,142 @@ private:
 
         }
 
+    }
+
+
+
+private:
+
+
+
+    /* Functions   */
+
+    // loads a model with supported ASSIMP extensions from file and stores the resulting meshes in the meshes vector.
+
+    void loadModel(string const& path)
+
+    {
+
+        PROFILE_SCOPE("Model::loadModel");
+
+        LoadReport::Asset report(path, "modelo");
+
+        // read file via ASSIMP
+
+        Assimp::Importer importer;
+
+        if (LoadReport::Enabled())
+
+            importer.SetIOHandler(new LoadReportIOSystem());
+
+        // parse first and post-process afterwards, so the load report can tell both apart
+
+        const aiScene* scene = NULL;
+
+        {
+
+            LoadReport::Stage stage(LoadReport::PARSE);
+
+            scene = importer.ReadFile(path, 0);
+
+        }
+
+        // MODIFICACION 1: Agregamos aiProcess_GenSmoothNormals para forzar calculo de normales
+
+        if (scene)
+
+        {
+
+            LoadReport::Stage stage(LoadReport::POST_PROCESS);
+
+            scene = importer.ApplyPostProcessing(aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_CalcTangentSpace | aiProcess_GenSmoothNormals);
+
+        }
+
+
+
+        // check for errors
+
+        if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) // if is Not Zero
+
+        {
+
+            cout << "ERROR::ASSIMP:: " << importer.GetErrorString() << endl;
+
+            return;
+
+        }
+
+        // retrieve the directory path of the filepath
+
+        directory = path.substr(0, path.find_last_of('/'));
+
+
+
+        // process ASSIMP's root node recursively
+
+        processNode(scene->mRootNode, scene);
+
+    }
+
+
+
+    // processes a node in a recursive fashion. Processes each individual mesh located at the node and repeats this process on its children nodes (if any).
+
+    void processNode(aiNode* node, const aiScene* scene)
+
+    {
+
+        // process each mesh located at the current node
+
+        for (unsigned int i = 0; i < node->mNumMeshes; i++)
+
+        {
+
+            // the node object only contains indices to index the actual objects in the scene. 
+
+            // the scene contains all the data, node is just to keep stuff organized (like relations between nodes).
+
+            aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
+
+            meshes.push_back(processMesh(mesh, scene));
+
+        }
+
+        // after we've processed all of the meshes (if any) we then recursively process each of the children nodes
+
+        for (unsigned int i = 0; i < node->mNumChildren; i++)
+
+        {
+
+            processNode(node->mChildren[i], scene);
+
+        }
+
+
+
+    }
+
+
+
+    Mesh processMesh(aiMesh* mesh, const aiScene* scene)
+
+    {
+
+        LoadReport::Stage convert(LoadReport::CONVERT);
+
+        // data to fill
+
+        vector<Vertex> vertices;
+
+        vector<unsigned int> indices;
+
+        vector<Texture> textures;
+
+
+
+        convertMesh(mesh, vertices, indices);
+
         // process materials
 
         aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
@@ -352,9 +450,29 @@ private:
 
 
 
-        // return a mesh object created from the extracted mesh data
+        // classify the mesh: the alpha of its diffuse maps decides, a material with opacity < 1 is always blended
+
+        AlphaMode alphaMode = ALPHA_OPAQUE;
+
+        for (unsigned int i = 0; i < diffuseMaps.size(); i++)
+
+            alphaMode = std::max(alphaMode, diffuseMaps[i].alphaMode);
+
+        float opacity = 1.0f;
+
+        if (material->Get(AI_MATKEY_OPACITY, opacity) == AI_SUCCESS && opacity < 1.0f)
 
-        return Mesh(vertices, indices, textures);
+            alphaMode = ALPHA_BLENDED;
+
+
+
+        // return a mesh object created from the extracted mesh data (the constructor uploads the buffers)
+
+        LoadReport::AddMesh(vertices.size(), indices.size());
+
+        LoadReport::Stage upload(LoadReport::UPLOAD, true);
+
+        return Mesh(vertices, indices, textures, alphaMode);
 
     }
 
@@ -380,33 +498,19 @@ private:
 
             // check if texture was loaded before and if so, continue to next iteration: skip loading a new texture
 
-            bool skip = false;
-
-            for (unsigned int j = 0; j < textures_loaded.size(); j++)
+            int loaded = FindLoadedTexture(textures_loaded, str.C_Str());
 
-            {
-
-                if (std::strcmp(textures_loaded[j].path.data(), str.C_Str()) == 0)
-
-                {
-
-                    textures.push_back(textures_loaded[j]);
+            if (loaded != -1)
 
-                    skip = true; // a texture with the same filepath has already been loaded, continue to next one. (optimization)
-
-                    break;
-
-                }
-
-            }
+                textures.push_back(textures_loaded[loaded]); // a texture with the same filepath has already been loaded, continue to next one. (optimization)
 
-            if (!skip)
+            else
 
             {   // if texture hasn't been loaded already, load it
 
                 Texture texture;
 
-                texture.id = TextureFromFile(str.C_Str(), this->directory);
+                texture.id = TextureFromFile(str.C_Str(), this->directory, false, &texture.alphaMode);
 
                 texture.type = typeName;
 
@@ -424,25 +528,84 @@ private:
 
     }
 
+
+
 };
 
 
 
 
 
-unsigned int TextureFromFile(const char* path, const string& directory, bool gamma)
+// index in textures_loaded of the texture loaded from path, or -1 (Model and ModelAnim share the cache lookup)
+int FindLoadedTexture(const vector<Texture>& textures_loaded, const char* path)
+{
+    for (unsigned int j = 0; j < textures_loaded.size(); j++)
+        if (std::strcmp(textures_loaded[j].path.data(), path) == 0)
+            return (int)j;
+    return -1;
+}
+
+// Decide how a texture has to be drawn from its alpha channel: fully opaque, binary
+// (cut-outs, a few antialiased edge texels allowed) or really translucent
+AlphaMode ClassifyAlpha(const unsigned char* data, int width, int height, int nrComponents)
 {
+    if (nrComponents != 4)
+        return ALPHA_OPAQUE;
+
+    size_t pixels = (size_t)width * height;
+    size_t transparent = 0, translucent = 0;
+    for (size_t i = 0; i < pixels; i++)
+    {
+        unsigned char alpha = data[i * 4 + 3];
+        if (alpha < 16)
+            transparent++;
+        else if (alpha < 240)
+            translucent++;
+    }
+
+    if (translucent * 100 > pixels) // more than 1% partially transparent
+        return ALPHA_BLENDED;
+    if (transparent + translucent > 0)
+        return ALPHA_TESTED;
+    return ALPHA_OPAQUE;
+}
+
+// Reads the whole image file and then decodes it from memory, so the load report can tell disk time
+// from decode time. Same result as stbi_load; free with stbi_image_free
+unsigned char* ReadImage(const string& filename, int* width, int* height, int* nrComponents)
+{
+    vector<unsigned char> file;
+    {
+        LoadReport::Stage stage(LoadReport::READ);
+        ifstream in(filename.c_str(), ios::binary | ios::ate);
+        if (!in)
+            return NULL;
+        file.resize((size_t)in.tellg());
+        in.seekg(0);
+        if (file.empty() || !in.read((char*)&file[0], file.size()))
+            return NULL;
+        LoadReport::AddBytes(file.size());
+    }
+    LoadReport::Stage stage(LoadReport::DECODE);
+    return stbi_load_from_memory(&file[0], (int)file.size(), width, height, nrComponents, 0);
+}
+
+unsigned int TextureFromFile(const char* path, const string& directory, bool gamma, AlphaMode* alphaMode)
+{
+    PROFILE_SCOPE("TextureFromFile");
     string filename = string(path);
     filename = directory + '/' + filename;
+    LoadReport::Texture report(filename);
 
     unsigned int textureID;
     glGenTextures(1, &textureID);
 
     int width, height, nrComponents;
-    unsigned char* data = stbi_load(filename.c_str(), &width, &height, &nrComponents, 0);
+    unsigned char* data = ReadImage(filename, &width, &height, &nrComponents);
 
     if (data)
     {
+        report.SetSize(width, height, nrComponents);
         GLenum format = GL_RGB; // Inicializamos con un valor seguro por defecto
         if (nrComponents == 1)
             format = GL_RED;
@@ -458,8 +621,18 @@ unsigned int TextureFromFile(const char* path, const string& directory, bool gam
         glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
         // -----------------------------------------------
 
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
+        {
+            LoadReport::Stage stage(LoadReport::UPLOAD, true);
+            glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+        }
+        {
+            LoadReport::Stage stage(LoadReport::MIPMAPS, true);
+            glGenerateMipmap(GL_TEXTURE_2D);
+        }
+        RenderStats::TrackTextureMemory((GLint64)width * height * nrComponents * 4 / 3); // mipmaps included
+
+        if (alphaMode)
+            *alphaMode = ClassifyAlpha(data, width, height, nrComponents);
 
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
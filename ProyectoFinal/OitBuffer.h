@@ -0,0 +1,130 @@
+#pragma once
+
+// Std. Includes
+#include <iostream>
+
+// GL Includes
+#include <GL/glew.h>
+
+#include "Shader.h"
+#include "Framebuffer.h"
+#include "Profiler.h"
+#include "RenderStats.h"
+
+// Transparencia independiente del orden (weighted blended OIT, McGuire y Bavoil 2013).
+// Los fragmentos transparentes se acumulan en dos texturas en cualquier orden y un pase de
+// composicin los mezcla sobre la escena, sin ordenar objetos en la CPU:
+//  accumTexture  (RGBA16F) : rgb = suma de color * alfa * peso, a = producto de (1 - alfa) (revealage)
+//  weightTexture (R16F)    : r = suma de alfa * peso
+// Con una sola funcin de mezcla (glBlendFuncSeparate) basta para los dos destinos, as que
+// funciona en OpenGL 3.3 sin glBlendFunci.
+class OitBuffer
+{
+public:
+	GLuint FBO;
+	GLuint accumTexture;
+	GLuint weightTexture;
+	GLsizei width, height;
+
+	// depthTexture es la profundidad de la escena opaca: los transparentes se prueban contra ella sin escribirla
+	OitBuffer(GLsizei width, GLsizei height, GLuint depthTexture) : width(width), height(height)
+	{
+		glGenFramebuffers(1, &this->FBO);
+		glBindFramebuffer(GL_FRAMEBUFFER, this->FBO);
+
+		this->accumTexture = CreateTarget(GL_RGBA16F, GL_RGBA);
+		this->weightTexture = CreateTarget(GL_R16F, GL_RED);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, this->accumTexture, 0);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, this->weightTexture, 0);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depthTexture, 0);
+
+		const GLenum drawBuffers[] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1 };
+		glDrawBuffers(2, drawBuffers);
+
+		if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		{
+			std::cout << "ERROR::OIT:: Framebuffer is not complete (" << width << "x" << height << ")" << std::endl;
+		}
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+		// El pase de composicin genera el tringulo de pantalla completa con gl_VertexID
+		glGenVertexArrays(1, &this->emptyVAO);
+		RenderStats::TrackTextureMemory(MemoryBytes());
+	}
+
+	~OitBuffer()
+	{
+		RenderStats::TrackTextureMemory(-MemoryBytes());
+		glDeleteVertexArrays(1, &this->emptyVAO);
+		glDeleteTextures(1, &this->accumTexture);
+		glDeleteTextures(1, &this->weightTexture);
+		glDeleteFramebuffers(1, &this->FBO);
+	}
+
+	// Limpia los acumuladores y deja el estado de mezcla para dibujar transparentes en cualquier orden
+	void Begin()
+	{
+		const GLfloat accumClear[] = { 0.0f, 0.0f, 0.0f, 1.0f };
+		const GLfloat weightClear[] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+		glBindFramebuffer(GL_FRAMEBUFFER, this->FBO);
+		glViewport(0, 0, this->width, this->height);
+		glClearBufferfv(GL_COLOR, 0, accumClear);
+		glClearBufferfv(GL_COLOR, 1, weightClear);
+
+		glEnable(GL_DEPTH_TEST);
+		glDepthMask(GL_FALSE);
+		glEnable(GL_BLEND);
+		glBlendFuncSeparate(GL_ONE, GL_ONE, GL_ZERO, GL_ONE_MINUS_SRC_ALPHA);
+	}
+
+	// Mezcla el promedio ponderado de los transparentes sobre el color de target
+	void Composite(Shader& compositeShader, Framebuffer& target)
+	{
+		PROFILE_SCOPE("OitBuffer::Composite");
+		target.Bind();
+		glDepthMask(GL_TRUE);
+		glDisable(GL_DEPTH_TEST);
+		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+		compositeShader.Use();
+		glActiveTexture(GL_TEXTURE0);
+		glBindTexture(GL_TEXTURE_2D, this->accumTexture);
+		glUniform1i(glGetUniformLocation(compositeShader.Program, "accumTexture"), 0);
+		glActiveTexture(GL_TEXTURE1);
+		glBindTexture(GL_TEXTURE_2D, this->weightTexture);
+		glUniform1i(glGetUniformLocation(compositeShader.Program, "weightTexture"), 1);
+
+		glBindVertexArray(this->emptyVAO);
+		glDrawArrays(GL_TRIANGLES, 0, 3);
+		glBindVertexArray(0);
+
+		glActiveTexture(GL_TEXTURE0);
+		glDisable(GL_BLEND);
+		glEnable(GL_DEPTH_TEST);
+	}
+
+private:
+	GLuint emptyVAO;
+
+	// RGBA16F de acumulacin ms R16F de peso
+	GLint64 MemoryBytes() const
+	{
+		return (GLint64)this->width * this->height * (8 + 2);
+	}
+
+	OitBuffer(const OitBuffer&);
+	OitBuffer& operator=(const OitBuffer&);
+
+	GLuint CreateTarget(GLint internalFormat, GLenum format)
+	{
+		GLuint texture;
+		glGenTextures(1, &texture);
+		glBindTexture(GL_TEXTURE_2D, texture);
+		glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, this->width, this->height, 0, format, GL_FLOAT, NULL);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		return texture;
+	}
+};
@@ -0,0 +1,193 @@
+#pragma once
+
+// Std. Includes
+#include <vector>
+#include <cstddef>
+
+// GL Includes
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "Shader.h"
+#include "Framebuffer.h"
+#include "Profiler.h"
+#include "RenderStats.h"
+
+// Una partcula tal como la guarda la GPU (dos vec4 intercalados)
+struct Particle
+{
+	glm::vec4 positionAge;   // xyz = posicin, w = edad (negativa = an no nace)
+	glm::vec4 velocityLife;  // xyz = velocidad, w = duracin de la vida
+};
+
+// Columna de humo simulada por completo en la GPU.
+//  - Update: transform feedback de un buffer al otro (par de buffers alternados); cada partcula
+//    renace en su mismo lugar del buffer al terminar su vida, como un buffer circular.
+//  - Draw: cuadros instanciados que miran a la cmara (se expanden en particle.vs), con desvanecido
+//    suave contra la profundidad de la escena, en un buffer de media resolucin (opcional) que luego
+//    se escala y se mezcla sobre la escena.
+class ParticleSystem
+{
+public:
+	GLuint count;
+	glm::vec3 emitter;
+	GLfloat emitterRadius;
+	glm::vec3 wind;
+	GLfloat particleSize;
+	GLfloat opacity;
+	glm::vec3 smokeColor;
+	bool halfResolution;
+
+	// life: segundos que vive cada partcula; el emisor suelta count / life partculas por segundo
+	ParticleSystem(GLuint count, glm::vec3 emitter, GLfloat life, GLsizei screenWidth, GLsizei screenHeight)
+		: count(count), emitter(emitter), emitterRadius(0.08f), wind(0.05f, 0.0f, 0.0f), particleSize(0.18f),
+		opacity(0.12f), smokeColor(0.55f, 0.55f, 0.55f), halfResolution(true), current(0),
+		updateShader("Shaders/particleUpdate.vs", "Shaders/particleUpdate.frag", "", FeedbackVaryings()),
+		drawShader("Shaders/particle.vs", "Shaders/particle.frag"),
+		compositeShader("Shaders/fullscreen.vs", "Shaders/particleComposite.frag"),
+		fullTarget(screenWidth, screenHeight),
+		halfTarget(screenWidth / 2, screenHeight / 2)
+	{
+		// Edades escalonadas hacia atrs: las partculas nacen de una en una durante la primera vida
+		std::vector<Particle> particles(count);
+		for (GLuint i = 0; i < count; i++)
+		{
+			particles[i].positionAge = glm::vec4(emitter, -life * i / count);
+			particles[i].velocityLife = glm::vec4(0.0f, 0.0f, 0.0f, life);
+		}
+
+		glGenBuffers(2, this->buffers);
+		glGenVertexArrays(2, this->vaos);
+		for (unsigned int i = 0; i < 2; i++)
+		{
+			glBindVertexArray(this->vaos[i]);
+			glBindBuffer(GL_ARRAY_BUFFER, this->buffers[i]);
+			glBufferData(GL_ARRAY_BUFFER, count * sizeof(Particle), &particles[0], GL_DYNAMIC_COPY);
+
+			// El mismo VAO sirve para la simulacin (un vrtice por partcula) y para dibujar
+			// (una instancia por partcula); el divisor se cambia en Draw
+			glEnableVertexAttribArray(0);
+			glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(Particle), (GLvoid*)0);
+			glEnableVertexAttribArray(1);
+			glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Particle), (GLvoid*)offsetof(Particle, velocityLife));
+		}
+		glBindVertexArray(0);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		RenderStats::TrackBufferMemory(2 * (GLint64)count * sizeof(Particle));
+
+		glGenVertexArrays(1, &this->emptyVAO);
+	}
+
+	~ParticleSystem()
+	{
+		RenderStats::TrackBufferMemory(-2 * (GLint64)this->count * sizeof(Particle));
+		glDeleteVertexArrays(1, &this->emptyVAO);
+		glDeleteVertexArrays(2, this->vaos);
+		glDeleteBuffers(2, this->buffers);
+	}
+
+	// Avanza la simulacin un paso; no se lee nada de vuelta en la CPU
+	void Update(GLfloat time, GLfloat deltaTime)
+	{
+		PROFILE_SCOPE("ParticleSystem::Update");
+		this->updateShader.Use();
+		glUniform3fv(glGetUniformLocation(this->updateShader.Program, "emitter"), 1, glm::value_ptr(this->emitter));
+		glUniform1f(glGetUniformLocation(this->updateShader.Program, "emitterRadius"), this->emitterRadius);
+		glUniform3fv(glGetUniformLocation(this->updateShader.Program, "wind"), 1, glm::value_ptr(this->wind));
+		glUniform1f(glGetUniformLocation(this->updateShader.Program, "time"), time);
+		glUniform1f(glGetUniformLocation(this->updateShader.Program, "deltaTime"), deltaTime);
+
+		glEnable(GL_RASTERIZER_DISCARD);
+		glBindVertexArray(this->vaos[this->current]);
+		SetDivisor(0);
+		glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, this->buffers[1 - this->current]);
+		glBeginTransformFeedback(GL_POINTS);
+		glDrawArrays(GL_POINTS, 0, this->count);
+		glEndTransformFeedback();
+		glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+		glBindVertexArray(0);
+		glDisable(GL_RASTERIZER_DISCARD);
+
+		this->current = 1 - this->current;
+	}
+
+	// Dibuja las partculas y las mezcla sobre el color de scene; lee su profundidad sin escribirla
+	void Draw(const glm::mat4& view, const glm::mat4& projection, Framebuffer& scene, GLfloat nearPlane, GLfloat farPlane)
+	{
+		PROFILE_SCOPE("ParticleSystem::Draw");
+		Framebuffer& target = this->halfResolution ? this->halfTarget : this->fullTarget;
+
+		// 1. Partculas en su propio buffer, con alfa premultiplicado
+		target.Bind();
+		glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+		glDisable(GL_DEPTH_TEST);
+		glEnable(GL_BLEND);
+		glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+		this->drawShader.Use();
+		glUniformMatrix4fv(glGetUniformLocation(this->drawShader.Program, "view"), 1, GL_FALSE, glm::value_ptr(view));
+		glUniformMatrix4fv(glGetUniformLocation(this->drawShader.Program, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+		glUniform1f(glGetUniformLocation(this->drawShader.Program, "particleSize"), this->particleSize);
+		glUniform2f(glGetUniformLocation(this->drawShader.Program, "targetSize"), (GLfloat)target.width, (GLfloat)target.height);
+		glUniform1f(glGetUniformLocation(this->drawShader.Program, "nearPlane"), nearPlane);
+		glUniform1f(glGetUniformLocation(this->drawShader.Program, "farPlane"), farPlane);
+		glUniform1f(glGetUniformLocation(this->drawShader.Program, "softness"), 0.3f);
+		glUniform1f(glGetUniformLocation(this->drawShader.Program, "opacity"), this->opacity);
+		glUniform3fv(glGetUniformLocation(this->drawShader.Program, "smokeColor"), 1, glm::value_ptr(this->smokeColor));
+		glActiveTexture(GL_TEXTURE0);
+		glBindTexture(GL_TEXTURE_2D, scene.depthTexture);
+		glUniform1i(glGetUniformLocation(this->drawShader.Program, "sceneDepth"), 0);
+
+		glBindVertexArray(this->vaos[this->current]);
+		SetDivisor(1);
+		glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, this->count);
+		glBindVertexArray(0);
+
+		// 2. Escalado bilineal sobre la escena
+		scene.Bind();
+		this->compositeShader.Use();
+		glBindTexture(GL_TEXTURE_2D, target.colorTexture);
+		glUniform1i(glGetUniformLocation(this->compositeShader.Program, "particleTexture"), 0);
+		glUniform2f(glGetUniformLocation(this->compositeShader.Program, "screenSize"), (GLfloat)scene.width, (GLfloat)scene.height);
+		glBindVertexArray(this->emptyVAO);
+		glDrawArrays(GL_TRIANGLES, 0, 3);
+		glBindVertexArray(0);
+		glBindTexture(GL_TEXTURE_2D, 0);
+
+		glDisable(GL_BLEND);
+		glEnable(GL_DEPTH_TEST);
+	}
+
+private:
+	GLuint buffers[2];
+	GLuint vaos[2];
+	GLuint emptyVAO;
+	unsigned int current;
+
+	Shader updateShader;
+	Shader drawShader;
+	Shader compositeShader;
+	Framebuffer fullTarget;
+	Framebuffer halfTarget;
+
+	ParticleSystem(const ParticleSystem&);
+	ParticleSystem& operator=(const ParticleSystem&);
+
+	static std::vector<const GLchar*> FeedbackVaryings()
+	{
+		std::vector<const GLchar*> varyings;
+		varyings.push_back("outPositionAge");
+		varyings.push_back("outVelocityLife");
+		return varyings;
+	}
+
+	// 0 = un vrtice por partcula (simulacin), 1 = una instancia por partcula (dibujo)
+	static void SetDivisor(GLuint divisor)
+	{
+		glVertexAttribDivisor(0, divisor);
+		glVertexAttribDivisor(1, divisor);
+	}
+};
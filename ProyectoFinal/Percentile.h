@@ -0,0 +1,16 @@
+#pragma once
+
+// Std. Includes
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+// Percentil por rango ms cercano sobre valores ya ordenados de menor a mayor (0 si no hay valores):
+// lo usan los benchmarks que reportan p50/p95/p99 de tiempos por frame
+inline double Percentile(const std::vector<double>& sorted, double percent)
+{
+	if (sorted.empty())
+		return 0.0;
+	size_t rank = (size_t)std::ceil(percent / 100.0 * sorted.size());
+	return sorted[std::min(std::max(rank, (size_t)1), sorted.size()) - 1];
+}
@@ -0,0 +1,412 @@
+#pragma once
+
+// Std. Includes
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <cstdio>
+#include <cstddef>
+
+// GL Includes
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+
+#include "Shader.h"
+#include "GpuPassTimer.h"
+#include "RenderStats.h"
+
+// Panel de rendimiento sobre la imagen (tecla F1 o --hud): grficas del tiempo de CPU y de GPU de los ltimos
+// HISTORY frames con la lnea de 16.7 ms, la tabla de GpuPassTimer, los contadores de RenderStats del ltimo
+// frame y la memoria de texturas y buffers. Todo se arma en la CPU como tringulos de un solo VBO y se dibuja
+// con una llamada: las letras salen de un atlas de 5x7 pxeles horneado en este archivo (ASCII 32 a 95, las
+// minsculas se muestran en maysculas) y los rectngulos de una fila blanca del mismo atlas. El texto se
+// rearma TEXT_REFRESH_SECONDS veces por segundo, las grficas cada frame
+class PerformanceHud
+{
+public:
+	static const unsigned int HISTORY = 120;           // frames en las grficas
+	static constexpr double TEXT_REFRESH_SECONDS = 0.25;
+	static const int SCALE = 2;                        // pxeles de pantalla por pxel del atlas
+
+	bool visible;
+
+	PerformanceHud() : visible(false), shader("Shaders/hud.vs", "Shaders/hud.frag"), next(0), samples(0),
+		lastBuildMs(0.0), fps(0.0), textStale(true)
+	{
+		this->cpuMs.assign(HISTORY, 0.0);
+		this->gpuMs.assign(HISTORY, 0.0);
+		this->lastFrame = this->lastText = std::chrono::steady_clock::now();
+
+		// Atlas R8: 16 x 4 celdas de 6 x 8 (el glifo y un pxel de separacin) y abajo una fila blanca
+		std::vector<GLubyte> pixels(ATLAS_WIDTH * ATLAS_HEIGHT, 0);
+		for (int glyph = 0; glyph < GLYPHS; glyph++)
+			for (int row = 0; row < GLYPH_HEIGHT; row++)
+				for (int column = 0; column < GLYPH_WIDTH; column++)
+					if (Font()[glyph * GLYPH_HEIGHT + row] & (0x10 >> column))
+						pixels[((glyph / 16) * CELL_HEIGHT + row) * ATLAS_WIDTH + (glyph % 16) * CELL_WIDTH + column] = 255;
+		std::fill(pixels.end() - ATLAS_WIDTH, pixels.end(), (GLubyte)255);
+
+		glGenTextures(1, &this->atlas);
+		glBindTexture(GL_TEXTURE_2D, this->atlas);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, ATLAS_WIDTH, ATLAS_HEIGHT, 0, GL_RED, GL_UNSIGNED_BYTE, &pixels[0]);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		RenderStats::TrackTextureMemory(ATLAS_WIDTH * ATLAS_HEIGHT);
+
+		glGenVertexArrays(1, &this->VAO);
+		glGenBuffers(1, &this->VBO);
+		glBindVertexArray(this->VAO);
+		glBindBuffer(GL_ARRAY_BUFFER, this->VBO);
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (GLvoid*)offsetof(Vertex, position));
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (GLvoid*)offsetof(Vertex, texCoords));
+		glEnableVertexAttribArray(2);
+		glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex), (GLvoid*)offsetof(Vertex, color));
+		glBindVertexArray(0);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+
+	~PerformanceHud()
+	{
+		RenderStats::TrackTextureMemory(-(GLint64)(ATLAS_WIDTH * ATLAS_HEIGHT));
+		glDeleteBuffers(1, &this->VBO);
+		glDeleteVertexArrays(1, &this->VAO);
+		glDeleteTextures(1, &this->atlas);
+	}
+
+	void Toggle()
+	{
+		this->visible = !this->visible;
+		this->textStale = true;
+	}
+
+	// Una vez por frame, aunque el panel est oculto, para que las grficas tengan historia al mostrarlo.
+	// cpuMs: lo que tard el hilo de render en enviar el frame; gpuMs: el ltimo "Frame" ledo de GpuPassTimer
+	void AddFrame(double cpuMs, double gpuMs)
+	{
+		std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		double wallMs = std::chrono::duration<double, std::milli>(now - this->lastFrame).count();
+		this->lastFrame = now;
+		if (wallMs > 0.0)
+			this->fps = this->samples == 0 ? 1000.0 / wallMs : this->fps * 0.9 + 100.0 / wallMs;
+
+		this->cpuMs[this->next] = cpuMs;
+		this->gpuMs[this->next] = gpuMs;
+		this->next = (this->next + 1) % HISTORY;
+		this->samples = std::min(this->samples + 1, (unsigned int)HISTORY);
+	}
+
+	// Dibuja el panel sobre el framebuffer ligado (de width x height pxeles), con un solo glDrawArrays.
+	// Deja desactivada la mezcla y activada la prueba de profundidad, como el resto del frame
+	void Draw(GLsizei width, GLsizei height, const GpuPassTimer& gpuPasses)
+	{
+		if (!this->visible)
+			return;
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		if (this->textStale || std::chrono::duration<double>(start - this->lastText).count() >= TEXT_REFRESH_SECONDS)
+		{
+			BuildText(gpuPasses);
+			this->lastText = start;
+			this->textStale = false;
+		}
+
+		// Fondo, grficas y al final el texto ya armado
+		this->vertices.clear();
+		AddRect(MARGIN - PADDING, MARGIN - PADDING, PANEL_WIDTH + 2 * PADDING, this->panelHeight + 2 * PADDING, 0, 0, 0, 170);
+		AddGraph(this->cpuGraphY, this->cpuMs, 80, 220, 120);
+		AddGraph(this->gpuGraphY, this->gpuMs, 240, 170, 60);
+		this->vertices.insert(this->vertices.end(), this->textVertices.begin(), this->textVertices.end());
+
+		glBindBuffer(GL_ARRAY_BUFFER, this->VBO);
+		GLsizeiptr bytes = (GLsizeiptr)(this->vertices.size() * sizeof(Vertex));
+		glBufferData(GL_ARRAY_BUFFER, bytes, NULL, GL_STREAM_DRAW);  // buffer nuevo: no espera al frame anterior
+		RenderStats::BufferSubData(GL_ARRAY_BUFFER, 0, bytes, &this->vertices[0]);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+		this->shader.Use();
+		RenderStats::Uniform2f(glGetUniformLocation(this->shader.Program, "screenSize"), (GLfloat)width, (GLfloat)height);
+		RenderStats::Uniform1i(glGetUniformLocation(this->shader.Program, "fontAtlas"), 0);
+		glActiveTexture(GL_TEXTURE0);
+		RenderStats::BindTexture(GL_TEXTURE_2D, this->atlas);
+		RenderStats::Disable(GL_DEPTH_TEST);
+		RenderStats::Enable(GL_BLEND);
+		RenderStats::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		RenderStats::BindVertexArray(this->VAO);
+		RenderStats::DrawArrays(GL_TRIANGLES, 0, (GLsizei)this->vertices.size());
+		RenderStats::BindVertexArray(0);
+		RenderStats::Disable(GL_BLEND);
+		RenderStats::Enable(GL_DEPTH_TEST);
+
+		this->lastBuildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+private:
+	struct Vertex
+	{
+		glm::vec2 position;
+		glm::vec2 texCoords;
+		GLubyte color[4];
+	};
+
+	static const int GLYPH_WIDTH = 5, GLYPH_HEIGHT = 7;
+	static const int CELL_WIDTH = 6, CELL_HEIGHT = 8;
+	static const int GLYPHS = 64;                       // ASCII 32 a 95
+	static const int ATLAS_WIDTH = 16 * CELL_WIDTH;
+	static const int ATLAS_HEIGHT = 4 * CELL_HEIGHT + 1;
+	static const int CHAR_ADVANCE = CELL_WIDTH * SCALE;
+	static const int LINE_HEIGHT = (CELL_HEIGHT + 1) * SCALE;
+	static const int MARGIN = 12, PADDING = 6;
+	static const int PANEL_WIDTH = 44 * CHAR_ADVANCE;
+	static const int GRAPH_HEIGHT = 48;
+	static constexpr double GRAPH_MS = 33.3;            // escala mnima de las grficas (dos frames a 60 Hz)
+	static const size_t MAX_PASSES = 14;                // filas de la tabla de pases
+
+	Shader shader;
+	GLuint atlas, VAO, VBO;
+	std::vector<double> cpuMs, gpuMs;  // circulares: next es el ms viejo
+	unsigned int next;
+	unsigned int samples;
+	double lastBuildMs;                // costo de CPU del ltimo Draw
+	double fps;                        // promedio exponencial
+	std::chrono::steady_clock::time_point lastFrame, lastText;
+	bool textStale;
+	std::vector<Vertex> vertices;
+	std::vector<Vertex> textVertices;
+	float cpuGraphY, gpuGraphY, panelHeight;
+
+	PerformanceHud(const PerformanceHud&);
+	PerformanceHud& operator=(const PerformanceHud&);
+
+	// Texto del panel; deja cpuGraphY, gpuGraphY y panelHeight segn las lneas que salieron
+	void BuildText(const GpuPassTimer& gpuPasses)
+	{
+		this->textVertices.clear();
+		float y = (float)MARGIN;
+		char line[96];
+
+		snprintf(line, sizeof(line), "%.1f FPS   HUD %.3f MS CPU", this->fps, this->lastBuildMs);
+		AddText(y, line, 255, 255, 255);
+		y += LINE_HEIGHT;
+
+		snprintf(line, sizeof(line), "CPU %6.2f MS   MAX %6.2f", Latest(this->cpuMs), Max(this->cpuMs));
+		AddText(y, line, 80, 220, 120);
+		y += LINE_HEIGHT;
+		this->cpuGraphY = y;
+		y += GRAPH_HEIGHT + PADDING;
+
+		snprintf(line, sizeof(line), "GPU %6.2f MS   MAX %6.2f", Latest(this->gpuMs), Max(this->gpuMs));
+		AddText(y, line, 240, 170, 60);
+		y += LINE_HEIGHT;
+		this->gpuGraphY = y;
+		y += GRAPH_HEIGHT + PADDING;
+
+		// Tabla de pases: ltimo valor y media
+		const std::vector<GpuPassTimer::Stats>& passes = gpuPasses.Passes();
+		snprintf(line, sizeof(line), "%-28s%8s%8s", "PASE GPU", "ULT", "MEDIA");
+		AddText(y, line, 160, 200, 255);
+		y += LINE_HEIGHT;
+		for (size_t i = 0; i < passes.size() && i < MAX_PASSES; i++)
+		{
+			const GpuPassTimer::Stats& pass = passes[i];
+			std::string name = std::string(2 * pass.depth, ' ') + pass.name;
+			snprintf(line, sizeof(line), "%-28.28s%8.3f%8.3f", name.c_str(), pass.lastMs, pass.sumMs / std::max(pass.frames, 1u));
+			AddText(y, line, 220, 220, 220);
+			y += LINE_HEIGHT;
+		}
+		if (passes.size() > MAX_PASSES)
+		{
+			snprintf(line, sizeof(line), "  ... %u PASES MAS (TECLA G)", (unsigned int)(passes.size() - MAX_PASSES));
+			AddText(y, line, 160, 160, 160);
+			y += LINE_HEIGHT;
+		}
+
+		// Contadores del ltimo frame terminado
+		const RenderStats::Counters& stats = RenderStats::Last();
+		snprintf(line, sizeof(line), "DRAWS %llu  TRIS %s  VERTS %s", (unsigned long long)stats.drawCalls,
+			Abbreviate((double)stats.triangles).c_str(), Abbreviate((double)stats.vertices).c_str());
+		AddText(y, line, 255, 255, 160);
+		y += LINE_HEIGHT;
+		snprintf(line, sizeof(line), "PROG %llu  TEX %llu  VAO %llu  UNIF %llu", (unsigned long long)stats.programBinds,
+			(unsigned long long)stats.textureBinds, (unsigned long long)stats.vaoBinds, (unsigned long long)stats.uniformUploads);
+		AddText(y, line, 255, 255, 160);
+		y += LINE_HEIGHT;
+		snprintf(line, sizeof(line), "ESTADO %llu  SUBIDAS %sB", (unsigned long long)stats.stateChanges,
+			Abbreviate((double)stats.bufferBytes).c_str());
+		AddText(y, line, 255, 255, 160);
+		y += LINE_HEIGHT;
+
+		snprintf(line, sizeof(line), "MEMORIA TEX %.1f MB  BUF %.1f MB", RenderStats::TextureMemory() / (1024.0 * 1024.0),
+			RenderStats::BufferMemory() / (1024.0 * 1024.0));
+		AddText(y, line, 255, 160, 200);
+		y += LINE_HEIGHT;
+
+		this->panelHeight = y - MARGIN;
+	}
+
+	// Una barra por frame, del ms viejo al ms nuevo, y la lnea de 16.7 ms. La escala crece si algn frame
+	// pasa de GRAPH_MS para que los picos no se corten
+	void AddGraph(float top, const std::vector<double>& values, GLubyte r, GLubyte g, GLubyte b)
+	{
+		float barWidth = (float)PANEL_WIDTH / HISTORY;
+		double scale = std::max((double)GRAPH_MS, Max(values));
+		AddRect((float)MARGIN, top, (float)PANEL_WIDTH, (float)GRAPH_HEIGHT, 40, 40, 40, 200);
+		for (unsigned int i = HISTORY - this->samples; i < HISTORY; i++)
+		{
+			double value = values[(this->next + i) % HISTORY];
+			float height = (float)(std::min(value / scale, 1.0) * GRAPH_HEIGHT);
+			AddRect(MARGIN + i * barWidth, top + GRAPH_HEIGHT - height, barWidth, height, r, g, b, 255);
+		}
+		float target = (float)(GRAPH_HEIGHT * (1.0 - 1000.0 / 60.0 / scale));
+		AddRect((float)MARGIN, top + target, (float)PANEL_WIDTH, 1.0f, 255, 80, 80, 255);
+	}
+
+	void AddText(float y, const char* text, GLubyte r, GLubyte g, GLubyte b)
+	{
+		float x = (float)MARGIN;
+		for (const char* c = text; *c != '\0'; c++, x += CHAR_ADVANCE)
+		{
+			int code = (unsigned char)*c;
+			if (code >= 'a' && code <= 'z')
+				code -= 'a' - 'A';
+			if (code == ' ')
+				continue;
+			if (code < 32 || code >= 32 + GLYPHS)
+				code = '?';
+			int glyph = code - 32;
+			float u = (float)((glyph % 16) * CELL_WIDTH), v = (float)((glyph / 16) * CELL_HEIGHT);
+			AddQuad(this->textVertices, x, y, (float)(GLYPH_WIDTH * SCALE), (float)(GLYPH_HEIGHT * SCALE),
+				u / ATLAS_WIDTH, v / ATLAS_HEIGHT, (u + GLYPH_WIDTH) / ATLAS_WIDTH, (v + GLYPH_HEIGHT) / ATLAS_HEIGHT, r, g, b, 255);
+		}
+	}
+
+	// Rectngulo de color slido: las cuatro esquinas leen el centro de un pxel de la fila blanca
+	void AddRect(float x, float y, float width, float height, GLubyte r, GLubyte g, GLubyte b, GLubyte a)
+	{
+		float u = 0.5f / ATLAS_WIDTH, v = (ATLAS_HEIGHT - 0.5f) / ATLAS_HEIGHT;
+		AddQuad(this->vertices, x, y, width, height, u, v, u, v, r, g, b, a);
+	}
+
+	static void AddQuad(std::vector<Vertex>& out, float x, float y, float width, float height,
+		float u0, float v0, float u1, float v1, GLubyte r, GLubyte g, GLubyte b, GLubyte a)
+	{
+		Vertex corners[4] = {
+			{ glm::vec2(x, y), glm::vec2(u0, v0), { r, g, b, a } },
+			{ glm::vec2(x + width, y), glm::vec2(u1, v0), { r, g, b, a } },
+			{ glm::vec2(x + width, y + height), glm::vec2(u1, v1), { r, g, b, a } },
+			{ glm::vec2(x, y + height), glm::vec2(u0, v1), { r, g, b, a } }
+		};
+		out.push_back(corners[0]);
+		out.push_back(corners[1]);
+		out.push_back(corners[2]);
+		out.push_back(corners[0]);
+		out.push_back(corners[2]);
+		out.push_back(corners[3]);
+	}
+
+	double Latest(const std::vector<double>& values) const
+	{
+		return values[(this->next + HISTORY - 1) % HISTORY];
+	}
+
+	double Max(const std::vector<double>& values) const
+	{
+		double result = 0.0;
+		for (unsigned int i = HISTORY - this->samples; i < HISTORY; i++)
+			result = std::max(result, values[(this->next + i) % HISTORY]);
+		return result;
+	}
+
+	// 1234 -> "1.2K", 5600000 -> "5.6M"
+	static std::string Abbreviate(double value)
+	{
+		char text[32];
+		if (value >= 1.0e6)
+			snprintf(text, sizeof(text), "%.1fM", value / 1.0e6);
+		else if (value >= 1.0e3)
+			snprintf(text, sizeof(text), "%.1fK", value / 1.0e3);
+		else
+			snprintf(text, sizeof(text), "%.0f", value);
+		return text;
+	}
+
+	// Fuente de 5x7: siete filas por glifo de arriba hacia abajo, el bit 4 es la columna izquierda
+	static const GLubyte* Font()
+	{
+		static const GLubyte font[GLYPHS * GLYPH_HEIGHT] = {
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // espacio
+		0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x04,  // !
+		0x0A, 0x0A, 0x0A, 0x00, 0x00, 0x00, 0x00,  // "
+		0x0A, 0x0A, 0x1F, 0x0A, 0x1F, 0x0A, 0x0A,  // #
+		0x04, 0x0F, 0x14, 0x0E, 0x05, 0x1E, 0x04,  // $
+		0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03,  // %
+		0x0C, 0x12, 0x14, 0x08, 0x15, 0x12, 0x0D,  // &
+		0x04, 0x04, 0x08, 0x00, 0x00, 0x00, 0x00,  // '
+		0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02,  // (
+		0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08,  // )
+		0x00, 0x04, 0x15, 0x0E, 0x15, 0x04, 0x00,  // *
+		0x00, 0x04, 0x04, 0x1F, 0x04, 0x04, 0x00,  // +
+		0x00, 0x00, 0x00, 0x00, 0x0C, 0x04, 0x08,  // ,
+		0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00,  // -
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C,  // .
+		0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00,  // /
+		0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E,  // 0
+		0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E,  // 1
+		0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F,  // 2
+		0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E,  // 3
+		0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02,  // 4
+		0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E,  // 5
+		0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E,  // 6
+		0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08,  // 7
+		0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E,  // 8
+		0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C,  // 9
+		0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00,  // :
+		0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x04, 0x08,  // ;
+		0x02, 0x04, 0x08, 0x10, 0x08, 0x04, 0x02,  // <
+		0x00, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x00,  // =
+		0x08, 0x04, 0x02, 0x01, 0x02, 0x04, 0x08,  // >
+		0x0E, 0x11, 0x01, 0x02, 0x04, 0x00, 0x04,  // ?
+		0x0E, 0x11, 0x01, 0x0D, 0x15, 0x15, 0x0E,  // @
+		0x0E, 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11,  // A
+		0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E,  // B
+		0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E,  // C
+		0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C,  // D
+		0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F,  // E
+		0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10,  // F
+		0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F,  // G
+		0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11,  // H
+		0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E,  // I
+		0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C,  // J
+		0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11,  // K
+		0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F,  // L
+		0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11,  // M
+		0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11,  // N
+		0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E,  // O
+		0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10,  // P
+		0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D,  // Q
+		0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11,  // R
+		0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E,  // S
+		0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04,  // T
+		0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E,  // U
+		0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04,  // V
+		0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A,  // W
+		0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11,  // X
+		0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04,  // Y
+		0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F,  // Z
+		0x0E, 0x08, 0x08, 0x08, 0x08, 0x08, 0x0E,  // [
+		0x00, 0x10, 0x08, 0x04, 0x02, 0x01, 0x00,  // barra invertida
+		0x0E, 0x02, 0x02, 0x02, 0x02, 0x02, 0x0E,  // ]
+		0x04, 0x0A, 0x11, 0x00, 0x00, 0x00, 0x00,  // ^
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F,  // _
+		};
+		return font;
+	}
+};
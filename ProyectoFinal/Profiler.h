@@ -0,0 +1,216 @@
+#pragma once
+
+// Std. Includes
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <algorithm>
+
+// Perfilador de CPU por zonas. PROFILE_SCOPE("nombre") mide el bloque que la contiene y PROFILE_FUNCTION()
+// la funcin; las zonas anidadas de un hilo forman la jerarqua (el visor la arma con los tiempos).
+//  - Compilando sin ENABLE_PROFILER las macros no generan cdigo.
+//  - Con ENABLE_PROFILER y sin captura cada zona solo lee una bandera atmica.
+//  - Durante una captura (Profiler::Start / Stop) cada zona toma dos marcas de steady_clock y escribe un
+//    evento en el buffer circular de su hilo, sin candados: si la captura es larga se quedan los ltimos eventos.
+// WriteChromeTrace exporta la captura al formato JSON de chrome://tracing y ui.perfetto.dev.
+// Los nombres deben ser cadenas que vivan toda la ejecucin (literales o __FUNCTION__)
+class Profiler
+{
+public:
+	static const size_t EVENTS_PER_THREAD = 1 << 18;  // 6 MB por hilo que registr eventos
+
+	struct Event
+	{
+		const char* name;
+		int64_t begin;  // ns de steady_clock
+		int64_t end;
+	};
+
+	// Buffer circular de un hilo; solo ese hilo escribe. Se reserva con la primera zona que captura
+	struct ThreadBuffer
+	{
+		std::vector<Event> events;
+		uint64_t count = 0;         // eventos escritos en total (el ndice es count % EVENTS_PER_THREAD)
+		unsigned int id = 0;
+		std::string name;
+	};
+
+	// true si las zonas estn compiladas (ENABLE_PROFILER)
+	static bool Compiled()
+	{
+#ifdef ENABLE_PROFILER
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	// Empieza una captura nueva (descarta la anterior)
+	static void Start()
+	{
+		State& state = GetState();
+		std::lock_guard<std::mutex> lock(state.mutex);
+		for (size_t i = 0; i < state.threads.size(); i++)
+			state.threads[i]->count = 0;
+		state.recording.store(true, std::memory_order_relaxed);
+	}
+
+	// Las zonas que ya empezaron terminan de escribirse; exportar despus de que terminen (p. ej. al final del frame)
+	static void Stop()
+	{
+		GetState().recording.store(false, std::memory_order_relaxed);
+	}
+
+	static bool Recording()
+	{
+		return GetState().recording.load(std::memory_order_relaxed);
+	}
+
+	// Nombre del hilo que llama en la traza (por omisin "hilo N")
+	static void SetThreadName(const std::string& name)
+	{
+		CurrentThread().name = name;
+	}
+
+	// Escribe la captura como "complete events" (ph = X) con el tiempo en microsegundos; false si no se pudo
+	static bool WriteChromeTrace(const std::string& path)
+	{
+		std::ofstream file(path.c_str());
+		if (!file)
+		{
+			std::cout << "ERROR::PROFILER:: no se pudo escribir " << path << std::endl;
+			return false;
+		}
+
+		State& state = GetState();
+		std::lock_guard<std::mutex> lock(state.mutex);
+		// Los eventos quedan en el orden en que terminaron: una zona va despus de las que contiene
+		const uint64_t capacity = EVENTS_PER_THREAD;
+		int64_t origin = INT64_MAX;
+		for (size_t t = 0; t < state.threads.size(); t++)
+		{
+			const ThreadBuffer& thread = *state.threads[t];
+			for (uint64_t i = 0; i < std::min(thread.count, capacity); i++)
+				origin = std::min(origin, thread.events[i].begin);
+		}
+
+		size_t written = 0;
+		file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[" << std::fixed << std::setprecision(3);
+		for (size_t t = 0; t < state.threads.size(); t++)
+		{
+			const ThreadBuffer& thread = *state.threads[t];
+			file << (written++ > 0 ? ",\n" : "\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread.id
+				<< ",\"args\":{\"name\":\"" << Escape(thread.name) << "\"}}";
+			uint64_t stored = std::min(thread.count, capacity);
+			for (uint64_t i = thread.count - stored; i < thread.count; i++)
+			{
+				const Event& event = thread.events[i % EVENTS_PER_THREAD];
+				file << ",\n{\"name\":\"" << Escape(event.name) << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread.id
+					<< ",\"ts\":" << (event.begin - origin) / 1000.0 << ",\"dur\":" << (event.end - event.begin) / 1000.0 << "}";
+				written++;
+			}
+		}
+		file << "\n]}" << std::endl;
+		std::cout << "Profiler: " << written - state.threads.size() << " zonas en " << state.threads.size() << " hilos -> " << path << std::endl;
+		return true;
+	}
+
+	static int64_t Now()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	static ThreadBuffer& CurrentThread()
+	{
+		thread_local ThreadBuffer* buffer = NULL;
+		if (buffer == NULL)
+		{
+			State& state = GetState();
+			std::lock_guard<std::mutex> lock(state.mutex);
+			state.threads.push_back(std::unique_ptr<ThreadBuffer>(new ThreadBuffer()));
+			buffer = state.threads.back().get();
+			buffer->id = (unsigned int)state.threads.size() - 1;
+			buffer->name = "hilo " + std::to_string(buffer->id);
+		}
+		return *buffer;
+	}
+
+private:
+	// Los buffers viven hasta el final del programa aunque su hilo termine, as se pueden exportar
+	struct State
+	{
+		std::atomic<bool> recording{ false };
+		std::mutex mutex;
+		std::vector<std::unique_ptr<ThreadBuffer>> threads;
+	};
+
+	static State& GetState()
+	{
+		static State state;
+		return state;
+	}
+
+	static std::string Escape(const std::string& text)
+	{
+		std::string escaped;
+		for (size_t i = 0; i < text.size(); i++)
+		{
+			if (text[i] == '"' || text[i] == '\\')
+				escaped += '\\';
+			escaped += text[i];
+		}
+		return escaped;
+	}
+};
+
+// Una zona: mide desde su construccin hasta el final del bloque. Usar con las macros
+class ProfileZone
+{
+public:
+	ProfileZone(const char* name) : thread(NULL)
+	{
+		if (!Profiler::Recording())
+			return;
+		this->thread = &Profiler::CurrentThread();
+		if (this->thread->events.empty())
+			this->thread->events.resize(Profiler::EVENTS_PER_THREAD);
+		this->name = name;
+		this->begin = Profiler::Now();
+	}
+
+	~ProfileZone()
+	{
+		if (this->thread == NULL)
+			return;
+		Profiler::Event& event = this->thread->events[this->thread->count % Profiler::EVENTS_PER_THREAD];
+		event.name = this->name;
+		event.begin = this->begin;
+		event.end = Profiler::Now();
+		this->thread->count++;
+	}
+
+private:
+	Profiler::ThreadBuffer* thread;
+	const char* name;
+	int64_t begin;
+
+	ProfileZone(const ProfileZone&);
+	ProfileZone& operator=(const ProfileZone&);
+};
+
+#ifdef ENABLE_PROFILER
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define PROFILE_FUNCTION() PROFILE_SCOPE(__FUNCTION__)
+#else
+#define PROFILE_SCOPE(name)
+#define PROFILE_FUNCTION()
+#endif
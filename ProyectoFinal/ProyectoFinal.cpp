@@ -1,5 +1,8 @@
 #include <iostream>
 #include <cmath>
+#include <string>
+#include <cstdio>
+#include <chrono>
 
 // Libreras de OpenGL y manejo de grficos
 #include <GL/glew.h>         
@@ -18,11 +21,33 @@
 #include "Model.h"           // Carga y dibujo de modelos .obj
 #include "Texture.h"         // Manejo de texturas (no se usa mucho aqu)
 #include "modelAnim.h"       // Modelos con shaders animados
+#include "Lights.h"          // Luces empaquetadas en un Uniform Buffer
+#include "LightingBenchmark.h" // Escena de prueba para medir el shader de iluminacin
+#include "RenderQueue.h"       // Dibujo por pases: profundidad, opacos, recortados y transparentes
+#include "FragmentCounter.h"   // Fragmentos sombreados por frame (sobre-dibujo)
+#include "OitBuffer.h"         // Transparencia ponderada independiente del orden
+#include "TransparencyBenchmark.h" // Mezcla ordenada contra transparencia ponderada
+#include "ParticleSystem.h"    // Humo de partculas simulado en la GPU
+#include "AnimationBenchmark.h" // Esqueleto recursivo contra esqueleto aplanado
+#include "CrowdBenchmark.h"     // Copias completas de un personaje contra instancias de un modelo compartido
+#include "HeadlessContext.h"    // Contexto sin ventana (EGL u OSMesa) para --headless
+#include "FlythroughBenchmark.h" // Recorrido de cmara repetible con percentiles de tiempo por frame
+#include "Profiler.h"            // Zonas de tiempo de CPU exportables a chrome://tracing
+#include "GpuPassTimer.h"        // Tiempo de GPU por pase con grupos de depuracin de KHR_debug
+#include "RenderStats.h"         // Draws, tringulos y cambios de estado por frame
+#include "PerformanceHud.h"      // Panel de rendimiento sobre la imagen
+#include "LoadReport.h"          // Tiempo de carga de cada recurso por etapa
+#include "InputRecorder.h"       // Grabacin y reproduccin de la entrada
+#include "ScaleBenchmark.h"       // Vecindarios generados (StressScene) contra tiempo, memoria y carga
+#include "Scene.h"                // Modelos, objetos, luces y animaciones ledos de un archivo de escena
 
 // Callbacks y control de entrada
 void KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mode);
 void MouseCallback(GLFWwindow* window, double xPos, double yPos);
 void DoMovement();  // Movimiento de cmara y objetos animados
+void SetupSceneLights(LightBuffer& lights);  // Luces de la escena (direccional, puntuales y spotlight)
+void SetLightingUniforms(Shader& shader, const glm::mat4& view, const glm::mat4& projection);  // Cmara para las variantes del shader de iluminacin
+double AppTime();    // Segundos desde el inicio: reloj de GLFW, o de los frames dibujados con --headless o --flythrough
 
 
 // ------------------------------
@@ -39,6 +64,11 @@ bool anim_mecedora = false;     // Activaci
 
 bool anim_radio = false;
 
+bool depthPrePass = true;       // Pre-pase de profundidad antes de sombrear los opacos (tecla P)
+bool showFragmentStats = false; // Imprime fragmentos sombreados y sobre-dibujo (tecla O)
+bool weightedOit = true;        // Transparentes sin ordenar con OitBuffer; si no, mezcla ordenada (tecla I)
+bool smokeHalfResolution = true; // Partculas de humo a media resolucin (tecla H)
+
 float tiempo;                   // Variable para controlar el tiempo
 float speed;                    // Velocidad de animaciones
 
@@ -47,9 +77,94 @@ float speed;                    // Velocidad de animaciones
 // Tamao de la ventana
 // ------------------------------
 const GLuint WIDTH = 1280, HEIGHT = 720;
+const GLfloat NEAR_PLANE = 0.1f, FAR_PLANE = 1000.0f;  // Planos de recorte de la proyeccin
 int SCREEN_WIDTH, SCREEN_HEIGHT;
 
 
+// ------------------------------
+// Modo sin ventana (--headless): sin GLFW ni entrada, la escena se dibuja en su framebuffer
+// un nmero fijo de frames, con un paso de tiempo fijo para que cada corrida dibuje lo mismo
+// ------------------------------
+bool headless = false;
+GLuint headlessWidth = WIDTH, headlessHeight = HEIGHT;  // --size <ancho>x<alto>
+GLuint headlessFrames = 300;    // --frames <n>
+std::string dumpPrefix;         // --dump <prefijo>: guarda <prefijo>0000.png, <prefijo>0001.png, ...
+GLuint dumpEvery = 1;           // --dump-every <n>: solo uno de cada n frames
+GLuint framesDrawn = 0;         // Frames dibujados; con --headless o --flythrough es el reloj de la escena
+const double FIXED_FRAME_SECONDS = 1.0 / 60.0;
+
+
+// ------------------------------
+// Recorrido de cmara (--flythrough <ruta> [--csv <ruta>]): la cmara sigue el archivo con pasos de
+// tiempo fijos, sin teclado ni mouse, y al terminar se imprimen los percentiles de tiempo por frame
+// ------------------------------
+FlythroughBenchmark flythrough(10, FIXED_FRAME_SECONDS);
+std::string flythroughPath;
+std::string flythroughCsv = "flythrough.csv";
+
+
+// ------------------------------
+// Perfilador de CPU (solo si se compil con ENABLE_PROFILER): --profile <ruta> captura toda la corrida,
+// incluida la carga de modelos; la tecla T empieza una captura y al volver a presionarla la escribe
+// ------------------------------
+std::string profilePath;
+bool profileToggle = false;     // La tecla T pide empezar o terminar una captura al inicio del siguiente frame
+
+
+// ------------------------------
+// Tiempo de GPU por pase: la tecla G imprime la tabla; --gpu-csv <ruta> guarda cada frame y --gpu-models
+// adems mide cada objeto de la escena dentro de su pase. Con --headless o --flythrough la tabla sale al final
+// ------------------------------
+std::string gpuPassCsv;
+bool gpuPassModels = false;
+bool printGpuPasses = false;    // La tecla G pide la tabla al final del frame
+bool printRenderStats = false;  // La tecla R imprime los contadores de RenderStats del frame
+
+
+// ------------------------------
+// Panel de rendimiento: la tecla F1 lo muestra u oculta; --hud empieza con l visible (tambin en los PNG de --dump)
+// ------------------------------
+bool showHud = false;
+bool hudToggle = false;         // La tecla F1 pide mostrarlo u ocultarlo al final del frame
+
+
+// ------------------------------
+// Reporte de carga (--load-report <ruta.json>): al terminar de cargar imprime la tabla de recursos ordenada
+// por tiempo y escribe el JSON con las etapas de cada uno (ver LoadReport)
+// ------------------------------
+std::string loadReportPath;
+
+
+// ------------------------------
+// Escala (--bench-scale): barre casas, muebles, luces y personajes de una escena generada; --scale-csv <ruta>
+// cambia el CSV, --scale-character <ruta> agrega personajes animados y --scale-seed <n> la semilla
+// ------------------------------
+std::string scaleCsv = "scale.csv";
+std::string scaleCharacter;
+unsigned int scaleSeed = 1;
+
+
+// ------------------------------
+// Escena (--scene <ruta>, texto o compilada): modelos, transformaciones, materiales, luces y canales de
+// animacin (ver SceneFile.h). --compile-scene <texto> <salida> la compila y termina; F5 la vuelve a leer
+// ------------------------------
+Scene scene;
+std::string scenePath = "Escenas/casa.txt";
+std::string compileSceneSource;
+std::string compileSceneOutput;
+bool sceneReload = false;       // La tecla F5 pide recargar la escena al inicio del siguiente frame
+
+
+// ------------------------------
+// Grabacin de la entrada: --record <ruta> guarda el tiempo de cada frame y los eventos de teclado y mouse;
+// --replay <ruta> los vuelve a entregar en el mismo frame (con --replay-fixed a 60 pasos por segundo) y
+// termina con la grabacin. Tambin funciona con --headless, --profile y los dems reportes
+// ------------------------------
+InputRecorder input;
+std::string recordPath, replayPath;
+bool replayFixed = false;
+
+
 // ------------------------------
 // Cmara tipo FPS
 // ------------------------------
@@ -78,91 +193,242 @@ GLfloat deltaTime = 0.0f;  // Tiempo entre frames actual y anterior
 GLfloat lastFrame = 0.0f;  // Tiempo del ltimo frame
 
 // ------------------------------
-// Posiciones de luces puntuales
+// Cubo que marca la lmpara interior; las luces estn en el archivo de escena
 // ------------------------------
-// Se usan tres luces: una exterior, una interior, y una tipo "sol" (Y, Z, X)
-glm::vec3 pointLightPositions[] = {
-	glm::vec3(9.328f, 3.656f, -4.543f),   // Luz exterior (carpa)
-	glm::vec3(-4.7f, 2.90f, -2.0f),    // Luz interior (recmara)
-	glm::vec3(1.767f, 26.217f, 0.018f)    // Luz tipo sol (alta)
-};
+glm::vec3 interiorLampPosition(-4.7f, 2.90f, -2.0f);
 
-// ------------------------------
-// Color de la luz que se activa con barra espaciadora
-// ------------------------------
-// Cambia entre amarillo encendido y negro apagado
-glm::vec3 LightP1;
 
 
-
-int main()
+int main(int argc, char* argv[])
 {
-	// Inicializar GLFW
-	glfwInit();
-
-	// Crear la ventana principal del proyecto 
-	GLFWwindow* window = glfwCreateWindow(WIDTH, HEIGHT, "Proyecto Final", nullptr, nullptr);
-	if (nullptr == window)
+	// Opciones del modo sin ventana; se leen antes de crear el contexto
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		if (arg == "--headless")
+			headless = true;
+		else if (arg == "--size" && i + 1 < argc)
+			sscanf(argv[++i], "%ux%u", &headlessWidth, &headlessHeight);
+		else if (arg == "--frames" && i + 1 < argc)
+			headlessFrames = (GLuint)std::stoul(argv[++i]);
+		else if (arg == "--dump" && i + 1 < argc)
+			dumpPrefix = argv[++i];
+		else if (arg == "--dump-every" && i + 1 < argc)
+			dumpEvery = std::max((GLuint)std::stoul(argv[++i]), 1u);
+		else if (arg == "--flythrough" && i + 1 < argc)
+			flythroughPath = argv[++i];
+		else if (arg == "--csv" && i + 1 < argc)
+			flythroughCsv = argv[++i];
+		else if (arg == "--profile" && i + 1 < argc)
+			profilePath = argv[++i];
+		else if (arg == "--gpu-csv" && i + 1 < argc)
+			gpuPassCsv = argv[++i];
+		else if (arg == "--gpu-models")
+			gpuPassModels = true;
+		else if (arg == "--hud")
+			showHud = true;
+		else if (arg == "--load-report" && i + 1 < argc)
+			loadReportPath = argv[++i];
+		else if (arg == "--record" && i + 1 < argc)
+			recordPath = argv[++i];
+		else if (arg == "--replay" && i + 1 < argc)
+			replayPath = argv[++i];
+		else if (arg == "--replay-fixed")
+			replayFixed = true;
+		else if (arg == "--scale-csv" && i + 1 < argc)
+			scaleCsv = argv[++i];
+		else if (arg == "--scale-character" && i + 1 < argc)
+			scaleCharacter = argv[++i];
+		else if (arg == "--scale-seed" && i + 1 < argc)
+			scaleSeed = (unsigned int)std::stoul(argv[++i]);
+		else if (arg == "--scene" && i + 1 < argc)
+			scenePath = argv[++i];
+		else if (arg == "--compile-scene" && i + 2 < argc)
+		{
+			compileSceneSource = argv[++i];
+			compileSceneOutput = argv[++i];
+		}
+	}
+	if (!replayPath.empty() && !input.Replay(replayPath, replayFixed ? FIXED_FRAME_SECONDS : 0.0))
+		return EXIT_FAILURE;
+	if (!recordPath.empty())
 	{
-		// Si falla al crear la ventana, muestra error y termina el programa
-		std::cout << "Failed to create GLFW window" << std::endl;
-		glfwTerminate();
+		if (headless || !replayPath.empty())
+			std::cout << "ERROR::INPUT:: --record necesita la ventana y no se combina con --replay" << std::endl;
+		else if (!input.Record(recordPath))
+			return EXIT_FAILURE;
+	}
+	if (!flythroughPath.empty() && !flythrough.Load(flythroughPath))
 		return EXIT_FAILURE;
+	LoadReport::Enable(!loadReportPath.empty());
+
+	// --compile-scene no necesita contexto; la escena se abre solo en los caminos que la usan (bucle principal,
+	// --bench-lighting y --bench-transparency), los dems benchmarks funcionan sin el archivo
+	if (!compileSceneOutput.empty())
+	{
+		SceneFile source;
+		return source.Load(compileSceneSource) && source.Compile(compileSceneOutput) ? EXIT_SUCCESS : EXIT_FAILURE;
 	}
-	glfwMakeContextCurrent(window); // Establece el contexto de OpenGL para esta ventana
 
-	// Obtener las dimensiones reales del framebuffer 
-	glfwGetFramebufferSize(window, &SCREEN_WIDTH, &SCREEN_HEIGHT);
+	GLFWwindow* window = nullptr;
+	HeadlessContext headlessContext;
+	if (headless)
+	{
+		// Contexto sin ventana: EGL surfaceless u OSMesa (ver HeadlessContext)
+		if (!headlessContext.Create())
+			return EXIT_FAILURE;
+		SCREEN_WIDTH = headlessWidth;
+		SCREEN_HEIGHT = headlessHeight;
+	}
+	else
+	{
+		// Inicializar GLFW
+		glfwInit();
 
-	// Asignar funciones callback para teclado y mouse
-	glfwSetKeyCallback(window, KeyCallback);
-	glfwSetCursorPosCallback(window, MouseCallback);
+		// Crear la ventana principal del proyecto 
+		window = glfwCreateWindow(WIDTH, HEIGHT, "Proyecto Final", nullptr, nullptr);
+		if (nullptr == window)
+		{
+			// Si falla al crear la ventana, muestra error y termina el programa
+			std::cout << "Failed to create GLFW window" << std::endl;
+			glfwTerminate();
+			return EXIT_FAILURE;
+		}
+		glfwMakeContextCurrent(window); // Establece el contexto de OpenGL para esta ventana
 
-	// Oculta el cursor y lo bloquea en el centro de la pantalla para control de cmara estilo FPS
-	glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+		// Obtener las dimensiones reales del framebuffer 
+		glfwGetFramebufferSize(window, &SCREEN_WIDTH, &SCREEN_HEIGHT);
+
+		// Asignar funciones callback para teclado y mouse; con --replay la entrada sale de la grabacin
+		if (!input.Replaying())
+		{
+			glfwSetKeyCallback(window, KeyCallback);
+			glfwSetCursorPosCallback(window, MouseCallback);
+		}
+
+		// Oculta el cursor y lo bloquea en el centro de la pantalla para control de cmara estilo FPS
+		glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+	}
 
 	// Inicializar GLEW 
 	glewExperimental = GL_TRUE;
-	if (GLEW_OK != glewInit()) {
+	GLenum glewStatus = glewInit();
+	if (GLEW_OK != glewStatus && !(headless && HeadlessContext::GlewReady(glewStatus))) {
 		std::cout << "Failed to initialize GLEW" << std::endl;
 		return EXIT_FAILURE;
 	}
+	if (headless)
+	{
+		std::cout << "Headless: " << headlessContext.Backend() << ", " << glGetString(GL_RENDERER) << ", "
+			<< SCREEN_WIDTH << "x" << SCREEN_HEIGHT << ", " << headlessFrames << " frames" << std::endl;
+	}
+
+	// Con --profile la captura empieza antes de cargar shaders y modelos
+	Profiler::SetThreadName("render");
+	if (!profilePath.empty())
+	{
+		if (!Profiler::Compiled())
+			std::cout << "Profiler: compilado sin ENABLE_PROFILER, la captura quedara vacia" << std::endl;
+		Profiler::Start();
+	}
 
 	// Definir el rea de renderizado (viewport) y habilitar caractersticas grficas
 	glViewport(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
 	glEnable(GL_DEPTH_TEST); // Para que OpenGL respete profundidad al dibujar
-	glEnable(GL_BLEND);      // Activar blending (necesario para transparencias)
 
 	// Cargar y compilar los distintos shaders usados en la escena
 	Shader lightingShader("Shaders/lighting.vs", "Shaders/lighting.frag");  // Shader principal
 	Shader lampShader("Shaders/lamp.vs", "Shaders/lamp.frag");              // Shader para dibujar la fuente de luz
 	Shader SkyBoxshader("Shaders/SkyBox.vs", "Shaders/SkyBox.frag");        // Shader para el cielo (skybox)
-	Shader animShader("Shaders/anim2.vs", "Shaders/anim2.frag");            // Shader animado 1 (pantalla, humo)
 	Shader animShader2("Shaders/anim.vs", "Shaders/anim.frag");             // Shader animado 2 (pantalla secundaria)
+	Shader lightingAlphaTestShader("Shaders/lighting.vs", "Shaders/lighting.frag", "#define ALPHA_TEST\n"); // Variante con discard para mallas recortadas
+	Shader depthShader("Shaders/depth.vs", "Shaders/depth.frag");           // Pre-pase de profundidad
+	Shader lightingOitShader("Shaders/lighting.vs", "Shaders/lighting.frag", "#define WEIGHTED_OIT\n"); // Transparentes ponderados
+	Shader oitCompositeShader("Shaders/fullscreen.vs", "Shaders/oitComposite.frag");                   // Composicin de transparentes
+
+	// Todas las luces se suben en un solo Uniform Buffer que lee el shader de iluminacin
+	LightBuffer sceneLights;
+	LightBuffer::BindProgram(lightingShader.Program);
+	LightBuffer::BindProgram(lightingAlphaTestShader.Program);
+	LightBuffer::BindProgram(lightingOitShader.Program);
+
+	// --bench-lighting: compara el shader de iluminacin anterior contra el optimizado a 1080p y 4K y termina
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::string(argv[i]) == "--bench-lighting")
+		{
+			if (!scene.Open(scenePath))
+				return EXIT_FAILURE;
+			SetupSceneLights(sceneLights);
+			LightingBenchmark().Run(sceneLights);
+			glfwTerminate();
+			return EXIT_SUCCESS;
+		}
 
-	// Cargar todos los modelos 3D usados en el recorrido virtual
-	Model Piso((char*)"Models/Piso/cuphead.obj");
-	Model Cuphead((char*)"Models/casa-taza/cuphead.obj");
-	Model Puerta((char*)"Models/Puerta/cuphead.obj");
-	Model sillon((char*)"Models/sillon/sillon.obj");
-	Model piano((char*)"Models/piano/piano.obj");
-	Model estante((char*)"Models/estante/Estante.fbx");
-	Model radio((char*)"Models/radio/radio.fbx");
-	Model fonografo((char*)"Models/fonografo/fonografo.fbx");
-	Model sillaMecedora((char*)"Models/sillaMecedora/mecedora.obj");
-	Model espada((char*)"Models/espada/espada.obj");
-	Model chimenea((char*)"Models/chimenea/chimenea/cuphead.obj");
-	Model estante2((char*)"Models/Estante2/Estante/cuphead.obj");
+		// --bench-transparency: mezcla ordenada contra transparencia ponderada con muchos planos superpuestos
+		if (std::string(argv[i]) == "--bench-transparency")
+		{
+			if (!scene.Open(scenePath))
+				return EXIT_FAILURE;
+			SetupSceneLights(sceneLights);
+			TransparencyBenchmark().Run(sceneLights);
+			glfwTerminate();
+			return EXIT_SUCCESS;
+		}
 
+		// --bench-animation <ruta>: evaluacin recursiva contra esqueleto aplanado de un modelo animado
+		if (std::string(argv[i]) == "--bench-animation" && i + 1 < argc)
+		{
+			AnimationBenchmark().Run(argv[i + 1]);
+			glfwTerminate();
+			return EXIT_SUCCESS;
+		}
 
+		// --bench-crowd <ruta>: muchos personajes con el mismo modelo animado, copias contra instancias y la
+		// etapa de animacin (AnimationSystem) en serie, en paralelo y con niveles de detalle
+		if (std::string(argv[i]) == "--bench-crowd" && i + 1 < argc)
+		{
+			CrowdBenchmark().Run(argv[i + 1]);
+			glfwTerminate();
+			return EXIT_SUCCESS;
+		}
 
-	
+		// --bench-scale: vecindarios de tamao creciente con los modelos de la escena (ver ScaleBenchmark)
+		if (std::string(argv[i]) == "--bench-scale")
+		{
+			ScaleBenchmark().Run(scaleCharacter, scaleCsv, scaleSeed);
+			glfwTerminate();
+			return EXIT_SUCCESS;
+		}
+	}
+
+	// Leer la escena y cargar todos sus modelos 3D (cada ruta una sola vez)
+	if (!scene.Open(scenePath))
+		return EXIT_FAILURE;
+	scene.LoadModels();
+
+	// Objetos del frame y contador de fragmentos para medir el sobre-dibujo
+	RenderQueue sceneQueue;
+	FragmentCounter shadedFragments;
 
+	// Tiempo de GPU de cada pase (y de cada objeto con --gpu-models)
+	GpuPassTimer gpuPasses;
+	if (!gpuPassCsv.empty())
+		gpuPasses.OpenCsv(gpuPassCsv);
+	if (gpuPassModels)
+		sceneQueue.modelTimer = &gpuPasses;
 
-	Model Buro((char*)"Models/Buro/Buro_base.obj");
-	Model Buro_cajon((char*)"Models/Buro/Buro_cajon.obj");
-	Model Humo((char*)"Models/Misc/humo/humo.obj");
-	Model Lampara((char*)"Models/Lampara/lampara.obj");
+	// Grficas de tiempo, pases de GPU, contadores y memoria sobre la imagen
+	PerformanceHud hud;
+	hud.visible = showHud;
+
+	// La escena se dibuja fuera de pantalla para que los transparentes ponderados compartan su depth buffer;
+	// al final del frame se copia a la ventana
+	Framebuffer sceneTarget(SCREEN_WIDTH, SCREEN_HEIGHT);
+	OitBuffer transparency(SCREEN_WIDTH, SCREEN_HEIGHT, sceneTarget.depthTexture);
+
+	// Humo de la chimenea: 4096 partculas que viven 4 segundos cada una
+	ParticleSystem smoke(4096, glm::vec3(-2.90f, 2.65f, -2.0f), 4.0f, SCREEN_WIDTH, SCREEN_HEIGHT);
 
 	//Otros modelos
 	
@@ -366,30 +632,85 @@ int main()
 	// Calcula el campo visual en base al zoom de la cmara y el tamao de la pantalla
 	glm::mat4 projection = glm::perspective(camera.GetZoom(),
 		(GLfloat)SCREEN_WIDTH / (GLfloat)SCREEN_HEIGHT,
-		0.1f, 1000.0f);
+		NEAR_PLANE, FAR_PLANE);
 	glEnable(GL_DEPTH_TEST);
 
+	if (!loadReportPath.empty())
+	{
+		LoadReport::PrintTable();
+		LoadReport::WriteJson(loadReportPath);
+		LoadReport::Enable(false);
+	}
+
+	std::chrono::steady_clock::time_point loopStart = std::chrono::steady_clock::now();
+
 	// -----------------------------
 	// Bucle principal del juego/render
 	// -----------------------------
-	while (!glfwWindowShouldClose(window)) // Se repite hasta que el usuario cierre la ventana
+	// Se repite hasta que el usuario cierre la ventana, hasta dibujar headlessFrames sin ventana o hasta
+	// terminar el recorrido de --flythrough
+	while (input.Replaying() ? !input.Finished() && (headless || !glfwWindowShouldClose(window))
+		: flythrough.Active() ? !flythrough.Finished() && (headless || !glfwWindowShouldClose(window))
+		: headless ? framesDrawn < headlessFrames : !glfwWindowShouldClose(window))
 	{
+		// Tecla T: las capturas empiezan y terminan entre frames, as ninguna zona queda a medias
+		if (profileToggle)
+		{
+			profileToggle = false;
+			if (Profiler::Recording())
+			{
+				Profiler::Stop();
+				Profiler::WriteChromeTrace(profilePath.empty() ? "profile.json" : profilePath);
+			}
+			else
+			{
+				if (!Profiler::Compiled())
+					std::cout << "Profiler: compilado sin ENABLE_PROFILER, la captura quedara vacia" << std::endl;
+				Profiler::Start();
+			}
+		}
+		// Tecla F5: vuelve a leer el archivo de escena; solo se cargan los modelos nuevos
+		if (sceneReload)
+		{
+			sceneReload = false;
+			scene.Reload();
+		}
+		PROFILE_SCOPE("Frame");
+		std::chrono::steady_clock::time_point frameStart = std::chrono::steady_clock::now();
+
+		// Con --flythrough: la cmara va al punto del recorrido de este frame y empieza la medicin
+		if (flythrough.Active())
+			flythrough.BeginFrame(camera);
+		gpuPasses.BeginFrame();
+		gpuPasses.BeginPass("Frame");
+
+		// Con --record o --replay el tiempo del frame es el que se guarda o se lee de la grabacin
+		if (input.Active())
+			input.BeginFrame(input.Recording() ? glfwGetTime() : 0.0);
+
 		// -----------------------------
 		// Clculo de deltaTime (tiempo entre frames)
 		// -----------------------------
-		GLfloat currentFrame = glfwGetTime();                // Tiempo actual (segundos desde inicio)
+		GLfloat currentFrame = AppTime();                    // Tiempo actual (segundos desde inicio)
 		deltaTime = currentFrame - lastFrame;                // Delta = diferencia de tiempo
 		lastFrame = currentFrame;                            // Actualizar el ltimo tiempo
 
 		// -----------------------------
 		// Procesamiento de entradas (teclado, mouse, etc.)
 		// -----------------------------
-		glfwPollEvents();    // Captura eventos de entrada
+		if (!headless)
+		{
+			PROFILE_SCOPE("glfwPollEvents");
+			glfwPollEvents();    // Captura eventos de entrada
+		}
+		if (input.Replaying())
+			input.DispatchFrame(window, KeyCallback, MouseCallback);  // Los eventos grabados en este frame
 		DoMovement();        // Aplica los movimientos (cmara y animaciones activas)
 
 		// -----------------------------
 		// Limpieza de buffers de color y profundidad
 		// -----------------------------
+		sceneTarget.Bind();                                  // Dibuja en el framebuffer de la escena
 		glClearColor(0.1f, 0.1f, 0.1f, 1.0f);                // Color de fondo (gris oscuro)
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);  // Limpia buffers antes de dibujar
 
@@ -399,75 +720,10 @@ int main()
 		lightingShader.Use();  // Activa el shader lightingShader (programa GLSL)
 
 		// -----------------------------
-		// Pasar posicin de la cmara al shader (para clculos de iluminacin especular)
-		// -----------------------------
-		GLint viewPosLoc = glGetUniformLocation(lightingShader.Program, "viewPos");
-		glUniform3f(viewPosLoc, camera.GetPosition().x, camera.GetPosition().y, camera.GetPosition().z);
-
-		// -----------------------------
-		// Propiedad del material general (brillo especular)
-		// -----------------------------
-		glUniform1f(glGetUniformLocation(lightingShader.Program, "material.shininess"), 32.0f);
-
-		// -----------------------------
-		// Luz direccional (como el sol o luz general ambiental)
-		// -----------------------------
-		glUniform3f(glGetUniformLocation(lightingShader.Program, "dirLight.direction"), -0.2f, -1.0f, -0.3f);
-		glUniform3f(glGetUniformLocation(lightingShader.Program, "dirLight.ambient"), 0.704f, 0.57f, 0.475f);
-		glUniform3f(glGetUniformLocation(lightingShader.Program, "dirLight.diffuse"), 0.1f, 0.1f, 0.1f);
-		glUniform3f(glGetUniformLocation(lightingShader.Program, "dirLight.specular"), 0.1f, 0.1f, 0.1f);
-
-		// -----------------------------
-		// Luz puntual 0 - Exterior (carpa)
-		// -----------------------------
-		glUniform3f(glGetUniformLocation(lightingShader.Program, "pointLights[0].position"), pointLightPositions[0].x, pointLightPositions[0].y, pointLightPositions[0].z);
-		glUniform3f(glGetUniformLocation(lightingShader.Program, "pointLights[0].ambient"), 0.01f, 0.01f, 0.01f);
-		glUniform3f(glGetUniformLocation(lightingShader.Program, "pointLights[0].diffuse"), 0.10f, 0.10f, 0.01f);
-		glUniform3f(glGetUniformLocation(lightingShader.Program, "pointLights[0].specular"), 1.0f, 1.0f, 0.0f);
-		glUniform1f(glGetUniformLocation(lightingShader.Program, "pointLights[0].constant"), 1.0f);
-		glUniform1f(glGetUniformLocation(lightingShader.Program, "pointLights[0].linear"), 0.9917f);
-		glUniform1f(glGetUniformLocation(lightingShader.Program, "pointLights[0].quadratic"), 3.16f);
-
-		// -----------------------------
-		// Luz puntual 1 - Interior (recmara)  
-		// -----------------------------
-		glUniform3f(glGetUniformLocation(lightingShader.Program, "pointLights[1].position"), pointLightPositions[1].x, pointLightPositions[1].y - 1.5f, pointLightPositions[1].z);
-		glUniform3f(glGetUniformLocation(lightingShader.Program, "pointLights[1].ambient"), 0.05f, 0.05f, 0.05f);
-		glUniform3f(glGetUniformLocation(lightingShader.Program, "pointLights[1].diffuse"), LightP1.x, LightP1.y, LightP1.z);
-		glUniform3f(glGetUniformLocation(lightingShader.Program, "pointLights[1].specular"), LightP1.x, LightP1.y, LightP1.z);
-		glUniform1f(glGetUniformLocation(lightingShader.Program, "pointLights[1].constant"), 1.0f);
-		glUniform1f(glGetUniformLocation(lightingShader.Program, "pointLights[1].linear"), 0.50f);    // Subido
-		glUniform1f(glGetUniformLocation(lightingShader.Program, "pointLights[1].quadratic"), 0.50f); // Subidsimo para cada fuerte
-
-
-
-		// -----------------------------
-		// Luz puntual 2 - Luz solar (blanca, lejana)
+		// Luces: direccional, tres puntuales y spotlight en una sola copia al Uniform Buffer
 		// -----------------------------
-		glUniform3f(glGetUniformLocation(lightingShader.Program, "pointLights[2].position"), pointLightPositions[2].x, pointLightPositions[2].y, pointLightPositions[2].z);
-		glUniform3f(glGetUniformLocation(lightingShader.Program, "pointLights[2].ambient"), 0.05f, 0.05f, 0.05f);
-		glUniform3f(glGetUniformLocation(lightingShader.Program, "pointLights[2].diffuse"), 1.0f, 1.0f, 1.0f);
-		glUniform3f(glGetUniformLocation(lightingShader.Program, "pointLights[2].specular"), 1.0f, 1.0f, 1.0f);
-		glUniform1f(glGetUniformLocation(lightingShader.Program, "pointLights[2].constant"), 1.0f);
-		glUniform1f(glGetUniformLocation(lightingShader.Program, "pointLights[2].linear"), 0.14f);
-		glUniform1f(glGetUniformLocation(lightingShader.Program, "pointLights[2].quadratic"), 0.07f);
-
-		// -----------------------------
-		// Luz tipo spotlight (foco hacia abajo desde la lmpara interior)
-		// -----------------------------
-		glUniform3f(glGetUniformLocation(lightingShader.Program, "spotLight.position"), pointLightPositions[1].x, pointLightPositions[1].y, pointLightPositions[1].z);
-		glUniform3f(glGetUniformLocation(lightingShader.Program, "spotLight.direction"), 0.0f, -1.0f, 0.0f);
-		glUniform3f(glGetUniformLocation(lightingShader.Program, "spotLight.ambient"), 0.05f, 0.05f, 0.05f);
-		glUniform3f(glGetUniformLocation(lightingShader.Program, "spotLight.diffuse"), LightP1.x, LightP1.y, LightP1.z);
-		glUniform3f(glGetUniformLocation(lightingShader.Program, "spotLight.specular"), LightP1.x, LightP1.y, LightP1.z);
-		glUniform1f(glGetUniformLocation(lightingShader.Program, "spotLight.constant"), 1.0f);
-		glUniform1f(glGetUniformLocation(lightingShader.Program, "spotLight.linear"), 0.09f);
-		glUniform1f(glGetUniformLocation(lightingShader.Program, "spotLight.quadratic"), 0.032f);
-		glUniform1f(glGetUniformLocation(lightingShader.Program, "spotLight.cutOff"), glm::cos(glm::radians(30.5f)));     // ngulo de corte interior
-		glUniform1f(glGetUniformLocation(lightingShader.Program, "spotLight.outerCutOff"), glm::cos(glm::radians(45.0f))); // ngulo de corte exterior
-
-		// (Ya estaba puesta antes pero se repite) - brillo general del material
-		glUniform1f(glGetUniformLocation(lightingShader.Program, "material.shininess"), 32.0f);
+		SetupSceneLights(sceneLights);
+		sceneLights.Upload();
 
 		// -----------------------------
 		// Transformaciones de cmara (vista)
@@ -476,306 +732,110 @@ int main()
 		view = camera.GetViewMatrix(); // Calcula la matriz de vista (posicin y orientacin)
 
 		// -----------------------------
-		// Obtener ubicaciones de uniformes para model, view, projection
+		// Posicin de la cmara, view y projection para el shader de iluminacin y su variante con recorte alfa
 		// -----------------------------
-		GLint modelLoc = glGetUniformLocation(lightingShader.Program, "model");
-		GLint viewLoc = glGetUniformLocation(lightingShader.Program, "view");
-		GLint projLoc = glGetUniformLocation(lightingShader.Program, "projection");
+		SetLightingUniforms(lightingAlphaTestShader, view, projection);
+		SetLightingUniforms(lightingOitShader, view, projection);
+		SetLightingUniforms(lightingShader, view, projection);
+
+		// Ubicaciones de uniformes; los shaders animados y la lmpara las vuelven a consultar ms abajo
+		GLint modelLoc, viewLoc, projLoc;
 
 		// -----------------------------
-		// Enviar matrices al shader
+		// Registrar los objetos del frame; se dibujan despus por pases (ver RenderQueue)
 		// -----------------------------
-		glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
-		glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projection));
+		sceneQueue.Clear();
 
 		// -----------------------------
 		// Preparar para dibujar objetos
 		// -----------------------------
-		glBindVertexArray(VAO);             // Activa el VAO con configuracin de atributos
-		glm::mat4 tmp = glm::mat4(1.0f);    // Matriz temporal (no se usa en esta seccin)
-
-
-		//Carga de modelo 
+		RenderStats::BindVertexArray(VAO); // Activa el VAO con configuracin de atributos
 
 		view = camera.GetViewMatrix(); // Obtiene la matriz de vista desde la cmara
 
+		// --- Canales de animacin de la escena (teclas 2, 4 y 5) ---
+		scene.SetChannel("cajon", tras_cajon);
+		scene.SetChannel("mecedora", anim_mecedora ? glm::sin(AppTime() * 2.0f) * 10.0f : 0.0f);  // balanceo en grados
 
+		// Vibracin de la radio con la msica
+		float velocidadMusica = 12.0f;
+		float fuerzaBajos = 0.01f;
+		scene.SetChannel("radio", anim_radio ? std::abs(glm::sin(AppTime() * velocidadMusica)) * fuerzaBajos : 0.0f);
 
-		// --- Piso ---
-		glUniform3f(glGetUniformLocation(lightingShader.Program, "material.ambient"), 0.0f, 0.0f, 0.0f);
-		glUniform3f(glGetUniformLocation(lightingShader.Program, "material.diffuse"), 0.01f, 0.0f, 0.01f);
-		glUniform3f(glGetUniformLocation(lightingShader.Program, "material.specular"), 0.0f, 0.0f, 0.0f);
-		glUniform1f(glGetUniformLocation(lightingShader.Program, "material.shininess"), 1.0f);
-		glm::mat4 model = glm::mat4(1.0f);
-		model = glm::rotate(model, glm::radians(90.0f), glm::vec3(0.0f, 1.0f, 0.0f));  
-		glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-		Piso.Draw(lightingShader);
-
-		// --- Casa  ---
-		glUniform3f(glGetUniformLocation(lightingShader.Program, "material.ambient"), 0.0f, 0.0f, 0.0f);
-		glUniform3f(glGetUniformLocation(lightingShader.Program, "material.diffuse"), 0.0f, 0.0f, 0.0f);
-		glUniform3f(glGetUniformLocation(lightingShader.Program, "material.specular"), 0.0f, 0.0f, 0.0f);
-		glUniform1f(glGetUniformLocation(lightingShader.Program, "material.shininess"), 1.0f);
-		model = glm::mat4(1);
-		model = glm::rotate(model, glm::radians(90.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-		
-		glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-		Cuphead.Draw(lightingShader);
-
-		// --- Puerta ---
-		glUniform3f(glGetUniformLocation(lightingShader.Program, "material.ambient"), 0.0f, 0.0f, 0.0f);
-		glUniform3f(glGetUniformLocation(lightingShader.Program, "material.diffuse"), 0.0f, 0.0f, 0.0f);
-		glUniform3f(glGetUniformLocation(lightingShader.Program, "material.specular"), 0.0f, 0.0f, 0.0f);
-		glUniform1f(glGetUniformLocation(lightingShader.Program, "material.shininess"), 1.0f);
-		model = glm::mat4(1);
-		model = glm::rotate(model, glm::radians(90.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-
-		glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-		Puerta.Draw(lightingShader);
-
-		
-
-		// --- Configuracin de materiales para la siguiente parte (bur animado, puertas, etc.) ---
-		glUniform3f(glGetUniformLocation(lightingShader.Program, "material.ambient"), 0.1f, 0.1f, 0.1f);
-		glUniform3f(glGetUniformLocation(lightingShader.Program, "material.diffuse"), 0.619, 0.313, 0);
-		glUniform3f(glGetUniformLocation(lightingShader.Program, "material.specular"), 0.1, 0.1, 0.1);
-		glUniform1f(glGetUniformLocation(lightingShader.Program, "material.shininess"), 1.0f);
-
-		// --- Base del bur ---
-		model = glm::mat4(1); // Matriz de modelo inicial
-		model = glm::rotate(model, glm::radians(90.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-		glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-		Buro.Draw(lightingShader); // Dibuja el modelo base del bur
-
-		// --- Cajn del bur (CORREGIDO) ---
-		model = glm::mat4(1);
-		model = glm::translate(model, glm::vec3(-tras_cajon, 0.0f, 0.0f));
-		model = glm::rotate(model, glm::radians(90.0f), glm::vec3(0.0f, 1.0f, 0.0));
-		glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-		Buro_cajon.Draw(lightingShader);
-
-		// --- Lampara (con transparencia) ---
-		glEnable(GL_BLEND); // Activa mezcla para transparencia
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); // Configura la frmula de mezcla
-		glUniform4f(glGetUniformLocation(lightingShader.Program, "colorAlpha"), 1.0f, 1.0f, 0.0f, 0.95f); // Color amarillo semitransparente
-		model = glm::mat4(1);
-		model = glm::rotate(model, glm::radians(90.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-		glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-		Lampara.Draw(lightingShader);
-
-
-		// --- Restaurar configuracin sin transparencia ---
-		glDisable(GL_BLEND);
-		glUniform4f(glGetUniformLocation(lightingShader.Program, "colorAlpha"), 1.0f, 1.0f, 1.0f, 1.0f);
-		glUniform1i(glGetUniformLocation(lightingShader.Program, "trans"), 1);
-
-		// --- Sillon ---
-		model = glm::mat4(1);
-		model = glm::translate(model, glm::vec3(0.2f, 0.0f, -0.9f));
-		model = glm::scale(model, glm::vec3(1.3f));
-		model = glm::rotate(model, glm::radians(90.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-		glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-		sillon.Draw(lightingShader);
-
-		// --- Piano ---
-		model = glm::mat4(1);
-		model = glm::translate(model, glm::vec3(-3.5f, 0.0f, 3.0f));
-		model = glm::scale(model, glm::vec3(0.9f));
-		model = glm::rotate(model, glm::radians(90.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-		glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-		piano.Draw(lightingShader);
-
-		//--- Estante ---
-		model = glm::mat4(1.0f);
-		// 1. Mover
-		model = glm::translate(model, glm::vec3(-3.5f, 0.0f, -1.0f));
-		model = glm::scale(model, glm::vec3(0.2f));
-
-		model = glm::rotate(model, glm::radians(-90.0f), glm::vec3(1.0f, 0.0f, 0.0f));
-		model = glm::rotate(model, glm::radians(-90.0f), glm::vec3(0.0f, 0.0f, 1.0f));
-		model = glm::rotate(model, glm::radians(-90.0f), glm::vec3(0.0f, 0.0f, 1.0f));
-		model = glm::rotate(model, glm::radians(-90.0f), glm::vec3(0.0f, 0.0f, 1.0f));
-
-		glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-		estante.Draw(lightingShader);
-
-		//--- Radio ---
-		model = glm::mat4(1);
-
-		// Posicin original de la radio segn tu cdigo
-		glm::vec3 posRadio = glm::vec3(-3.5f, 0.0f, -2.5f);
-
-		// --- INICIO ANIMACIN VIBRACIN ---
-		if (anim_radio) {
-			float velocidadMusica = 12.0f;
-			float fuerzaBajos = 0.01f;
-			float vibracion = std::abs(glm::sin(glfwGetTime() * velocidadMusica)) * fuerzaBajos;
-			posRadio.x += vibracion;
-		}
-		// --- FIN ANIMACIN ---
-
-		model = glm::translate(model, posRadio); // Usamos la posicin con vibracin
-		model = glm::scale(model, glm::vec3(0.5f));
-		model = glm::rotate(model, glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f));
-		model = glm::rotate(model, glm::radians(90.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-
-		glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-		radio.Draw(lightingShader);
-
-		//--- Fonografo ---
-		model = glm::mat4(1);
-		model = glm::translate(model, glm::vec3(-4.6f, 0.5f, 3.0f));
-		model = glm::scale(model, glm::vec3(0.7f));
-		model = glm::rotate(model, glm::radians(-90.0f), glm::vec3(1.0f, 0.0f, 0.0f));
-		model = glm::rotate(model, glm::radians(180.0f), glm::vec3(0.0f, 0.0f, 1.0f));
-		glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-		fonografo.Draw(lightingShader);
-
-		//--- Silla Mecedora ---
-		model = glm::mat4(1);
-		model = glm::translate(model, glm::vec3(-7.0f, 0.0f, 0.8f));
-		model = glm::scale(model, glm::vec3(0.02f));
-
-		// --- LGICA DE ANIMACIN CONDICIONAL ---
-		float anguloMecedora = 0.0f;
-
-		if (anim_mecedora) {
-
-			anguloMecedora = glm::sin(glfwGetTime() * 2.0f) * 10.0f;
-		}
-
-		model = glm::rotate(model, glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f));
-		model = glm::rotate(model, glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f));
-
-		model = glm::rotate(model, glm::radians(180.0f + anguloMecedora), glm::vec3(0.0f, 0.0f, 1.0f));
-
-		model = glm::rotate(model, glm::radians(90.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-		glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-		sillaMecedora.Draw(lightingShader);
-
-		//--- Espada ---
-		model = glm::mat4(1);
-		model = glm::translate(model, glm::vec3(-4.11f, 1.5f, 0.1f));
-		model = glm::scale(model, glm::vec3(0.3f));
-		model = glm::rotate(model, glm::radians(-90.0f), glm::vec3(1.0f, 0.0f, 0.0f));
-		model = glm::rotate(model, glm::radians(90.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-		model = glm::rotate(model, glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f));
-		glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-		espada.Draw(lightingShader);
-
-		//-- Chimenea ---
-		model = glm::mat4(1);
-		model = glm::translate(model, glm::vec3(-4.0f, 0.0f, 1.0f));
-		model = glm::scale(model, glm::vec3(1.0f));
-		model = glm::rotate(model, glm::radians(90.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-		glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-		chimenea.Draw(lightingShader);
-
-		//-- Estante ---
-		model = glm::mat4(1);
-		model = glm::translate(model, glm::vec3(-6.0f, 0.0f, -0.5f));
-		model = glm::scale(model, glm::vec3(1.0f));
-		model = glm::rotate(model, glm::radians(90.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-		model = glm::rotate(model, glm::radians(180.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-		glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-		estante2.Draw(lightingShader);
+		// --- Objetos de la escena: matrices de mundo calculadas al cargarla ---
+		scene.Submit(sceneQueue);
 
 		// --- Animacin de tiempo ---
 		speed = 0.5f;
-		tiempo = speed * glfwGetTime();
-		glUniform1f(glGetUniformLocation(lightingShader.Program, "time"), tiempo);
-
-		// --- Preparar objeto transparente (comentado) ---
-		glEnable(GL_BLEND);
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-		model = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, 0.0f));
-		model = glm::mat4(1);
-		model = glm::scale(model, glm::vec3(1.0f));
-		glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-		glUniform1f(glGetUniformLocation(lightingShader.Program, "transparencia"), 0.0);
-		//objTras.Draw(lightingShader); // Lnea comentada, probablemente objeto transparente an no definido
-		glDisable(GL_BLEND);
-		glEnable(GL_DEPTH_TEST);
-		glBindVertexArray(0);
+		tiempo = speed * AppTime();
+		RenderStats::Uniform1f(glGetUniformLocation(lightingShader.Program, "time"), tiempo);
+		RenderStats::BindVertexArray(0);
 
 		// --- Shader para pantalla animada ---
 		animShader2.Use();
 		speed = 0.001f;
-		tiempo = speed * glfwGetTime();
+		tiempo = speed * AppTime();
 
 		modelLoc = glGetUniformLocation(animShader2.Program, "model");
 		viewLoc = glGetUniformLocation(animShader2.Program, "view");
 		projLoc = glGetUniformLocation(animShader2.Program, "projection");
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-		glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
-		glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projection));
-		glUniform1f(glGetUniformLocation(animShader2.Program, "time"), tiempo);
-
-
-		glBindVertexArray(0); // Desvincula VAO
-
-
-		// --- Shader para animacin de partculas (humo) ---
-		animShader.Use();
-
-		// 1. CONTROL DE VELOCIDAD:
-		// Para que vaya ms despacio, reduce este nmero.
-		// Antes tenas 3.8f (muy rpido). Prueba con 1.0f o 0.5f.
-		speed = 4.0f;
-
-		tiempo = speed * glfwGetTime();
-
-		// Ubicamos las variables uniformes para el shader animado
-		modelLoc = glGetUniformLocation(animShader.Program, "model");
-		viewLoc = glGetUniformLocation(animShader.Program, "view");
-		projLoc = glGetUniformLocation(animShader.Program, "projection");
+		RenderStats::UniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
+		RenderStats::UniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projection));
+		RenderStats::Uniform1f(glGetUniformLocation(animShader2.Program, "time"), tiempo);
 
-		glEnable(GL_BLEND);
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-		// Enviamos las matrices view y projection
-		glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
-		glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projection));
-
-		glUniform1f(glGetUniformLocation(animShader.Program, "time"), tiempo);
-		glUniform4f(glGetUniformLocation(animShader.Program, "colorAlpha"), 1.0f, 1.0f, 1.0f, 0.01f);
+		RenderStats::BindVertexArray(0); // Desvincula VAO
 
-		glm::vec3 cameraPos = camera.GetPosition();
 
-		// 2. CONTROL DE POSICIN:
-		// Cambia estos 3 nmeros para mover el humo de lugar:
+		// --- Simulacin del humo (en la GPU, sin lectura de vuelta) ---
+		// CONTROL DE POSICIN:
+		// Cambia estos 3 nmeros para mover el emisor del humo:
 		// X (Izquierda/Derecha), Y (Arriba/Abajo), Z (Fondo/Frente)
-		glm::vec3 humoPosition = glm::vec3(-2.90f, 3.0f, -2.0f);
-
-		model = glm::mat4(1.0f);
-		model = glm::translate(model, humoPosition);
-
-		// Aplica rotacin para que el humo siempre mire hacia la cmara (billboarding)
-		// Esto hace que el humo parezca 3D aunque sea una imagen plana
-		model[0][0] = view[0][0];
-		model[0][1] = view[1][0];
-		model[0][2] = view[2][0];
-		model[1][0] = view[0][1];
-		model[1][1] = view[1][1];
-		model[1][2] = view[2][1];
-		model[2][0] = view[0][2];
-		model[2][1] = view[1][2];
-		model[2][2] = view[2][2];
+		smoke.emitter = glm::vec3(-2.90f, 2.65f, -2.0f);
+		smoke.halfResolution = smokeHalfResolution;
+		gpuPasses.BeginPass("Humo: simulacion");
+		smoke.Update(AppTime(), deltaTime);
+		gpuPasses.EndPass();
 
-		model = glm::scale(model, glm::vec3(0.534f, 0.70f, 0.333f));
+		RenderStats::BindVertexArray(0); // Desvincula cualquier VAO activo
 
-		glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-
-		Humo.Draw(animShader);
-
-		glDisable(GL_BLEND);
-		
 
+		// -----------------------------
+		// Pases de la geometra slida
+		// -----------------------------
+		// 1. Pre-pase de profundidad (opcional): llena el depth buffer sin sombrear
+		if (depthPrePass)
+		{
+			gpuPasses.BeginPass("Pre-pase de profundidad");
+			depthShader.Use();
+			RenderStats::UniformMatrix4fv(glGetUniformLocation(depthShader.Program, "view"), 1, GL_FALSE, glm::value_ptr(view));
+			RenderStats::UniformMatrix4fv(glGetUniformLocation(depthShader.Program, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+			sceneQueue.DrawDepth(depthShader);
+			gpuPasses.EndPass();
+		}
 
-		glBindVertexArray(0); // Desvincula cualquier VAO activo
+		// 2. Opacos (con GL_EQUAL si hubo pre-pase, as cada pxel se ilumina una sola vez)
+		// 3. Recortados con alfa, con la variante del shader que hace discard
+		shadedFragments.Begin();
+		gpuPasses.BeginPass("Opacos");
+		sceneQueue.DrawOpaque(lightingShader, depthPrePass);
+		gpuPasses.EndPass();
+		gpuPasses.BeginPass("Recortados");
+		sceneQueue.DrawAlphaTested(lightingAlphaTestShader);
+		gpuPasses.EndPass();
+		shadedFragments.End();
+
+		if (showFragmentStats)
+		{
+			showFragmentStats = false;
+			std::cout << "Fragmentos sombreados (opacos + recortados): " << shadedFragments.GetCount()
+				<< "  sobre-dibujo: " << shadedFragments.GetOverdraw(SCREEN_WIDTH, SCREEN_HEIGHT)
+				<< "  pre-pase: " << (depthPrePass ? "si" : "no") << std::endl;
+		}
 
 
 		// --- Renderizado del objeto de luz (lmpara pequea) ---
+		gpuPasses.BeginPass("Lampara");
 		lampShader.Use(); // Activamos el shader de lmpara
 
 		// Obtenemos las ubicaciones de las matrices
@@ -784,43 +844,140 @@ int main()
 		projLoc = glGetUniformLocation(lampShader.Program, "projection");
 
 		// Enviamos las matrices view y projection
-		glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
-		glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projection));
+		RenderStats::UniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
+		RenderStats::UniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projection));
 
 		// Posiciona la lmpara principal (no se usa directamente aqu)
-		model = glm::mat4(1);
+		glm::mat4 model = glm::mat4(1);
 		model = glm::translate(model, lightPos);
-		glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
+		RenderStats::UniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
 
 		// Dibuja la luz puntual como un pequeo cubo
-		glBindVertexArray(lightVAO);
+		RenderStats::BindVertexArray(lightVAO);
 		model = glm::mat4(1);
-		model = glm::translate(model, pointLightPositions[1]); // Posicin de la luz interior
+		model = glm::translate(model, interiorLampPosition); // Posicin de la luz interior
 		model = glm::scale(model, glm::vec3(0.1f)); // Escala el cubo para que sea pequeo (representa fuente de luz)
-		glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-		glDrawArrays(GL_TRIANGLES, 0, 36); // Dibuja el cubo de la lmpara
-		glBindVertexArray(0);
+		RenderStats::UniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
+		RenderStats::DrawArrays(GL_TRIANGLES, 0, 36); // Dibuja el cubo de la lmpara
+		RenderStats::BindVertexArray(0);
+		gpuPasses.EndPass();
 
 
 		// --- Renderizado del Skybox (ltimo en dibujarse) ---
-		glDepthFunc(GL_LEQUAL); // Permite pasar la prueba de profundidad cuando los valores sean iguales (para skybox)
+		gpuPasses.BeginPass("Skybox");
+		RenderStats::DepthFunc(GL_LEQUAL); // Permite pasar la prueba de profundidad cuando los valores sean iguales (para skybox)
 
 		SkyBoxshader.Use(); // Activa el shader del skybox
 		view = glm::mat4(glm::mat3(camera.GetViewMatrix())); // Elimina la traslacin de la matriz de vista (mantiene la rotacin)
-		glUniformMatrix4fv(glGetUniformLocation(SkyBoxshader.Program, "view"), 1, GL_FALSE, glm::value_ptr(view));
-		glUniformMatrix4fv(glGetUniformLocation(SkyBoxshader.Program, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+		RenderStats::UniformMatrix4fv(glGetUniformLocation(SkyBoxshader.Program, "view"), 1, GL_FALSE, glm::value_ptr(view));
+		RenderStats::UniformMatrix4fv(glGetUniformLocation(SkyBoxshader.Program, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
 
-		glBindVertexArray(skyboxVAO); // Vincula el VAO del cubo del skybox
+		RenderStats::BindVertexArray(skyboxVAO); // Vincula el VAO del cubo del skybox
 		glActiveTexture(GL_TEXTURE1); // Activa la textura para el skybox
-		glBindTexture(GL_TEXTURE_CUBE_MAP, cubemapTexture); // Enlaza la textura tipo cubemap
-		glDrawArrays(GL_TRIANGLES, 0, 36); // Dibuja el cubo del skybox
-		glBindVertexArray(0);
+		RenderStats::BindTexture(GL_TEXTURE_CUBE_MAP, cubemapTexture); // Enlaza la textura tipo cubemap
+		RenderStats::DrawArrays(GL_TRIANGLES, 0, 36); // Dibuja el cubo del skybox
+		RenderStats::BindVertexArray(0);
+
+		RenderStats::DepthFunc(GL_LESS); // Restaura el valor por defecto del test de profundidad
+		gpuPasses.EndPass();
 
-		glDepthFunc(GL_LESS); // Restaura el valor por defecto del test de profundidad
+		// --- Humo: partculas que se desvanecen contra la profundidad de la escena ---
+		gpuPasses.BeginPass("Humo");
+		smoke.Draw(camera.GetViewMatrix(), projection, sceneTarget, NEAR_PLANE, FAR_PLANE);
+		gpuPasses.EndPass();
 
+		// --- Transparentes (lmpara) ---
+		gpuPasses.BeginPass("Transparentes");
+		if (weightedOit)
+		{
+			// En cualquier orden: se acumulan y se componen sobre la escena en un solo pase
+			transparency.Begin();
+			sceneQueue.DrawWeighted(lightingOitShader);
+			transparency.Composite(oitCompositeShader, sceneTarget);
+		}
+		else
+		{
+			// Ordenados de atrs hacia adelante en la CPU
+			sceneQueue.DrawBlended(lightingShader, camera.GetPosition());
+		}
+		gpuPasses.EndPass();
+		gpuPasses.EndPass();  // Frame
+
+		// --- Panel de rendimiento: encima de la escena, antes de copiarla a la ventana o guardarla ---
+		if (hudToggle)
+		{
+			hudToggle = false;
+			hud.Toggle();
+		}
+		hud.AddFrame(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frameStart).count(),
+			gpuPasses.LastMs("Frame"));
+		if (hud.visible)
+		{
+			PROFILE_SCOPE("PerformanceHud");
+			gpuPasses.BeginPass("HUD");
+			sceneTarget.Bind();
+			hud.Draw(SCREEN_WIDTH, SCREEN_HEIGHT, gpuPasses);
+			gpuPasses.EndPass();
+		}
+		gpuPasses.EndFrame();
+		if (printGpuPasses)
+		{
+			printGpuPasses = false;
+			gpuPasses.PrintTable();
+		}
+
+		if (flythrough.Active())
+			flythrough.EndFrame();
+
+		if (headless)
+		{
+			// --- Sin ventana: el frame se queda en sceneTarget; opcionalmente se guarda en un PNG ---
+			if (!dumpPrefix.empty() && framesDrawn % dumpEvery == 0)
+			{
+				PROFILE_SCOPE("SavePng");
+				char number[16];
+				snprintf(number, sizeof(number), "%04u", framesDrawn);
+				sceneTarget.SavePng(dumpPrefix + number + ".png");
+			}
+		}
+		else
+		{
+			PROFILE_SCOPE("Present");
+
+			// --- Copia la escena a la ventana ---
+			sceneTarget.BlitColor(0, SCREEN_WIDTH, SCREEN_HEIGHT);
 
-		// --- Intercambio de buffers ---
-		glfwSwapBuffers(window); // Muestra en pantalla el frame renderizado
+			// --- Intercambio de buffers ---
+			glfwSwapBuffers(window); // Muestra en pantalla el frame renderizado
+		}
+		framesDrawn++;
+
+		RenderStats::EndFrame();
+		if (printRenderStats)
+		{
+			printRenderStats = false;
+			RenderStats::Print(RenderStats::Last());
+		}
+	}
+
+	if (Profiler::Recording())
+	{
+		Profiler::Stop();
+		Profiler::WriteChromeTrace(profilePath.empty() ? "profile.json" : profilePath);
+	}
+	if (flythrough.Active())
+		flythrough.Report(flythroughCsv, SCREEN_WIDTH, SCREEN_HEIGHT);
+	input.Close();
+	gpuPasses.Flush();
+	if (headless || flythrough.Active() || !gpuPassCsv.empty())
+		gpuPasses.PrintTable();
+	if (headless)
+	{
+		glFinish();
+		double loopMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loopStart).count();
+		std::cout << "Headless: " << framesDrawn << " frames en " << loopMs << " ms (" << loopMs / std::max(framesDrawn, 1u)
+			<< " ms por frame)" << std::endl;
+		RenderStats::Print(RenderStats::Last());
 	}
 
 
@@ -848,10 +1005,11 @@ int main()
 // Is called whenever a key is pressed/released via GLFW
 void KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mode)
 {
+	input.RecordKey(key, scancode, action, mode);
 
 
-
-	if (GLFW_KEY_ESCAPE == key && GLFW_PRESS == action)
+	// Sin ventana (--headless --replay) no hay nada que cerrar
+	if (GLFW_KEY_ESCAPE == key && GLFW_PRESS == action && window != nullptr)
 	{
 		glfwSetWindowShouldClose(window, GL_TRUE);
 	}
@@ -883,11 +1041,7 @@ void KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mode
 
 	if (keys[GLFW_KEY_3])
 	{
-		active = !active;
-		if (active)
-			LightP1 = glm::vec3(1.0f, 1.0f, 0.0f);
-		else
-			LightP1 = glm::vec3(0.0f, 0.0f, 0.0f);
+		active = !active;  // Luz interior y spotlight (canal luz_interior de la escena)
 	}
 	if (key == GLFW_KEY_4 && action == GLFW_PRESS)
 	{
@@ -897,11 +1051,53 @@ void KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mode
 	{
 		anim_radio = !anim_radio;
 	}
+	if (key == GLFW_KEY_P && action == GLFW_PRESS)
+	{
+		depthPrePass = !depthPrePass;
+	}
+	if (key == GLFW_KEY_O && action == GLFW_PRESS)
+	{
+		showFragmentStats = true;
+	}
+	if (key == GLFW_KEY_I && action == GLFW_PRESS)
+	{
+		weightedOit = !weightedOit;
+	}
+	if (key == GLFW_KEY_H && action == GLFW_PRESS)
+	{
+		smokeHalfResolution = !smokeHalfResolution;
+	}
+	if (key == GLFW_KEY_T && action == GLFW_PRESS)
+	{
+		profileToggle = true;
+	}
+	if (key == GLFW_KEY_G && action == GLFW_PRESS)
+	{
+		printGpuPasses = true;
+	}
+	if (key == GLFW_KEY_R && action == GLFW_PRESS)
+	{
+		printRenderStats = true;
+	}
+	if (key == GLFW_KEY_F1 && action == GLFW_PRESS)
+	{
+		hudToggle = true;
+	}
+	if (key == GLFW_KEY_F5 && action == GLFW_PRESS)
+	{
+		sceneReload = true;
+	}
 }
 
 // Callback que se ejecuta cada vez que se mueve el mouse dentro de la ventana
 void MouseCallback(GLFWwindow* window, double xPos, double yPos)
 {
+	input.RecordCursor(xPos, yPos);
+
+	// Durante --flythrough la cmara solo la mueve el recorrido
+	if (flythrough.Active())
+		return;
+
 	// Si es la primera vez que se mueve el mouse, se inicializan las coordenadas previas
 	if (firstMouse)
 	{
@@ -923,6 +1119,7 @@ void MouseCallback(GLFWwindow* window, double xPos, double yPos)
 // Funcin que actualiza el estado de animaciones y la cmara en cada cuadro
 void DoMovement()
 {
+	PROFILE_FUNCTION();
 	// Animacin de la puerta de entrada: abre si est activada y an no llega a 90
 	if (anim_Puerta_ent) {
 		if (rot_Puerta_ent < 90.0f) {
@@ -951,7 +1148,10 @@ void DoMovement()
 	}
 
 
-	// Controles de movimiento de cmara (WASD o flechas)
+	// Controles de movimiento de cmara (WASD o flechas); durante --flythrough la mueve el recorrido
+	if (flythrough.Active())
+		return;
+
 	if (keys[GLFW_KEY_W] || keys[GLFW_KEY_UP])
 	{
 		camera.ProcessKeyboard(FORWARD, deltaTime); // Avanza
@@ -972,3 +1172,35 @@ void DoMovement()
 		camera.ProcessKeyboard(RIGHT, deltaTime); // Derecha
 	}
 }
+
+// Configura las luces del archivo de escena; la luz interior y el spotlight se encienden con la tecla 3
+void SetupSceneLights(LightBuffer& lights)
+{
+	PROFILE_FUNCTION();
+	lights.Clear();
+	scene.SetChannel("luz_interior", active ? 1.0f : 0.0f);
+	scene.AddLights(lights);
+}
+
+// Con ventana es el reloj de GLFW; con --headless o --flythrough avanza FIXED_FRAME_SECONDS por frame
+// dibujado, as las animaciones (humo, mecedora, radio) no dependen de lo que tarde cada frame. Con --record
+// o --replay es el tiempo del frame de InputRecorder, el mismo en todas las llamadas del frame
+double AppTime()
+{
+	if (input.Active())
+		return input.FrameSeconds();
+	if (headless || flythrough.Active())
+		return framesDrawn * FIXED_FRAME_SECONDS;
+	return glfwGetTime();
+}
+
+// Posicin de la cmara, view y projection de un shader de iluminacin; la matriz de modelo,
+// la normal y el brillo los pone RenderQueue por objeto
+void SetLightingUniforms(Shader& shader, const glm::mat4& view, const glm::mat4& projection)
+{
+	shader.Use();
+	glm::vec3 viewPos = camera.GetPosition();
+	RenderStats::Uniform3f(glGetUniformLocation(shader.Program, "viewPos"), viewPos.x, viewPos.y, viewPos.z);
+	RenderStats::UniformMatrix4fv(glGetUniformLocation(shader.Program, "view"), 1, GL_FALSE, glm::value_ptr(view));
+	RenderStats::UniformMatrix4fv(glGetUniformLocation(shader.Program, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+}
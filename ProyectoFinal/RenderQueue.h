@@ -0,0 +1,231 @@
+#pragma once
+
+// Std. Includes
+#include <vector>
+#include <algorithm>
+
+// GL Includes
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "Shader.h"
+#include "Model.h"
+#include "Profiler.h"
+#include "GpuPassTimer.h"
+#include "RenderStats.h"
+
+// Un objeto de la escena listo para dibujarse: modelo, matriz de modelo y brillo del material
+struct DrawItem
+{
+	Model* model;
+	glm::mat4 transform;
+	GLfloat shininess;
+};
+
+// Cola de dibujo del frame. Los objetos se registran en cualquier orden y luego se dibujan por pases
+// segn la clasificacin de cada malla (AlphaMode): opacos (con pre-pase de profundidad opcional),
+// recortados con alfa (variante con discard) y mezclados al final, de atrs hacia adelante
+// (DrawBlended) o sin ordenar con la transparencia ponderada (DrawWeighted + OitBuffer).
+class RenderQueue
+{
+public:
+	std::vector<DrawItem> items;
+	GpuPassTimer* modelTimer = NULL;  // Si no es NULL, cada objeto es un pase anidado con su etiqueta y su tiempo de GPU
+
+	void Clear()
+	{
+		this->items.clear();
+	}
+
+	// Cada pase dibuja el objeto con el shader que recibe
+	void Submit(Model& model, const glm::mat4& transform, GLfloat shininess = 1.0f)
+	{
+		DrawItem item;
+		item.model = &model;
+		item.transform = transform;
+		item.shininess = shininess;
+		this->items.push_back(item);
+	}
+
+	// Pre-pase: solo profundidad de las mallas opacas, sin escribir color
+	void DrawDepth(Shader& depthShader)
+	{
+		PROFILE_SCOPE("RenderQueue::DrawDepth");
+		glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+		RenderStats::DepthMask(GL_TRUE);
+		RenderStats::DepthFunc(GL_LESS);
+
+		depthShader.Use();
+		GLint modelLoc = glGetUniformLocation(depthShader.Program, "model");
+		for (unsigned int i = 0; i < this->items.size(); i++)
+		{
+			RenderStats::UniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(this->items[i].transform));
+			BeginItem(this->items[i]);
+			this->items[i].model->Draw(depthShader, ALPHA_OPAQUE);
+			EndItem();
+		}
+
+		glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+	}
+
+	// Mallas opacas. Con equalDepth (despus del pre-pase) cada pxel se sombrea una sola vez
+	void DrawOpaque(Shader& shader, bool equalDepth)
+	{
+		PROFILE_SCOPE("RenderQueue::DrawOpaque");
+		if (equalDepth)
+		{
+			RenderStats::DepthFunc(GL_EQUAL);
+			RenderStats::DepthMask(GL_FALSE);
+		}
+
+		DrawMode(shader, ALPHA_OPAQUE);
+
+		RenderStats::DepthFunc(GL_LESS);
+		RenderStats::DepthMask(GL_TRUE);
+	}
+
+	// Mallas recortadas con alfa: necesitan la variante del shader que hace discard
+	void DrawAlphaTested(Shader& alphaTestShader)
+	{
+		PROFILE_SCOPE("RenderQueue::DrawAlphaTested");
+		DrawMode(alphaTestShader, ALPHA_TESTED);
+	}
+
+	// Mallas mezcladas, ordenadas de la ms lejana a la ms cercana a la cmara
+	void DrawBlended(Shader& shader, glm::vec3 cameraPos)
+	{
+		PROFILE_SCOPE("RenderQueue::DrawBlended");
+		std::vector<BlendedMesh> blended;
+		SortBlended(cameraPos, blended);
+		if (blended.empty())
+			return;
+
+		RenderStats::Enable(GL_BLEND);
+		RenderStats::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		RenderStats::DepthMask(GL_FALSE);
+
+		shader.Use();
+		ItemLocations locations(shader.Program);
+		for (unsigned int i = 0; i < blended.size(); i++)
+		{
+			const DrawItem& item = *blended[i].item;
+			locations.Apply(item);
+			BeginItem(item);
+			item.model->meshes[blended[i].mesh].Draw(shader);
+			EndItem();
+		}
+
+		RenderStats::DepthMask(GL_TRUE);
+		RenderStats::Disable(GL_BLEND);
+	}
+
+	// Mallas mezcladas en el orden en que se registraron, para la transparencia ponderada.
+	// El estado de mezcla y el framebuffer los pone OitBuffer::Begin; aqu no se ordena nada.
+	void DrawWeighted(Shader& oitShader)
+	{
+		PROFILE_SCOPE("RenderQueue::DrawWeighted");
+		oitShader.Use();
+		ItemLocations locations(oitShader.Program);
+		for (unsigned int i = 0; i < this->items.size(); i++)
+		{
+			const DrawItem& item = this->items[i];
+			locations.Apply(item);
+			BeginItem(item);
+			item.model->Draw(oitShader, ALPHA_BLENDED);
+			EndItem();
+		}
+	}
+
+	// Sube la matriz de modelo y la matriz normal, que se calcula aqu una vez por objeto
+	// en lugar de hacer transpose(inverse(model)) en cada vrtice
+	static void SetModelMatrix(GLint modelLoc, GLint normalLoc, const glm::mat4& model)
+	{
+		glm::mat3 normalMatrix = NormalMatrix(model);
+		RenderStats::UniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
+		if (normalLoc != -1)
+			RenderStats::UniformMatrix3fv(normalLoc, 1, GL_FALSE, glm::value_ptr(normalMatrix));
+	}
+
+	static glm::mat3 NormalMatrix(const glm::mat4& model)
+	{
+		return glm::mat3(glm::transpose(glm::inverse(model)));
+	}
+
+	// Una malla mezclada de un objeto y la distancia de su centro a la cmara
+	struct BlendedMesh
+	{
+		const DrawItem* item;
+		unsigned int mesh;
+		GLfloat distance;
+	};
+
+	// Las mallas mezcladas de todos los objetos, de la ms lejana a la ms cercana
+	void SortBlended(glm::vec3 cameraPos, std::vector<BlendedMesh>& blended) const
+	{
+		blended.clear();
+		for (unsigned int i = 0; i < this->items.size(); i++)
+		{
+			const DrawItem& item = this->items[i];
+			for (unsigned int m = 0; m < item.model->meshes.size(); m++)
+			{
+				const Mesh& mesh = item.model->meshes[m];
+				if (mesh.alphaMode != ALPHA_BLENDED)
+					continue;
+				glm::vec3 center = glm::vec3(item.transform * glm::vec4((mesh.boundsMin + mesh.boundsMax) * 0.5f, 1.0f));
+				BlendedMesh entry = { &item, m, glm::distance(center, cameraPos) };
+				blended.push_back(entry);
+			}
+		}
+		std::sort(blended.begin(), blended.end(),
+			[](const BlendedMesh& a, const BlendedMesh& b) { return a.distance > b.distance; });
+	}
+
+private:
+	// Ubicaciones de los uniforms que cambian por objeto
+	struct ItemLocations
+	{
+		GLint model, normal, shininess;
+
+		ItemLocations(GLuint program)
+		{
+			model = glGetUniformLocation(program, "model");
+			normal = glGetUniformLocation(program, "normalMatrix");
+			shininess = glGetUniformLocation(program, "material.shininess");
+		}
+
+		void Apply(const DrawItem& item) const
+		{
+			SetModelMatrix(model, normal, item.transform);
+			if (shininess != -1)
+				RenderStats::Uniform1f(shininess, item.shininess);
+		}
+	};
+
+	void DrawMode(Shader& shader, AlphaMode mode)
+	{
+		shader.Use();
+		ItemLocations locations(shader.Program);
+		for (unsigned int i = 0; i < this->items.size(); i++)
+		{
+			locations.Apply(this->items[i]);
+			BeginItem(this->items[i]);
+			this->items[i].model->Draw(shader, mode);
+			EndItem();
+		}
+	}
+
+	// El nombre del pase de un objeto es el directorio de su modelo
+	void BeginItem(const DrawItem& item)
+	{
+		if (this->modelTimer != NULL)
+			this->modelTimer->BeginPass(item.model->directory.c_str());
+	}
+
+	void EndItem()
+	{
+		if (this->modelTimer != NULL)
+			this->modelTimer->EndPass();
+	}
+};
@@ -0,0 +1,243 @@
+#pragma once
+
+// Std. Includes
+#include <iostream>
+#include <iomanip>
+
+// GL Includes
+#include <GL/glew.h>
+
+// Contadores de trabajo por frame del hilo de render: llamadas de dibujo, tringulos, vrtices, cambios de
+// programa, texturas y VAO, uniforms subidos, bytes subidos a buffers y cambios de estado de mezcla, profundidad y rasterizado.
+// Las llamadas de OpenGL del camino de dibujo de la escena pasan por los envoltorios de esta clase, que solo
+// suman y llaman a la funcin original. Current() es el frame en curso; EndFrame() lo guarda en Last() y empieza
+// otro en cero. Aparte lleva la memoria de texturas y buffers que ocupan los objetos de la escena, estimada con el
+// tamao de cada subida. Los envoltorios no son seguros entre hilos (como el contexto de OpenGL)
+class RenderStats
+{
+public:
+	struct Counters
+	{
+		GLuint64 drawCalls = 0;
+		GLuint64 triangles = 0;
+		GLuint64 vertices = 0;       // vrtices procesados: ndices dibujados por instancia
+		GLuint64 programBinds = 0;
+		GLuint64 textureBinds = 0;
+		GLuint64 vaoBinds = 0;       // sin contar los que desligan (VAO 0)
+		GLuint64 uniformUploads = 0;
+		GLuint64 bufferBytes = 0;
+		GLuint64 stateChanges = 0;   // glEnable/glDisable de GL_BLEND, GL_DEPTH_TEST y GL_RASTERIZER_DISCARD, glDepthFunc, glDepthMask, glBlendFunc
+	};
+
+	static Counters& Current()
+	{
+		return GetState().current;
+	}
+
+	// El ltimo frame terminado
+	static const Counters& Last()
+	{
+		return GetState().last;
+	}
+
+	static void EndFrame()
+	{
+		State& state = GetState();
+		state.last = state.current;
+		state.current = Counters();
+	}
+
+	static void Print(const Counters& counters)
+	{
+		std::cout << "Render stats: " << counters.drawCalls << " draws, " << counters.triangles << " triangulos, "
+			<< counters.vertices << " vertices, " << counters.programBinds << " programas, " << counters.textureBinds
+			<< " texturas, " << counters.vaoBinds << " VAO, " << counters.uniformUploads << " uniforms, "
+			<< counters.bufferBytes << " bytes a buffers, " << counters.stateChanges << " cambios de estado" << std::endl;
+	}
+
+	// Encabezado y fila para los CSV de los benchmarks
+	static const char* CsvHeader()
+	{
+		return "draw_calls,triangles,vertices,program_binds,texture_binds,vao_binds,uniform_uploads,buffer_bytes,state_changes";
+	}
+
+	static void WriteCsv(std::ostream& out, const Counters& counters)
+	{
+		out << counters.drawCalls << "," << counters.triangles << "," << counters.vertices << "," << counters.programBinds << ","
+			<< counters.textureBinds << "," << counters.vaoBinds << "," << counters.uniformUploads << "," << counters.bufferBytes
+			<< "," << counters.stateChanges;
+	}
+
+	// --- Memoria (bytes negativos al liberar) ---
+	static void TrackTextureMemory(GLint64 bytes)
+	{
+		GetState().textureMemory += bytes;
+	}
+
+	static void TrackBufferMemory(GLint64 bytes)
+	{
+		GetState().bufferMemory += bytes;
+	}
+
+	static GLint64 TextureMemory()
+	{
+		return GetState().textureMemory;
+	}
+
+	static GLint64 BufferMemory()
+	{
+		return GetState().bufferMemory;
+	}
+
+	// --- Dibujo ---
+	static void DrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices)
+	{
+		CountDraw(mode, count, 1);
+		glDrawElements(mode, count, type, indices);
+	}
+
+	static void DrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instances)
+	{
+		CountDraw(mode, count, instances);
+		glDrawElementsInstanced(mode, count, type, indices, instances);
+	}
+
+	static void DrawArrays(GLenum mode, GLint first, GLsizei count)
+	{
+		CountDraw(mode, count, 1);
+		glDrawArrays(mode, first, count);
+	}
+
+	// --- Objetos ligados ---
+	static void UseProgram(GLuint program)
+	{
+		Current().programBinds++;
+		glUseProgram(program);
+	}
+
+	static void BindTexture(GLenum target, GLuint texture)
+	{
+		Current().textureBinds++;
+		glBindTexture(target, texture);
+	}
+
+	static void BindVertexArray(GLuint vao)
+	{
+		if (vao != 0)
+			Current().vaoBinds++;
+		glBindVertexArray(vao);
+	}
+
+	// --- Uniforms ---
+	static void Uniform1i(GLint location, GLint value)
+	{
+		Current().uniformUploads++;
+		glUniform1i(location, value);
+	}
+
+	static void Uniform1f(GLint location, GLfloat value)
+	{
+		Current().uniformUploads++;
+		glUniform1f(location, value);
+	}
+
+	static void Uniform2f(GLint location, GLfloat x, GLfloat y)
+	{
+		Current().uniformUploads++;
+		glUniform2f(location, x, y);
+	}
+
+	static void Uniform3f(GLint location, GLfloat x, GLfloat y, GLfloat z)
+	{
+		Current().uniformUploads++;
+		glUniform3f(location, x, y, z);
+	}
+
+	static void UniformMatrix3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+	{
+		Current().uniformUploads++;
+		glUniformMatrix3fv(location, count, transpose, value);
+	}
+
+	static void UniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+	{
+		Current().uniformUploads++;
+		glUniformMatrix4fv(location, count, transpose, value);
+	}
+
+	// --- Buffers ---
+	static void BufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data)
+	{
+		Current().bufferBytes += size;
+		glBufferSubData(target, offset, size, data);
+	}
+
+	// Para escrituras a memoria mapeada, que no pasan por una llamada de OpenGL
+	static void CountBufferUpload(GLsizeiptr size)
+	{
+		Current().bufferBytes += size;
+	}
+
+	// --- Estado de mezcla y profundidad ---
+	static void Enable(GLenum capability)
+	{
+		CountState(capability);
+		glEnable(capability);
+	}
+
+	static void Disable(GLenum capability)
+	{
+		CountState(capability);
+		glDisable(capability);
+	}
+
+	static void DepthFunc(GLenum func)
+	{
+		Current().stateChanges++;
+		glDepthFunc(func);
+	}
+
+	static void DepthMask(GLboolean flag)
+	{
+		Current().stateChanges++;
+		glDepthMask(flag);
+	}
+
+	static void BlendFunc(GLenum source, GLenum destination)
+	{
+		Current().stateChanges++;
+		glBlendFunc(source, destination);
+	}
+
+private:
+	struct State
+	{
+		Counters current;
+		Counters last;
+		GLint64 textureMemory = 0;
+		GLint64 bufferMemory = 0;
+	};
+
+	static State& GetState()
+	{
+		static State state;
+		return state;
+	}
+
+	static void CountDraw(GLenum mode, GLsizei count, GLsizei instances)
+	{
+		Counters& counters = Current();
+		counters.drawCalls++;
+		counters.vertices += (GLuint64)count * instances;
+		if (mode == GL_TRIANGLES)
+			counters.triangles += (GLuint64)(count / 3) * instances;
+		else if (mode == GL_TRIANGLE_STRIP || mode == GL_TRIANGLE_FAN)
+			counters.triangles += (GLuint64)(count > 2 ? count - 2 : 0) * instances;
+	}
+
+	static void CountState(GLenum capability)
+	{
+		if (capability == GL_BLEND || capability == GL_DEPTH_TEST || capability == GL_RASTERIZER_DISCARD)
+			Current().stateChanges++;
+	}
+};
@@ -0,0 +1,258 @@
+#pragma once
+
+// Std. Includes
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+
+// GL Includes
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/gtc/constants.hpp>
+
+#include "Shader.h"
+#include "RenderQueue.h"
+#include "RenderStats.h"
+#include "Lights.h"
+#include "Framebuffer.h"
+#include "StressScene.h"
+#include "Percentile.h"
+
+// Escala de la escena (--bench-scale): genera vecindarios con StressScene y barre un parmetro a la vez
+// (casas, muebles por cuarto, luces y, con --scale-character, personajes) partiendo de una configuracin
+// base, siempre con la misma semilla. Cada punto se dibuja offscreen con los mismos pases que el bucle
+// principal (pre-pase de profundidad, opacos, recortados, personajes y mezclados) mientras la cmara da
+// una vuelta alrededor del vecindario. Por punto reporta:
+//  - generar ms: colocar los objetos, las luces y los personajes (los modelos se cargan una vez al inicio)
+//  - cpu ms: registrar, actualizar y enviar el frame; wall ms: hasta que la GPU termina (glFinish)
+//  - memoria: la de la escena en la CPU y la de texturas y buffers en la GPU (RenderStats)
+// Imprime una tabla con una barra del wall ms por barrido y escribe un CSV con una fila por punto
+class ScaleBenchmark
+{
+public:
+	ScaleBenchmark(GLsizei width = 1280, GLsizei height = 720, GLuint warmupFrames = 5, GLuint frames = 60)
+		: width(width), height(height), warmupFrames(warmupFrames), frames(frames)
+	{
+	}
+
+	// characterPath vaco barre sin personajes; csvPath vaco no escribe el CSV
+	void Run(const std::string& characterPath, const std::string& csvPath, unsigned int seed)
+	{
+		StressScene scene;
+		double loadMs = scene.LoadAssets(characterPath);
+
+		Shader lightingShader("Shaders/lighting.vs", "Shaders/lighting.frag");
+		Shader alphaTestShader("Shaders/lighting.vs", "Shaders/lighting.frag", "#define ALPHA_TEST\n");
+		Shader depthShader("Shaders/depth.vs", "Shaders/depth.frag");
+		LightBuffer lights;
+		LightBuffer::BindProgram(lightingShader.Program);
+		LightBuffer::BindProgram(alphaTestShader.Program);
+
+		StressSceneConfig base;
+		base.seed = seed;
+		base.characters = scene.HasCharacter() ? 10 : 0;
+
+		std::vector<Sweep> sweeps;
+		sweeps.push_back(Sweep("casas", &StressSceneConfig::houses, { 1, 2, 4, 8, 16, 32 }));
+		sweeps.push_back(Sweep("muebles/cuarto", &StressSceneConfig::propsPerRoom, { 1, 2, 4, 8, 16 }));
+		sweeps.push_back(Sweep("luces", &StressSceneConfig::lights, { 0, 4, 16, 32, MAX_LIGHTS - 1 }));
+		if (scene.HasCharacter())
+			sweeps.push_back(Sweep("personajes", &StressSceneConfig::characters, { 0, 10, 50, 100, 250 }));
+
+		std::cout << std::endl << "Scale benchmark (" << this->width << "x" << this->height << ", " << this->frames << " frames por punto, "
+			<< this->warmupFrames << " de calentamiento, semilla " << seed << ")" << std::endl;
+		std::cout << "Carga de modelos: " << std::fixed << std::setprecision(1) << loadMs << " ms. Base: " << base.houses << " casas, "
+			<< base.propsPerRoom << " muebles por cuarto, " << base.lights << " luces, " << base.characters << " personajes" << std::endl;
+
+		Framebuffer target(this->width, this->height);
+		target.Bind();
+		glViewport(0, 0, this->width, this->height);
+		glEnable(GL_DEPTH_TEST);
+
+		std::vector<Point> points;
+		for (unsigned int s = 0; s < sweeps.size(); s++)
+		{
+			std::vector<Point> sweepPoints;
+			for (unsigned int v = 0; v < sweeps[s].values.size(); v++)
+			{
+				StressSceneConfig config = base;
+				config.*sweeps[s].field = sweeps[s].values[v];
+				Point point;
+				point.sweep = sweeps[s].name;
+				point.value = sweeps[s].values[v];
+				point.generateMs = scene.Generate(config);
+				Measure(scene, lights, lightingShader, alphaTestShader, depthShader, point);
+				sweepPoints.push_back(point);
+			}
+			PrintSweep(sweeps[s].name, sweepPoints);
+			points.insert(points.end(), sweepPoints.begin(), sweepPoints.end());
+		}
+
+		target.Unbind();
+		std::cout << std::endl;
+		if (!csvPath.empty())
+			WriteCsv(csvPath, loadMs, points);
+	}
+
+private:
+	static const int BAR_WIDTH = 30;
+
+	// Un parmetro de StressSceneConfig y los valores que toma
+	struct Sweep
+	{
+		const char* name;
+		unsigned int StressSceneConfig::* field;
+		std::vector<unsigned int> values;
+
+		Sweep(const char* name, unsigned int StressSceneConfig::* field, std::initializer_list<unsigned int> values)
+			: name(name), field(field), values(values)
+		{
+		}
+	};
+
+	struct Point
+	{
+		const char* sweep = "";
+		unsigned int value = 0;
+		unsigned int objects = 0;
+		unsigned int lights = 0;
+		unsigned int characters = 0;
+		double generateMs = 0.0;
+		double cpuP50 = 0.0, cpuP95 = 0.0;
+		double wallP50 = 0.0, wallP95 = 0.0;
+		size_t sceneBytes = 0;
+		GLint64 textureBytes = 0;
+		GLint64 bufferBytes = 0;
+		RenderStats::Counters stats;  // del ltimo frame medido
+	};
+
+	GLsizei width, height;
+	GLuint warmupFrames;
+	GLuint frames;
+	RenderQueue queue;
+
+	ScaleBenchmark(const ScaleBenchmark&);
+	ScaleBenchmark& operator=(const ScaleBenchmark&);
+
+	// Dibuja warmupFrames + frames cuadros de la escena actual con la cmara girando alrededor del vecindario
+	void Measure(StressScene& scene, LightBuffer& lights, Shader& lightingShader, Shader& alphaTestShader, Shader& depthShader, Point& point)
+	{
+		glm::vec3 center = scene.Center();
+		float radius = std::max(scene.Radius(), 1.0f);
+		glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)this->width / this->height, 0.1f, 6.0f * radius);
+
+		std::vector<double> cpu, wall;
+		for (GLuint frame = 0; frame < this->warmupFrames + this->frames; frame++)
+		{
+			float angle = glm::two_pi<float>() * frame / (this->warmupFrames + this->frames);
+			glm::vec3 eye = center + glm::vec3(std::cos(angle) * 1.2f * radius, 0.6f * radius, std::sin(angle) * 1.2f * radius);
+			glm::mat4 view = glm::lookAt(eye, center, glm::vec3(0.0f, 1.0f, 0.0f));
+
+			glFinish();
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+			lights.Clear();
+			lights.AddDirectional(glm::vec3(-0.2f, -1.0f, -0.3f), glm::vec3(0.1f), glm::vec3(0.4f), glm::vec3(0.5f));
+			scene.AddLights(lights);
+			lights.Upload();
+
+			this->queue.Clear();
+			scene.Submit(this->queue);
+			SetCameraUniforms(lightingShader, view, projection, eye);
+			SetCameraUniforms(alphaTestShader, view, projection, eye);
+			SetCameraUniforms(depthShader, view, projection, eye);
+
+			this->queue.DrawDepth(depthShader);
+			this->queue.DrawOpaque(lightingShader, true);
+			this->queue.DrawAlphaTested(alphaTestShader);
+			scene.UpdateCharacters(frame / 60.0, view, projection);
+			scene.DrawCharacters(view, projection, eye);
+			this->queue.DrawBlended(lightingShader, eye);
+			double cpuMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+			glFinish();
+			double wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			RenderStats::EndFrame();
+			if (frame < this->warmupFrames)
+				continue;
+			cpu.push_back(cpuMs);
+			wall.push_back(wallMs);
+		}
+
+		std::sort(cpu.begin(), cpu.end());
+		std::sort(wall.begin(), wall.end());
+		point.cpuP50 = Percentile(cpu, 50.0);
+		point.cpuP95 = Percentile(cpu, 95.0);
+		point.wallP50 = Percentile(wall, 50.0);
+		point.wallP95 = Percentile(wall, 95.0);
+		point.objects = scene.Objects();
+		point.lights = scene.Lights();
+		point.characters = scene.Characters();
+		point.sceneBytes = scene.MemoryBytes();
+		point.textureBytes = RenderStats::TextureMemory();
+		point.bufferBytes = RenderStats::BufferMemory();
+		point.stats = RenderStats::Last();
+	}
+
+	static void SetCameraUniforms(Shader& shader, const glm::mat4& view, const glm::mat4& projection, const glm::vec3& eye)
+	{
+		shader.Use();
+		RenderStats::Uniform3f(glGetUniformLocation(shader.Program, "viewPos"), eye.x, eye.y, eye.z);
+		RenderStats::UniformMatrix4fv(glGetUniformLocation(shader.Program, "view"), 1, GL_FALSE, glm::value_ptr(view));
+		RenderStats::UniformMatrix4fv(glGetUniformLocation(shader.Program, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+	}
+
+	// Tabla del barrido con una barra del wall ms p50 relativa al punto ms lento
+	static void PrintSweep(const char* name, const std::vector<Point>& points)
+	{
+		double slowest = 0.0;
+		for (unsigned int i = 0; i < points.size(); i++)
+			slowest = std::max(slowest, points[i].wallP50);
+
+		std::cout << std::endl << std::left << std::setw(16) << name << std::right << std::setw(9) << "objetos" << std::setw(8) << "draws"
+			<< std::setw(11) << "generar ms" << std::setw(9) << "cpu p50" << std::setw(9) << "cpu p95" << std::setw(10) << "wall p50"
+			<< std::setw(10) << "wall p95" << std::setw(11) << "escena KB" << std::setw(10) << "GPU MB" << "  wall p50" << std::endl;
+		for (unsigned int i = 0; i < points.size(); i++)
+		{
+			const Point& point = points[i];
+			int bar = slowest > 0.0 ? (int)std::lround(BAR_WIDTH * point.wallP50 / slowest) : 0;
+			std::cout << std::left << std::setw(16) << point.value << std::right << std::setw(9) << point.objects << std::setw(8)
+				<< point.stats.drawCalls << std::fixed << std::setprecision(2) << std::setw(11) << point.generateMs << std::setw(9)
+				<< point.cpuP50 << std::setw(9) << point.cpuP95 << std::setw(10) << point.wallP50 << std::setw(10) << point.wallP95
+				<< std::setprecision(1) << std::setw(11) << point.sceneBytes / 1024.0 << std::setw(10)
+				<< (point.textureBytes + point.bufferBytes) / (1024.0 * 1024.0) << "  " << std::string(bar, '#') << std::endl;
+		}
+	}
+
+	static void WriteCsv(const std::string& path, double loadMs, const std::vector<Point>& points)
+	{
+		std::ofstream csv(path.c_str());
+		if (!csv)
+		{
+			std::cout << "ERROR::SCALE:: no se pudo escribir " << path << std::endl;
+			return;
+		}
+		csv << "sweep,value,objects,lights,characters,load_ms,generate_ms,cpu_p50_ms,cpu_p95_ms,wall_p50_ms,wall_p95_ms,"
+			<< "scene_bytes,gpu_texture_bytes,gpu_buffer_bytes," << RenderStats::CsvHeader() << std::endl << std::fixed << std::setprecision(4);
+		for (unsigned int i = 0; i < points.size(); i++)
+		{
+			const Point& point = points[i];
+			csv << point.sweep << "," << point.value << "," << point.objects << "," << point.lights << "," << point.characters << ","
+				<< loadMs << "," << point.generateMs << "," << point.cpuP50 << "," << point.cpuP95 << "," << point.wallP50 << ","
+				<< point.wallP95 << "," << point.sceneBytes << "," << point.textureBytes << "," << point.bufferBytes << ",";
+			RenderStats::WriteCsv(csv, point.stats);
+			csv << std::endl;
+		}
+		std::cout << "CSV: " << path << std::endl;
+	}
+};
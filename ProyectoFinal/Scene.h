@@ -0,0 +1,153 @@
+#pragma once
+
+// Std. Includes
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "SceneFile.h"
+#include "Model.h"
+#include "RenderQueue.h"
+#include "Lights.h"
+
+// Escena cargada de un SceneFile (--scene): cada objeto tiene su matriz de mundo calculada al cargar y cada
+// frame solo se registra en la RenderQueue; los animados multiplican adems la animacin de su canal.
+// Open solo lee el archivo (no necesita contexto), LoadModels crea los modelos que falten: al volver a
+// abrir la escena (Reload, tecla F5) los modelos con la misma ruta se reutilizan y solo se cargan los nuevos
+class Scene
+{
+public:
+	Scene()
+	{
+	}
+
+	~Scene()
+	{
+		for (std::map<std::string, Model*>::iterator it = this->loaded.begin(); it != this->loaded.end(); ++it)
+			delete it->second;
+	}
+
+	bool Open(const std::string& path)
+	{
+		this->path = path;
+		if (!this->file.Load(path))
+			return false;
+		this->values.assign(this->file.channels.size(), 0.0f);
+		this->models.clear();
+		return true;
+	}
+
+	// Carga (o toma de las cargas anteriores) el modelo de cada ModelRef; devuelve los ms que tard
+	double LoadModels()
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		this->models.clear();
+		for (size_t i = 0; i < this->file.models.size(); i++)
+		{
+			const SceneFile::ModelRef& ref = this->file.models[i];
+			Model*& model = this->loaded[ref.path];
+			if (model == NULL)
+				model = new Model(ref.path);
+			if (ref.alphaMode >= 0)
+				model->SetAlphaMode((AlphaMode)ref.alphaMode);
+			this->models.push_back(model);
+		}
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	// Vuelve a leer el archivo y carga solo los modelos nuevos; si el archivo tiene errores sigue la escena anterior
+	bool Reload()
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		SceneFile previous = this->file;
+		std::vector<float> previousValues = this->values;
+		size_t before = this->loaded.size();
+		if (!Open(this->path))
+		{
+			this->file = previous;
+			this->values = previousValues;
+			LoadModels();
+			return false;
+		}
+		// Los canales que siguen existiendo conservan su valor hasta el siguiente SetChannel
+		for (size_t i = 0; i < previous.channels.size(); i++)
+			SetChannel(previous.channels[i], previousValues[i]);
+		LoadModels();
+		std::cout << "Escena " << this->path << " recargada en " << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count()
+			<< " ms: " << this->file.objects.size() << " objetos, " << this->loaded.size() - before << " modelos nuevos" << std::endl;
+		return true;
+	}
+
+	// Valor de un canal de animacin (grados para rotate, unidades del eje para translate, factor para intensity);
+	// los canales que la escena no usa se ignoran
+	void SetChannel(const std::string& name, float value)
+	{
+		for (size_t i = 0; i < this->file.channels.size(); i++)
+		{
+			if (this->file.channels[i] == name)
+			{
+				this->values[i] = value;
+				return;
+			}
+		}
+	}
+
+	void Submit(RenderQueue& queue) const
+	{
+		for (size_t i = 0; i < this->file.objects.size(); i++)
+		{
+			const SceneFile::Object& object = this->file.objects[i];
+			if (object.model >= this->models.size())
+				continue;
+			if (object.channel < 0)
+				queue.Submit(*this->models[object.model], object.world, object.shininess);
+			else
+				queue.Submit(*this->models[object.model], object.world * Animate(object, this->values[object.channel]) * object.post, object.shininess);
+		}
+	}
+
+	// Agrega las luces de la escena (no limpia el buffer)
+	void AddLights(LightBuffer& buffer) const
+	{
+		for (size_t i = 0; i < this->file.lights.size(); i++)
+		{
+			const SceneFile::Light& light = this->file.lights[i];
+			float intensity = light.channel >= 0 ? this->values[light.channel] : 1.0f;
+			glm::vec4 a = light.attenuation;
+			if (light.type == LIGHT_DIRECTIONAL)
+				buffer.AddDirectional(light.direction, light.ambient, intensity * light.diffuse, intensity * light.specular);
+			else if (light.type == LIGHT_POINT)
+				buffer.AddPoint(light.position, light.ambient, intensity * light.diffuse, intensity * light.specular, a.x, a.y, a.z, a.w);
+			else
+				buffer.AddSpot(light.position, light.direction, light.ambient, intensity * light.diffuse, intensity * light.specular,
+					a.x, a.y, a.z, light.cone.x, light.cone.y, a.w);
+		}
+	}
+
+	const SceneFile& File() const { return this->file; }
+	const std::string& Path() const { return this->path; }
+
+private:
+	std::string path;
+	SceneFile file;
+	std::vector<float> values;                 // un valor por canal de file
+	std::vector<Model*> models;                // uno por ModelRef de file
+	std::map<std::string, Model*> loaded;      // por ruta, todos los modelos cargados
+
+	Scene(const Scene&);
+	Scene& operator=(const Scene&);
+
+	static glm::mat4 Animate(const SceneFile::Object& object, float value)
+	{
+		if (object.animation == SceneFile::ANIMATE_TRANSLATE)
+			return glm::translate(glm::mat4(1.0f), value * object.axis);
+		if (object.animation == SceneFile::ANIMATE_ROTATE)
+			return glm::rotate(glm::mat4(1.0f), glm::radians(value), object.axis);
+		return glm::mat4(1.0f);
+	}
+};
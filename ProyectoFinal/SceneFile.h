@@ -0,0 +1,412 @@
+#pragma once
+
+// Std. Includes
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "Mesh.h"
+#include "Lights.h"
+
+// Descripcin de una escena: modelos, objetos (modelo + transformacin + material), luces y animaciones,
+// leda de un archivo en lugar de estar escrita en el bucle de render. Se escribe como texto, una
+// instruccin por lnea y '#' para comentarios:
+//   model   <nombre> <ruta> [opaque|tested|blended]      modelo; el modo de alfa reemplaza al del archivo
+//   object  <nombre> <modelo> [brillo]                    un objeto dibuja un modelo (material.shininess)
+//     translate x y z                                     las transformaciones siguientes se aplican al
+//     scale s | scale x y z                               ltimo objeto en orden, como una cadena de
+//     rotate grados x y z                                 glm::translate/scale/rotate que empieza en la identidad
+//     animate <canal> translate x y z                     en este punto de la cadena: traslacin canal * (x y z)
+//     animate <canal> rotate x y z                        o giro de canal grados alrededor de (x y z)
+//   directional dx dy dz  ambiente(rgb) difusa(rgb) especular(rgb)
+//   point  x y z  ambiente difusa especular  constante lineal cuadrtica [escala]
+//   spot   x y z  dx dy dz  ambiente difusa especular  constante lineal cuadrtica corte exterior [escala]
+//     animate <canal> intensity                           difusa y especular de la ltima luz * canal
+// Los canales son valores que el programa cambia cada frame (Scene::SetChannel): el cajn, la mecedora, ...
+// Al cargar, la cadena de cada objeto se reduce a una sola matriz de mundo; los animados quedan como
+// world * animacin(canal) * post. Compile guarda el resultado en binario (encabezado "PFSC" y versin, en el
+// orden de bytes de la mquina), que se carga sin volver a leer ni multiplicar nada; Load acepta los dos
+class SceneFile
+{
+public:
+	enum Animation { ANIMATE_NONE = 0, ANIMATE_TRANSLATE = 1, ANIMATE_ROTATE = 2 };
+
+	struct ModelRef
+	{
+		std::string name;
+		std::string path;
+		int32_t alphaMode = -1;       // AlphaMode, o -1 para dejar la clasificacin de cada malla
+	};
+
+	struct Object
+	{
+		std::string name;
+		uint32_t model = 0;           // ndice en models
+		float shininess = 1.0f;
+		int32_t channel = -1;         // -1: esttico, world es la matriz de mundo completa
+		uint32_t animation = ANIMATE_NONE;
+		glm::vec3 axis = glm::vec3(0.0f);
+		glm::mat4 world = glm::mat4(1.0f);
+		glm::mat4 post = glm::mat4(1.0f);  // la cadena despus de la animacin
+	};
+
+	struct Light
+	{
+		uint32_t type = LIGHT_POINT;
+		glm::vec3 position = glm::vec3(0.0f);
+		glm::vec3 direction = glm::vec3(0.0f);
+		glm::vec3 ambient = glm::vec3(0.0f);
+		glm::vec3 diffuse = glm::vec3(0.0f);
+		glm::vec3 specular = glm::vec3(0.0f);
+		glm::vec4 attenuation = glm::vec4(1.0f, 0.0f, 0.0f, 1.0f);  // constante, lineal, cuadrtica, escala
+		glm::vec2 cone = glm::vec2(0.0f);  // cosenos del corte y del corte exterior
+		int32_t channel = -1;              // canal que multiplica difusa y especular
+	};
+
+	std::vector<std::string> channels;
+	std::vector<ModelRef> models;
+	std::vector<Object> objects;
+	std::vector<Light> lights;
+
+	// Texto o binario segn el encabezado; false (y la escena vaca) si hay algn error
+	bool Load(const std::string& path)
+	{
+		Clear();
+		std::ifstream file(path.c_str(), std::ios::in | std::ios::binary);
+		if (!file)
+		{
+			std::cout << "ERROR::SCENE:: no se pudo abrir " << path << std::endl;
+			return false;
+		}
+		char magic[4] = {};
+		bool binary = file.read(magic, 4) && std::memcmp(magic, MAGIC, 4) == 0;
+		file.clear();
+		file.seekg(0);
+		bool loaded = binary ? ReadBinary(file, path) : ReadText(file, path);
+		if (!loaded)
+			Clear();
+		return loaded;
+	}
+
+	// Escribe la forma compilada de la escena cargada
+	bool Compile(const std::string& path) const
+	{
+		std::ofstream file(path.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!file)
+		{
+			std::cout << "ERROR::SCENE:: no se pudo escribir " << path << std::endl;
+			return false;
+		}
+		file.write(MAGIC, 4);
+		Write(file, (uint32_t)VERSION);
+
+		Write(file, (uint32_t)this->channels.size());
+		for (size_t i = 0; i < this->channels.size(); i++)
+			WriteString(file, this->channels[i]);
+
+		Write(file, (uint32_t)this->models.size());
+		for (size_t i = 0; i < this->models.size(); i++)
+		{
+			WriteString(file, this->models[i].name);
+			WriteString(file, this->models[i].path);
+			Write(file, this->models[i].alphaMode);
+		}
+
+		Write(file, (uint32_t)this->objects.size());
+		for (size_t i = 0; i < this->objects.size(); i++)
+		{
+			const Object& object = this->objects[i];
+			WriteString(file, object.name);
+			Write(file, object.model);
+			Write(file, object.shininess);
+			Write(file, object.channel);
+			Write(file, object.animation);
+			Write(file, object.axis);
+			Write(file, object.world);
+			Write(file, object.post);
+		}
+
+		Write(file, (uint32_t)this->lights.size());
+		for (size_t i = 0; i < this->lights.size(); i++)
+			Write(file, this->lights[i]);
+
+		std::cout << "Escena compilada: " << this->models.size() << " modelos, " << this->objects.size() << " objetos, "
+			<< this->lights.size() << " luces, " << this->channels.size() << " canales -> " << path << std::endl;
+		return (bool)file;
+	}
+
+	void Clear()
+	{
+		this->channels.clear();
+		this->models.clear();
+		this->objects.clear();
+		this->lights.clear();
+	}
+
+private:
+	static constexpr const char* MAGIC = "PFSC";
+	static const uint32_t VERSION = 1;
+
+	bool ReadText(std::istream& file, const std::string& path)
+	{
+		// Cadena del ltimo objeto: se reduce al terminar el objeto (al empezar otro o al final del archivo)
+		std::vector<glm::mat4> chain;
+		bool animated = false;
+		enum { NONE, OBJECT, LIGHT } current = NONE;
+
+		std::string line;
+		unsigned int number = 0;
+		while (std::getline(file, line))
+		{
+			number++;
+			size_t comment = line.find('#');
+			if (comment != std::string::npos)
+				line.erase(comment);
+			std::istringstream fields(line);
+			std::string keyword;
+			if (!(fields >> keyword))
+				continue;
+
+			std::string error;
+			if (keyword == "model")
+			{
+				ModelRef model;
+				std::string mode;
+				if (!(fields >> model.name >> model.path))
+					error = "se esperaba model <nombre> <ruta> [opaque|tested|blended]";
+				else if (FindModel(model.name) >= 0)
+					error = "el modelo " + model.name + " ya existe";
+				else if (fields >> mode)
+				{
+					model.alphaMode = mode == "opaque" ? ALPHA_OPAQUE : mode == "tested" ? ALPHA_TESTED : mode == "blended" ? ALPHA_BLENDED : -2;
+					if (model.alphaMode == -2)
+						error = "modo de alfa desconocido " + mode;
+				}
+				if (error.empty())
+					this->models.push_back(model);
+			}
+			else if (keyword == "object")
+			{
+				EndObject(current == OBJECT, chain, animated);
+				Object object;
+				std::string model;
+				if (!(fields >> object.name >> model))
+					error = "se esperaba object <nombre> <modelo> [brillo]";
+				else if (FindModel(model) < 0)
+					error = "el modelo " + model + " no se declaro antes";
+				else
+				{
+					object.model = (uint32_t)FindModel(model);
+					fields >> object.shininess;
+					this->objects.push_back(object);
+					current = OBJECT;
+				}
+			}
+			else if (keyword == "translate" || keyword == "scale" || keyword == "rotate")
+			{
+				glm::vec3 v;
+				float degrees = 0.0f;
+				if (current != OBJECT)
+					error = keyword + " sin un object antes";
+				else if (keyword == "rotate" && !(fields >> degrees >> v.x >> v.y >> v.z))
+					error = "se esperaba rotate grados x y z";
+				else if (keyword == "scale" && !(fields >> v.x))
+					error = "se esperaba scale s o scale x y z";
+				else if (keyword == "translate" && !(fields >> v.x >> v.y >> v.z))
+					error = "se esperaba translate x y z";
+				else if (keyword == "scale" && !(fields >> v.y >> v.z))
+					v = glm::vec3(v.x);
+
+				if (error.empty())
+				{
+					glm::mat4 step = keyword == "translate" ? glm::translate(glm::mat4(1.0f), v)
+						: keyword == "scale" ? glm::scale(glm::mat4(1.0f), v) : glm::rotate(glm::mat4(1.0f), glm::radians(degrees), v);
+					chain.push_back(step);
+				}
+			}
+			else if (keyword == "animate")
+			{
+				std::string channel, kind;
+				glm::vec3 axis;
+				if (!(fields >> channel >> kind))
+					error = "se esperaba animate <canal> translate|rotate x y z, o animate <canal> intensity";
+				else if (current == LIGHT && kind == "intensity")
+					this->lights.back().channel = AddChannel(channel);
+				else if (current != OBJECT || (kind != "translate" && kind != "rotate"))
+					error = "animate " + kind + " no va despues de la linea anterior";
+				else if (animated)
+					error = "cada objeto puede tener una sola animacion";
+				else if (!(fields >> axis.x >> axis.y >> axis.z))
+					error = "se esperaba animate <canal> " + kind + " x y z";
+				else
+				{
+					// La cadena hasta aqu queda en world; lo que siga ir en post
+					Object& object = this->objects.back();
+					object.world = Reduce(chain);
+					object.channel = AddChannel(channel);
+					object.animation = kind == "translate" ? ANIMATE_TRANSLATE : ANIMATE_ROTATE;
+					object.axis = axis;
+					animated = true;
+				}
+			}
+			else if (keyword == "directional" || keyword == "point" || keyword == "spot")
+			{
+				EndObject(current == OBJECT, chain, animated);
+				current = NONE;
+				Light light;
+				light.type = keyword == "directional" ? LIGHT_DIRECTIONAL : keyword == "point" ? LIGHT_POINT : LIGHT_SPOT;
+				if (light.type != LIGHT_DIRECTIONAL)
+					fields >> light.position.x >> light.position.y >> light.position.z;
+				if (light.type != LIGHT_POINT)
+					fields >> light.direction.x >> light.direction.y >> light.direction.z;
+				fields >> light.ambient.r >> light.ambient.g >> light.ambient.b >> light.diffuse.r >> light.diffuse.g >> light.diffuse.b
+					>> light.specular.r >> light.specular.g >> light.specular.b;
+				if (light.type != LIGHT_DIRECTIONAL)
+					fields >> light.attenuation.x >> light.attenuation.y >> light.attenuation.z;
+				glm::vec2 degrees;
+				if (light.type == LIGHT_SPOT && fields >> degrees.x >> degrees.y)
+					light.cone = glm::vec2(glm::cos(glm::radians(degrees.x)), glm::cos(glm::radians(degrees.y)));
+
+				if (!fields)
+					error = "faltan valores de la luz " + keyword + " (ver SceneFile.h)";
+				else
+				{
+					if (light.type != LIGHT_DIRECTIONAL && !(fields >> light.attenuation.w))
+						light.attenuation.w = 1.0f;
+					this->lights.push_back(light);
+					current = LIGHT;
+				}
+			}
+			else
+				error = "instruccion desconocida " + keyword;
+
+			if (!error.empty())
+			{
+				std::cout << "ERROR::SCENE:: " << path << ":" << number << ": " << error << std::endl;
+				return false;
+			}
+		}
+		EndObject(current == OBJECT, chain, animated);
+		return true;
+	}
+
+	bool ReadBinary(std::istream& file, const std::string& path)
+	{
+		char magic[4];
+		uint32_t version = 0, count = 0;
+		bool ok = file.read(magic, 4) && Read(file, version) && version == VERSION;
+
+		ok = ok && Read(file, count);
+		for (uint32_t i = 0; ok && i < count; i++)
+		{
+			this->channels.push_back(std::string());
+			ok = ReadString(file, this->channels.back());
+		}
+
+		ok = ok && Read(file, count);
+		for (uint32_t i = 0; ok && i < count; i++)
+		{
+			ModelRef model;
+			ok = ReadString(file, model.name) && ReadString(file, model.path) && Read(file, model.alphaMode);
+			this->models.push_back(model);
+		}
+
+		ok = ok && Read(file, count);
+		for (uint32_t i = 0; ok && i < count; i++)
+		{
+			Object object;
+			ok = ReadString(file, object.name) && Read(file, object.model) && Read(file, object.shininess) && Read(file, object.channel)
+				&& Read(file, object.animation) && Read(file, object.axis) && Read(file, object.world) && Read(file, object.post)
+				&& object.model < this->models.size() && object.channel < (int32_t)this->channels.size();
+			this->objects.push_back(object);
+		}
+
+		ok = ok && Read(file, count);
+		for (uint32_t i = 0; ok && i < count; i++)
+		{
+			Light light;
+			ok = Read(file, light) && light.channel < (int32_t)this->channels.size();
+			this->lights.push_back(light);
+		}
+
+		if (!ok)
+			std::cout << "ERROR::SCENE:: " << path << " no es una escena compilada valida (version " << VERSION << ")" << std::endl;
+		return ok;
+	}
+
+	// Termina el objeto actual: la cadena que queda (despus de la animacin, si hubo) se reduce a una matriz
+	void EndObject(bool open, std::vector<glm::mat4>& chain, bool& animated)
+	{
+		if (open)
+		{
+			Object& object = this->objects.back();
+			if (animated)
+				object.post = Reduce(chain);
+			else
+				object.world = Reduce(chain);
+		}
+		chain.clear();
+		animated = false;
+	}
+
+	// Producto de la cadena en orden (como model = model * paso) y la deja vaca
+	static glm::mat4 Reduce(std::vector<glm::mat4>& chain)
+	{
+		glm::mat4 result(1.0f);
+		for (size_t i = 0; i < chain.size(); i++)
+			result = result * chain[i];
+		chain.clear();
+		return result;
+	}
+
+	int FindModel(const std::string& name) const
+	{
+		for (size_t i = 0; i < this->models.size(); i++)
+			if (this->models[i].name == name)
+				return (int)i;
+		return -1;
+	}
+
+	int32_t AddChannel(const std::string& name)
+	{
+		for (size_t i = 0; i < this->channels.size(); i++)
+			if (this->channels[i] == name)
+				return (int32_t)i;
+		this->channels.push_back(name);
+		return (int32_t)this->channels.size() - 1;
+	}
+
+	template <typename T>
+	static void Write(std::ostream& file, const T& value)
+	{
+		file.write((const char*)&value, sizeof(T));
+	}
+
+	static void WriteString(std::ostream& file, const std::string& text)
+	{
+		Write(file, (uint32_t)text.size());
+		file.write(text.data(), text.size());
+	}
+
+	template <typename T>
+	static bool Read(std::istream& file, T& value)
+	{
+		return (bool)file.read((char*)&value, sizeof(T));
+	}
+
+	static bool ReadString(std::istream& file, std::string& text)
+	{
+		uint32_t size = 0;
+		if (!Read(file, size) || size > (1u << 16))
+			return false;
+		text.resize(size);
+		return size == 0 || (bool)file.read(&text[0], size);
+	}
+};
@@ -5,16 +5,22 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <vector>
 
 #include <GL/glew.h>
 
+#include "RenderStats.h"
+
 class Shader
 {
 public:
 	GLuint Program;
 	GLuint uniformColor;
 	// Constructor generates the shader on the fly
-	Shader(const GLchar *vertexPath, const GLchar *fragmentPath)
+	// defines (optional) is inserted right after the #version line of both stages, e.g. "#define ALPHA_TEST\n"
+	// feedbackVaryings (optional) are captured with transform feedback, interleaved in the given order
+	Shader(const GLchar *vertexPath, const GLchar *fragmentPath, const std::string &defines = "",
+		const std::vector<const GLchar*> &feedbackVaryings = std::vector<const GLchar*>())
 	{
 		// 1. Retrieve the vertex/fragment source code from filePath
 		std::string vertexCode;
@@ -39,6 +45,9 @@ public:
 			// Convert stream into string
 			vertexCode = vShaderStream.str();
 			fragmentCode = fShaderStream.str();
+			// Insert the variant defines after the #version directive
+			insertDefines(vertexCode, defines);
+			insertDefines(fragmentCode, defines);
 		}
 		catch (std::ifstream::failure e)
 		{
@@ -76,6 +85,9 @@ public:
 		this->Program = glCreateProgram();
 		glAttachShader(this->Program, vertex);
 		glAttachShader(this->Program, fragment);
+		// Transform feedback outputs must be declared before linking
+		if (!feedbackVaryings.empty())
+			glTransformFeedbackVaryings(this->Program, (GLsizei)feedbackVaryings.size(), &feedbackVaryings[0], GL_INTERLEAVED_ATTRIBS);
 		glLinkProgram(this->Program);
 		// Print linking errors if any
 		glGetProgramiv(this->Program, GL_LINK_STATUS, &success);
@@ -94,13 +106,25 @@ public:
 	// Uses the current shader
 	void Use()
 	{
-		glUseProgram(this->Program);
+		RenderStats::UseProgram(this->Program);
 	}
 
 	GLuint getColorLocation()
 	{
 		return uniformColor;
 	}
+
+private:
+	static void insertDefines(std::string &code, const std::string &defines)
+	{
+		if (defines.empty())
+			return;
+		std::string::size_type lineEnd = code.find('\n');
+		if (lineEnd == std::string::npos)
+			code += "\n" + defines;
+		else
+			code.insert(lineEnd + 1, defines);
+	}
 };
 
 #endif
\ No newline at end of file
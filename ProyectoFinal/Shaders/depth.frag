@@ -0,0 +1,6 @@
+#version 330 core
+
+// Pre-pase de profundidad: no escribe color, solo llena el depth buffer
+void main()
+{
+}
@@ -0,0 +1,14 @@
+#version 330 core
+
+// Letras y rectngulos del HUD: el atlas tiene la cobertura de cada glifo y una fila blanca para los rectngulos
+in vec2 TexCoords;
+in vec4 Color;
+
+uniform sampler2D fontAtlas;
+
+out vec4 color;
+
+void main()
+{
+    color = vec4(Color.rgb, Color.a * texture(fontAtlas, TexCoords).r);
+}
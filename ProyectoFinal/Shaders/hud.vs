@@ -0,0 +1,19 @@
+#version 330 core
+
+// Vrtices del HUD en pxeles de pantalla con el origen arriba a la izquierda
+layout (location = 0) in vec2 position;
+layout (location = 1) in vec2 texCoords;
+layout (location = 2) in vec4 vertexColor;
+
+out vec2 TexCoords;
+out vec4 Color;
+
+uniform vec2 screenSize;
+
+void main()
+{
+    TexCoords = texCoords;
+    Color = vertexColor;
+    vec2 ndc = position / screenSize * 2.0 - 1.0;
+    gl_Position = vec4(ndc.x, -ndc.y, 0.0, 1.0);
+}
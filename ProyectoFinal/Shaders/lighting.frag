@@ -1,6 +1,13 @@
 #version 330 core
 
-#define NUMBER_OF_POINT_LIGHTS 3
+// Deben coincidir con LightType y MAX_LIGHTS de Lights.h
+#define LIGHT_DIRECTIONAL 0
+#define LIGHT_POINT 1
+#define LIGHT_SPOT 2
+#define MAX_LIGHTS 64
+
+// Las luces cuya atenuación queda por debajo de este valor no aportan nada visible
+#define LIGHT_EPSILON (1.0 / 256.0)
 
 struct Material
 {
@@ -9,142 +16,113 @@ struct Material
     float shininess;
 };
 
-struct DirLight
-{
-    vec3 direction;
-    
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
-};
-
-struct PointLight
+// Luz empaquetada en vec4 (ver PackedLight en Lights.h)
+struct Light
 {
-    vec3 position;
-    
-    float constant;
-    float linear;
-    float quadratic;
-    
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
+    vec4 position;     // xyz = posición, w = tipo
+    vec4 direction;    // xyz = dirección
+    vec4 ambient;
+    vec4 diffuse;
+    vec4 specular;
+    vec4 attenuation;  // constante, lineal, cuadrática, escala de distancia
+    vec4 cone;         // cos(corte interior), cos(corte exterior)
 };
 
-struct SpotLight
+layout (std140) uniform LightBlock
 {
-    vec3 position;
-    vec3 direction;
-    float cutOff;
-    float outerCutOff;
-    
-    float constant;
-    float linear;
-    float quadratic;
-    
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
+    ivec4 lightCount;
+    Light lights[MAX_LIGHTS];
 };
 
 in vec3 FragPos;
 in vec3 Normal;
 in vec2 TexCoords;
 
-out vec4 color;
-
-uniform vec3 viewPos;
-uniform DirLight dirLight;
-uniform PointLight pointLights[NUMBER_OF_POINT_LIGHTS];
-uniform SpotLight spotLight;
-uniform Material material;
-uniform int trans;
-
-// Function prototypes
-vec3 CalcDirLight( DirLight light, vec3 normal, vec3 viewDir );
-vec3 CalcPointLight( PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir );
-vec3 CalcSpotLight( SpotLight light, vec3 normal, vec3 fragPos, vec3 viewDir );
+layout (location = 0) out vec4 color;
 
-void main()
-{
-    vec3 norm = normalize(Normal);
-    vec3 viewDir = normalize(viewPos - FragPos);
-    
-    vec3 result = CalcDirLight(dirLight, norm, viewDir);
-    
-    for (int i = 0; i < NUMBER_OF_POINT_LIGHTS; i++)
-    {
-        result += CalcPointLight(pointLights[i], norm, FragPos, viewDir);
-    }
-    
-    result += CalcSpotLight(spotLight, norm, FragPos, viewDir);
-    
-    color = vec4(result, texture(material.diffuse, TexCoords).rgb);
-    if(color.a < 0.1 && trans == 1)
-        discard;
-}
+#ifdef WEIGHTED_OIT
+// Segundo destino de la transparencia ponderada (ver OitBuffer.h)
+layout (location = 1) out vec4 oitWeight;
 
-vec3 CalcDirLight(DirLight light, vec3 normal, vec3 viewDir)
+// Peso por distancia a la cámara (ecuación 9 de McGuire y Bavoil); 1 / gl_FragCoord.w es la z de vista
+float OitWeight(float alpha)
 {
-    vec3 lightDir = normalize(-light.direction);
-    float diff = max(dot(normal, lightDir), 0.0);
-    vec3 reflectDir = reflect(-lightDir, normal);
-    float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
-
-    vec3 ambient = light.ambient * vec3(texture(material.diffuse, TexCoords).rgb);
-    vec3 diffuse = light.diffuse * diff * vec3(texture(material.diffuse, TexCoords).rgb);
-    vec3 specular = light.specular * spec * vec3(texture(material.specular, TexCoords).rgb);
-
-    vec3 result = ambient + diffuse + specular;
-    return result;
+    float z = 1.0 / gl_FragCoord.w;
+    return alpha * clamp(10.0 / (1e-5 + pow(z / 5.0, 2.0) + pow(z / 200.0, 6.0)), 1e-2, 3e3);
 }
+#endif
 
-vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir)
-{
-    vec3 lightDir = normalize(light.position - fragPos);
-    float diff = max(dot(normal, lightDir), 0.0);
-    vec3 reflectDir = reflect(-lightDir, normal);
-    float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
-
-    // Aquí modificamos la distancia para hacer la luz más pequeña
-    float distance = length(light.position - fragPos) * 2.0;
-    float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * (distance * distance));
-
-    vec3 ambient = light.ambient * vec3(texture(material.diffuse, TexCoords).rgb);
-    vec3 diffuse = light.diffuse * diff * vec3(texture(material.diffuse, TexCoords).rgb);
-    vec3 specular = light.specular * spec * vec3(texture(material.specular, TexCoords).rgb);
-
-    ambient *= attenuation;
-    diffuse *= attenuation;
-    specular *= attenuation;
-
-    vec3 result = ambient + diffuse + specular;
-    return result;
-}
+uniform vec3 viewPos;
+uniform Material material;
 
-vec3 CalcSpotLight(SpotLight light, vec3 normal, vec3 fragPos, vec3 viewDir)
+void main()
 {
-    vec3 lightDir = normalize(light.position - fragPos);
-    float diff = max(dot(normal, lightDir), 0.0);
-    vec3 reflectDir = reflect(-lightDir, normal);
-    float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
+    // Cada textura del material se lee una sola vez por fragmento
+    vec4 texDiffuse = texture(material.diffuse, TexCoords);
+    vec3 texSpecular = texture(material.specular, TexCoords).rgb;
 
-    // Igual aquí multiplicamos distancia para achicar el radio del spotlight
-    float distance = length(light.position - fragPos) * 10.0;
-    float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * (distance * distance));
+    vec3 norm = normalize(Normal);
+    vec3 viewDir = normalize(viewPos - FragPos);
 
-    float theta = dot(lightDir, normalize(-light.direction));
-    float epsilon = light.cutOff - light.outerCutOff;
-    float intensity = clamp((theta - light.outerCutOff) / epsilon, 0.0, 1.0);
+    vec3 result = vec3(0.0);
 
-    vec3 ambient = light.ambient * vec3(texture(material.diffuse, TexCoords).rgb);
-    vec3 diffuse = light.diffuse * diff * vec3(texture(material.diffuse, TexCoords).rgb);
-    vec3 specular = light.specular * spec * vec3(texture(material.specular, TexCoords).rgb);
+    for (int i = 0; i < lightCount.x; i++)
+    {
+        int type = int(lights[i].position.w);
+
+        vec3 lightDir;
+        float attenuation = 1.0;
+
+        if (type == LIGHT_DIRECTIONAL)
+        {
+            lightDir = normalize(-lights[i].direction.xyz);
+        }
+        else
+        {
+            vec3 toLight = lights[i].position.xyz - FragPos;
+            float dist = length(toLight);
+            lightDir = toLight / dist;
+
+            // La escala de distancia hace la luz más pequeña (x2 en puntuales, x10 en el spotlight)
+            float distance = dist * lights[i].attenuation.w;
+            attenuation = 1.0 / (lights[i].attenuation.x + lights[i].attenuation.y * distance + lights[i].attenuation.z * (distance * distance));
+
+            if (type == LIGHT_SPOT)
+            {
+                float theta = dot(lightDir, normalize(-lights[i].direction.xyz));
+                float epsilon = lights[i].cone.x - lights[i].cone.y;
+                attenuation *= clamp((theta - lights[i].cone.y) / epsilon, 0.0, 1.0);
+            }
+
+            // Luz demasiado lejana o fuera del cono: se omite el resto del cálculo
+            if (attenuation < LIGHT_EPSILON)
+                continue;
+        }
+
+        float diff = max(dot(norm, lightDir), 0.0);
+        vec3 reflectDir = reflect(-lightDir, norm);
+        float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
+
+        vec3 ambient = lights[i].ambient.rgb * texDiffuse.rgb;
+        vec3 diffuse = lights[i].diffuse.rgb * diff * texDiffuse.rgb;
+        vec3 specular = lights[i].specular.rgb * spec * texSpecular;
+
+        result += (ambient + diffuse + specular) * attenuation;
+    }
 
-    ambient *= attenuation * intensity;
-    diffuse *= attenuation * intensity;
-    specular *= attenuation * intensity;
+    color = vec4(result, texDiffuse.a);
 
-    vec3 result = ambient + diffuse + specular;
-    return result;
+    // Solo la variante para mallas recortadas (ALPHA_TEST) descarta fragmentos; la opaca
+    // no tiene discard y así conserva el early-Z
+#ifdef ALPHA_TEST
+    if (color.a < 0.1)
+        discard;
+#endif
+
+    // Variante para transparentes sin ordenar: color premultiplicado y ponderado en vez del color final
+#ifdef WEIGHTED_OIT
+    float weight = OitWeight(color.a);
+    oitWeight = vec4(weight);
+    color = vec4(color.rgb * weight, color.a);
+#endif
 }
@@ -11,9 +11,13 @@ out vec3 FragPos;
 out vec2 TexCoords;
 out float trans;
 
+// Misma posicin bit a bit que Shaders/depth.vs para poder sombrear con GL_EQUAL despus del pre-pase
+invariant gl_Position;
+
 uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
+uniform mat3 normalMatrix; // transpose(inverse(model)), calculada una vez por objeto en CPU
 uniform float time;
 uniform int anim;
 uniform float transparencia;
@@ -46,8 +50,8 @@ void main()
     // Calcula la posicin del fragmento en el espacio mundial
     FragPos = vec3(model * vec4(aPos, 1.0));
     
-    // Calcula la normal transformada
-    Normal = mat3(transpose(inverse(model))) * aNormal;
+    // Transforma la normal con la matriz normal precalculada
+    Normal = normalMatrix * aNormal;
 
     // Asigna el valor de transparencia
     trans = transparencia;
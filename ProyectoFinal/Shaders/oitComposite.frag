@@ -0,0 +1,24 @@
+#version 330 core
+
+// Composicin de la transparencia ponderada (ver OitBuffer.h)
+uniform sampler2D accumTexture;
+uniform sampler2D weightTexture;
+
+out vec4 color;
+
+void main()
+{
+    ivec2 texel = ivec2(gl_FragCoord.xy);
+    vec4 accum = texelFetch(accumTexture, texel, 0);
+
+    // revealage = 1: ningn transparente cubre este pxel
+    float revealage = accum.a;
+    if (revealage >= 1.0)
+        discard;
+
+    float weight = texelFetch(weightTexture, texel, 0).r;
+    vec3 average = accum.rgb / max(weight, 1e-5);
+
+    // Se mezcla con SRC_ALPHA, ONE_MINUS_SRC_ALPHA: escena * revealage + promedio * (1 - revealage)
+    color = vec4(average, 1.0 - revealage);
+}
@@ -0,0 +1,39 @@
+#version 330 core
+
+in vec2 TexCoords;
+in float Alpha;
+in float ViewDepth;
+
+out vec4 color;
+
+// Profundidad de la escena (resolucin completa) para recortar y suavizar contra la geometra
+uniform sampler2D sceneDepth;
+uniform vec2 targetSize;
+uniform float nearPlane;
+uniform float farPlane;
+uniform float softness;
+uniform float opacity;
+uniform vec3 smokeColor;
+
+float LinearDepth(float depth)
+{
+    float z = depth * 2.0 - 1.0;
+    return (2.0 * nearPlane * farPlane) / (farPlane + nearPlane - z * (farPlane - nearPlane));
+}
+
+void main()
+{
+    // Disco difuso en lugar de una textura
+    float shape = 1.0 - smoothstep(0.2, 1.0, length(TexCoords * 2.0 - 1.0));
+
+    // Partcula suave: se desvanece al acercarse a la geometra en vez de cortarse
+    float sceneZ = LinearDepth(texture(sceneDepth, gl_FragCoord.xy / targetSize).r);
+    float fade = clamp((sceneZ - ViewDepth) / softness, 0.0, 1.0);
+
+    float alpha = shape * Alpha * fade * opacity;
+    if (alpha <= 0.0)
+        discard;
+
+    // Alfa premultiplicado: las partculas se mezclan entre s en cualquier orden
+    color = vec4(smokeColor * alpha, alpha);
+}
@@ -0,0 +1,39 @@
+#version 330 core
+
+// Una instancia por partcula; los 4 vrtices de la tira forman un cuadro que mira a la cmara
+layout (location = 0) in vec4 positionAge;
+layout (location = 1) in vec4 velocityLife;
+
+out vec2 TexCoords;
+out float Alpha;
+out float ViewDepth;
+
+uniform mat4 view;
+uniform mat4 projection;
+uniform float particleSize;
+
+void main()
+{
+    vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+    TexCoords = corner;
+
+    float age = positionAge.w;
+    float t = clamp(age / velocityLife.w, 0.0, 1.0);
+
+    // El humo crece y se desvanece con la edad
+    float size = particleSize * mix(0.5, 2.0, t);
+    Alpha = smoothstep(0.0, 0.1, t) * (1.0 - t);
+
+    // Derecha y arriba de la cmara: las filas de la rotacin de view
+    vec3 right = vec3(view[0][0], view[1][0], view[2][0]);
+    vec3 up = vec3(view[0][1], view[1][1], view[2][1]);
+    vec3 world = positionAge.xyz + (right * (corner.x - 0.5) + up * (corner.y - 0.5)) * size;
+
+    vec4 viewPosition = view * vec4(world, 1.0);
+    ViewDepth = -viewPosition.z;
+    gl_Position = projection * viewPosition;
+
+    // Partculas que an no nacen: fuera del volumen de recorte
+    if (age <= 0.0)
+        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+}
@@ -0,0 +1,12 @@
+#version 330 core
+
+// Escala el buffer de partculas (media resolucin o completa) a la escena con filtrado bilineal
+uniform sampler2D particleTexture;
+uniform vec2 screenSize;
+
+out vec4 color;
+
+void main()
+{
+    color = texture(particleTexture, gl_FragCoord.xy / screenSize);
+}
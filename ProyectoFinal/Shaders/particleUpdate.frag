@@ -0,0 +1,7 @@
+#version 330 core
+
+// La simulacin corre con GL_RASTERIZER_DISCARD: este shader nunca se ejecuta,
+// solo completa el programa de particleUpdate.vs
+void main()
+{
+}
@@ -0,0 +1,54 @@
+#version 330 core
+
+// Simulacin de las partculas de humo con transform feedback (ver ParticleSystem.h).
+// Cada vrtice es una partcula; el resultado se escribe en el otro buffer del par.
+layout (location = 0) in vec4 inPositionAge;    // xyz = posicin, w = edad en segundos (negativa = an no nace)
+layout (location = 1) in vec4 inVelocityLife;   // xyz = velocidad, w = duracin de la vida
+
+out vec4 outPositionAge;
+out vec4 outVelocityLife;
+
+uniform vec3 emitter;
+uniform float emitterRadius;
+uniform vec3 wind;
+uniform float time;
+uniform float deltaTime;
+
+float Random(float seed)
+{
+    return fract(sin(seed * 12.9898 + 78.233) * 43758.5453);
+}
+
+void main()
+{
+    vec3 position = inPositionAge.xyz;
+    float age = inPositionAge.w + deltaTime;
+    vec3 velocity = inVelocityLife.xyz;
+    float life = inVelocityLife.w;
+
+    // Nace por primera vez (la edad pasa de negativa a positiva) o termina su vida
+    if (age >= life || (age > 0.0 && inPositionAge.w <= 0.0))
+    {
+        // Buffer circular: la partcula renace en el emisor en el mismo lugar del buffer,
+        // as el ritmo de emisin es constante (nmero de partculas / vida)
+        if (age >= life)
+            age -= life;
+        float seed = float(gl_VertexID) + time;
+        float angle = 6.2831853 * Random(seed);
+        float radius = emitterRadius * sqrt(Random(seed + 1.0));
+        position = emitter + vec3(cos(angle) * radius, 0.0, sin(angle) * radius);
+        velocity = vec3(Random(seed + 2.0) - 0.5, 2.0 + Random(seed + 3.0), Random(seed + 4.0) - 0.5) * 0.4;
+    }
+    else if (age > 0.0)
+    {
+        // Flotacin, viento y una turbulencia suave que depende de la altura
+        float swirl = position.y * 3.0 + time * 1.5 + float(gl_VertexID) * 0.1;
+        vec3 turbulence = vec3(sin(swirl), 0.0, cos(swirl * 1.3)) * 0.3;
+        velocity += (vec3(0.0, 0.15, 0.0) + wind + turbulence) * deltaTime;
+        velocity *= 1.0 - 0.6 * deltaTime;
+        position += velocity * deltaTime;
+    }
+
+    outPositionAge = vec4(position, age);
+    outVelocityLife = vec4(velocity, life);
+}
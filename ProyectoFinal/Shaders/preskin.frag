@@ -0,0 +1,7 @@
+#version 330 core
+
+// El pre-skinning corre con GL_RASTERIZER_DISCARD: este shader nunca se ejecuta,
+// solo completa el programa de skinning.vs con PRESKIN
+void main()
+{
+}
@@ -0,0 +1,113 @@
+#version 330 core
+
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in vec2 aTexCoords;
+layout (location = 5) in uvec4 aBoneIds;
+layout (location = 6) in vec4 aBoneWeights;
+
+#ifdef BAKED
+// Multitud instanciada (BakedCrowd): cada instancia trae su matriz de modelo y su clip; los huesos salen de
+// la animacin horneada (BakedAnimation) en lugar de la paleta, sin evaluar nada en la CPU
+layout (location = 7) in mat4 aInstanceModel;   // ubicaciones 7 a 10
+layout (location = 11) in vec4 aInstanceClip;   // primer frame, frames, desfase (s), velocidad
+
+uniform sampler2D bakedBones;   // bakedRowTexels texels por frame (tres por hueso), bakedFramesPerRow frames por fila
+uniform int bakedRowTexels;
+uniform int bakedFramesPerRow;
+uniform float bakedFramesPerSecond;
+uniform float time;
+#endif
+
+#ifdef PRESKIN
+// Pre-skinning (ModelAnim::Update): la malla deformada se captura con transform feedback en espacio del
+// modelo y las pasadas la dibujan como geometra esttica
+out vec3 SkinnedPosition;
+out vec3 SkinnedNormal;
+#else
+out vec3 Normal;
+out vec3 FragPos;
+out vec2 TexCoords;
+#endif
+
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+uniform mat3 normalMatrix;
+
+#ifndef BAKED
+// Paleta de huesos del esqueleto (BonePalette): tres texels por hueso con las filas de su matriz,
+// a partir de boneOffset (el segmento que se escribi en este frame). No hay lmite fijo de huesos
+uniform samplerBuffer bonePalette;
+uniform int boneOffset;
+#else
+ivec2 BakedTexel(int frame, int texel)
+{
+    return ivec2((frame % bakedFramesPerRow) * bakedRowTexels + texel, frame / bakedFramesPerRow);
+}
+
+// Fila k del hueso bone, interpolada entre los dos frames horneados que rodean el instante de la instancia
+vec4 BakedRow(int frame0, int frame1, float blend, int bone, int k)
+{
+    vec4 a = texelFetch(bakedBones, BakedTexel(frame0, bone * 3 + k), 0);
+    vec4 b = texelFetch(bakedBones, BakedTexel(frame1, bone * 3 + k), 0);
+    return mix(a, b, blend);
+}
+#endif
+
+// Suma ponderada de las filas de los cuatro huesos del vrtice; la cuarta fila siempre es (0, 0, 0, 1)
+void SkinRows(out vec4 row0, out vec4 row1, out vec4 row2)
+{
+#ifdef BAKED
+    // El clip se repite: despus del ltimo frame se interpola hacia el primero
+    float frames = aInstanceClip.y;
+    float frame = mod((time * aInstanceClip.w + aInstanceClip.z) * bakedFramesPerSecond, frames);
+    int local0 = min(int(frame), int(frames) - 1);
+    int frame0 = int(aInstanceClip.x) + local0;
+    int frame1 = int(aInstanceClip.x) + (local0 + 1) % int(frames);
+    float blend = frame - float(local0);
+#endif
+    row0 = vec4(0.0);
+    row1 = vec4(0.0);
+    row2 = vec4(0.0);
+    for (int i = 0; i < 4; i++)
+    {
+#ifdef BAKED
+        int bone = int(aBoneIds[i]);
+        row0 += aBoneWeights[i] * BakedRow(frame0, frame1, blend, bone, 0);
+        row1 += aBoneWeights[i] * BakedRow(frame0, frame1, blend, bone, 1);
+        row2 += aBoneWeights[i] * BakedRow(frame0, frame1, blend, bone, 2);
+#else
+        int texel = boneOffset + int(aBoneIds[i]) * 3;
+        row0 += aBoneWeights[i] * texelFetch(bonePalette, texel);
+        row1 += aBoneWeights[i] * texelFetch(bonePalette, texel + 1);
+        row2 += aBoneWeights[i] * texelFetch(bonePalette, texel + 2);
+#endif
+    }
+}
+
+void main()
+{
+    vec4 row0, row1, row2;
+    SkinRows(row0, row1, row2);
+
+    vec4 position = vec4(aPos, 1.0);
+    vec4 skinned = vec4(dot(row0, position), dot(row1, position), dot(row2, position), 1.0);
+    vec3 skinnedNormal = vec3(dot(row0.xyz, aNormal), dot(row1.xyz, aNormal), dot(row2.xyz, aNormal));
+
+#ifdef PRESKIN
+    SkinnedPosition = skinned.xyz;
+    SkinnedNormal = skinnedNormal;
+#elif defined(BAKED)
+    // Sin normalMatrix por instancia: se supone escala uniforme en aInstanceModel
+    gl_Position = projection * view * aInstanceModel * skinned;
+    FragPos = vec3(aInstanceModel * skinned);
+    Normal = mat3(aInstanceModel) * skinnedNormal;
+    TexCoords = aTexCoords;
+#else
+    gl_Position = projection * view * model * skinned;
+    FragPos = vec3(model * skinned);
+    Normal = normalMatrix * skinnedNormal;
+    TexCoords = aTexCoords;
+#endif
+}
@@ -0,0 +1,405 @@
+#pragma once
+
+// Std. Includes
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cmath>
+
+// GL Includes
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "Shader.h"
+#include "Model.h"
+#include "modelAnim.h"
+#include "AnimatedInstance.h"
+#include "AnimationSystem.h"
+#include "RenderQueue.h"
+#include "Lights.h"
+
+// Tamao de una escena generada. Con la misma semilla se obtiene exactamente la misma escena
+struct StressSceneConfig
+{
+	unsigned int houses = 4;        // casas en una cuadrcula, separadas por calles
+	unsigned int propsPerRoom = 4;  // muebles en cada uno de los ROOMS_PER_HOUSE cuartos
+	unsigned int lights = 8;        // puntuales repartidas entre los cuartos (ms la direccional, hasta MAX_LIGHTS)
+	unsigned int characters = 0;    // personajes animados en las calles; solo si se carg un modelo animado
+	unsigned int seed = 1;
+};
+
+// Escena sinttica para pruebas de escala hecha con los modelos del proyecto. Cada archivo se carga una sola
+// vez (LoadAssets) y Generate coloca instancias: casas (piso, casa y puerta) en una cuadrcula, muebles al azar
+// dentro de los cuartos de cada casa, luces puntuales en los cuartos y personajes (AnimatedInstance sobre un
+// ModelAnim compartido) caminando en las calles. Las matrices de mundo se calculan al generar; cada frame solo
+// se registran en la RenderQueue. Cada modelo lleva la misma correccin de orientacin y escala que en main
+// y adems se centra sobre su base con sus lmites, as los que vienen en coordenadas de la casa (bur,
+// lmpara, chimenea) se pueden mover a cualquier cuarto
+class StressScene
+{
+public:
+	static const unsigned int ROOMS_PER_HOUSE = 4;  // los cuadrantes de la planta de la casa
+
+	StressScene() : character(NULL), characterShader(NULL), loadMs(0.0)
+	{
+	}
+
+	~StressScene()
+	{
+		Release();
+	}
+
+	// Carga los modelos del proyecto y, si characterPath no est vaco, el personaje; devuelve los ms que tard
+	double LoadAssets(const std::string& characterPath)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		const glm::vec3 X(1.0f, 0.0f, 0.0f), Y(0.0f, 1.0f, 0.0f), Z(0.0f, 0.0f, 1.0f);
+
+		// La casa: sus tres partes comparten las coordenadas del archivo
+		glm::mat4 shellCorrection = Rotate(glm::mat4(1.0f), 90.0f, Y);
+		const char* shellPaths[] = { "Models/Piso/cuphead.obj", "Models/casa-taza/cuphead.obj", "Models/Puerta/cuphead.obj" };
+		for (unsigned int i = 0; i < 3; i++)
+			this->shell.parts.push_back(Load(shellPaths[i]));
+		this->shell.correction = shellCorrection;
+		this->shell.recenter = glm::mat4(1.0f);
+		ComputeBounds(this->shell);
+
+		// Muebles, con la correccin de main reducida (tres giros de -90 en Z son uno de 90, etc.)
+		AddProp("Models/sillon/sillon.obj", NULL, Rotate(glm::scale(glm::mat4(1.0f), glm::vec3(1.3f)), 90.0f, Y));
+		AddProp("Models/piano/piano.obj", NULL, Rotate(glm::scale(glm::mat4(1.0f), glm::vec3(0.9f)), 90.0f, Y));
+		AddProp("Models/estante/Estante.fbx", NULL, Rotate(Rotate(glm::scale(glm::mat4(1.0f), glm::vec3(0.2f)), -90.0f, X), 90.0f, Z));
+		AddProp("Models/radio/radio.fbx", NULL, Rotate(Rotate(glm::scale(glm::mat4(1.0f), glm::vec3(0.5f)), 90.0f, Z), 90.0f, Y));
+		AddProp("Models/fonografo/fonografo.fbx", NULL, Rotate(Rotate(glm::scale(glm::mat4(1.0f), glm::vec3(0.7f)), -90.0f, X), 180.0f, Z));
+		AddProp("Models/sillaMecedora/mecedora.obj", NULL, Rotate(glm::scale(glm::mat4(1.0f), glm::vec3(0.02f)), 90.0f, Y));
+		AddProp("Models/espada/espada.obj", NULL, Rotate(Rotate(Rotate(glm::scale(glm::mat4(1.0f), glm::vec3(0.3f)), -90.0f, X), 90.0f, Y), 90.0f, Z));
+		AddProp("Models/chimenea/chimenea/cuphead.obj", NULL, Rotate(glm::mat4(1.0f), 90.0f, Y));
+		AddProp("Models/Estante2/Estante/cuphead.obj", NULL, Rotate(glm::mat4(1.0f), 270.0f, Y));
+		AddProp("Models/Buro/Buro_base.obj", "Models/Buro/Buro_cajon.obj", Rotate(glm::mat4(1.0f), 90.0f, Y));
+		if (AddProp("Models/Lampara/lampara.obj", NULL, Rotate(glm::mat4(1.0f), 90.0f, Y)))
+			this->props.back().parts[0]->SetAlphaMode(ALPHA_BLENDED);  // semitransparente, como en main
+
+		if (!characterPath.empty())
+		{
+			this->character = new ModelAnim(characterPath);
+			if (this->character->m_clips.empty())
+			{
+				std::cout << "StressScene: " << characterPath << " no tiene esqueleto animado, la escena va sin personajes" << std::endl;
+				delete this->character;
+				this->character = NULL;
+			}
+			else
+			{
+				this->characterShader = new Shader("Shaders/skinning.vs", "Shaders/lighting.frag");
+				LightBuffer::BindProgram(this->characterShader->Program);
+				this->character->initShaders(this->characterShader->Program);
+			}
+		}
+
+		this->loadMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		return this->loadMs;
+	}
+
+	// Descarta la escena anterior y coloca la nueva; devuelve los ms que tard (incluye crear los personajes)
+	double Generate(const StressSceneConfig& config)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		ReleaseScene();
+		this->config = config;
+		if (this->character == NULL)
+			this->config.characters = 0;
+		this->config.lights = std::min(this->config.lights, MAX_LIGHTS - 1);
+
+		std::mt19937 random(config.seed);
+		std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+		// Cuadrcula de casas, cada una girada un mltiplo de 90 grados
+		glm::vec3 shellSize = this->shell.boundsMax - this->shell.boundsMin;
+		this->spacing = std::max(shellSize.x, shellSize.z) + STREET_WIDTH;
+		this->columns = (unsigned int)std::ceil(std::sqrt((float)std::max(this->config.houses, 1u)));
+		std::vector<glm::mat4> houses;
+		for (unsigned int h = 0; h < this->config.houses; h++)
+		{
+			glm::vec3 position((h % this->columns) * this->spacing, 0.0f, (h / this->columns) * this->spacing);
+			glm::mat4 house = Rotate(glm::translate(glm::mat4(1.0f), position), 90.0f * (random() % 4), glm::vec3(0.0f, 1.0f, 0.0f));
+			houses.push_back(house);
+			for (unsigned int p = 0; p < this->shell.parts.size(); p++)
+				Place(*this->shell.parts[p], house * this->shell.correction);
+
+			// Muebles en los cuadrantes de la planta, sin salirse de ella
+			for (unsigned int r = 0; r < ROOMS_PER_HOUSE; r++)
+			{
+				glm::vec2 roomMin, roomMax;
+				Room(r, roomMin, roomMax);
+				for (unsigned int i = 0; i < this->config.propsPerRoom && !this->props.empty(); i++)
+				{
+					const Asset& prop = this->props[random() % this->props.size()];
+					float x = Lerp(roomMin.x + prop.radius, roomMax.x - prop.radius, unit(random));
+					float z = Lerp(roomMin.y + prop.radius, roomMax.y - prop.radius, unit(random));
+					glm::mat4 world = Rotate(glm::translate(house, glm::vec3(x, 0.0f, z)), 90.0f * (random() % 4), glm::vec3(0.0f, 1.0f, 0.0f));
+					for (unsigned int p = 0; p < prop.parts.size(); p++)
+						Place(*prop.parts[p], world * prop.recenter * prop.correction);
+				}
+			}
+		}
+
+		// Luces: una por cuarto en orden (todas las casas, luego el siguiente cuarto), a media altura
+		for (unsigned int i = 0; i < this->config.lights && !houses.empty(); i++)
+		{
+			glm::vec2 roomMin, roomMax;
+			Room((i / (unsigned int)houses.size()) % ROOMS_PER_HOUSE, roomMin, roomMax);
+			glm::vec2 center = (roomMin + roomMax) * 0.5f;
+			PointLight light;
+			light.position = glm::vec3(houses[i % houses.size()] * glm::vec4(center.x, 0.6f * this->shell.boundsMax.y, center.y, 1.0f));
+			light.color = glm::vec3(1.0f, 0.75f + 0.2f * unit(random), 0.5f + 0.3f * unit(random));
+			this->lights.push_back(light);
+		}
+
+		// Personajes en las calles (las lneas entre columnas y filas de casas), cada uno con otro clip y desfase
+		float blockHalf = 0.5f * this->spacing;
+		unsigned int rows = (this->config.houses + this->columns - 1) / std::max(this->columns, 1u);
+		for (unsigned int i = 0; i < this->config.characters; i++)
+		{
+			glm::vec3 position;
+			if (random() % 2 == 0)
+				position = glm::vec3((random() % (this->columns + 1)) * this->spacing - blockHalf, 0.0f, (unit(random) * rows - 0.5f) * this->spacing);
+			else
+				position = glm::vec3((unit(random) * this->columns - 0.5f) * this->spacing, 0.0f, (random() % (rows + 1)) * this->spacing - blockHalf);
+
+			AnimatedInstance* instance = new AnimatedInstance(*this->character);
+			unsigned int clip = i % this->character->m_clips.size();
+			const AnimationClip& source = this->character->m_clips[clip];
+			instance->Player().Play(clip, 0.0f, 0.8f + 0.4f * unit(random));
+			instance->Player().SetTime(0, unit(random) * source.duration / source.ticks_per_second);
+			this->instances.push_back(instance);
+
+			float scale = this->character->m_bounds_radius > 0.0f ? CHARACTER_RADIUS / this->character->m_bounds_radius : 1.0f;
+			glm::mat4 world = glm::scale(glm::translate(glm::mat4(1.0f), position), glm::vec3(scale));
+			this->animation.Add(*instance, world);
+		}
+
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	// Registra todos los objetos estticos en la cola del frame
+	void Submit(RenderQueue& queue) const
+	{
+		for (unsigned int i = 0; i < this->objects.size(); i++)
+			queue.Submit(*this->objects[i].model, this->objects[i].transform);
+	}
+
+	// Agrega las luces puntuales de la escena despus de las que ya tenga el buffer
+	void AddLights(LightBuffer& buffer) const
+	{
+		for (unsigned int i = 0; i < this->lights.size(); i++)
+		{
+			const PointLight& light = this->lights[i];
+			buffer.AddPoint(light.position, 0.02f * light.color, light.color, light.color, 1.0f, 0.35f, 0.44f, 1.0f);
+		}
+	}
+
+	// Avanza y evala los personajes (AnimationSystem, en paralelo y con niveles de detalle)
+	void UpdateCharacters(double timeInSec, const glm::mat4& view, const glm::mat4& projection)
+	{
+		if (!this->instances.empty())
+			this->animation.Update(timeInSec, view, projection);
+	}
+
+	// Dibuja los personajes visibles con skinning e iluminacin; el buffer de luces ya debe estar subido
+	void DrawCharacters(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& viewPos)
+	{
+		if (this->instances.empty())
+			return;
+		// Los personajes solo se trasladan y escalan uniformemente: la matriz normal es la identidad
+		glm::mat3 normalMatrix(1.0f);
+		GLuint program = this->characterShader->Program;
+		this->characterShader->Use();
+		RenderStats::UniformMatrix4fv(glGetUniformLocation(program, "view"), 1, GL_FALSE, glm::value_ptr(view));
+		RenderStats::UniformMatrix4fv(glGetUniformLocation(program, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+		RenderStats::UniformMatrix3fv(glGetUniformLocation(program, "normalMatrix"), 1, GL_FALSE, glm::value_ptr(normalMatrix));
+		RenderStats::Uniform3f(glGetUniformLocation(program, "viewPos"), viewPos.x, viewPos.y, viewPos.z);
+		this->animation.Draw(*this->characterShader, glGetUniformLocation(program, "model"));
+	}
+
+	// Centro y radio del vecindario en el piso, para colocar la cmara
+	glm::vec3 Center() const
+	{
+		unsigned int rows = (this->config.houses + this->columns - 1) / std::max(this->columns, 1u);
+		return glm::vec3(0.5f * (this->columns - 1) * this->spacing, 0.0f, 0.5f * (rows - 1) * this->spacing);
+	}
+
+	float Radius() const
+	{
+		unsigned int rows = (this->config.houses + this->columns - 1) / std::max(this->columns, 1u);
+		return 0.5f * std::sqrt((float)(this->columns * this->columns + rows * rows)) * this->spacing;
+	}
+
+	const StressSceneConfig& Config() const { return this->config; }
+	unsigned int Objects() const { return (unsigned int)this->objects.size(); }
+	unsigned int Lights() const { return (unsigned int)this->lights.size(); }
+	unsigned int Characters() const { return (unsigned int)this->instances.size(); }
+	bool HasCharacter() const { return this->character != NULL; }
+	double LoadMs() const { return this->loadMs; }
+
+	// Bytes en la CPU de la escena generada (sin los modelos compartidos): objetos, luces y personajes
+	size_t MemoryBytes() const
+	{
+		size_t bytes = this->objects.capacity() * sizeof(Object) + this->lights.capacity() * sizeof(PointLight);
+		for (unsigned int i = 0; i < this->instances.size(); i++)
+			bytes += this->instances[i]->MemoryBytes();
+		return bytes;
+	}
+
+private:
+	static constexpr float STREET_WIDTH = 6.0f;
+	static constexpr float CHARACTER_RADIUS = 1.0f;  // radio de la esfera de reposo del personaje en la escena
+	static constexpr float ROOM_MARGIN = 0.5f;       // distancia de los muebles a las paredes
+
+	// Un archivo (o varios que van juntos, como el bur y su cajn) con su correccin y sus lmites corregidos
+	struct Asset
+	{
+		std::vector<Model*> parts;
+		glm::mat4 correction;
+		glm::mat4 recenter;  // lleva el centro de la base al origen
+		glm::vec3 boundsMin, boundsMax;
+		float radius;        // media diagonal de la base
+	};
+
+	struct Object
+	{
+		Model* model;
+		glm::mat4 transform;
+	};
+
+	struct PointLight
+	{
+		glm::vec3 position;
+		glm::vec3 color;
+	};
+
+	std::vector<Model*> models;  // todos los cargados, para liberarlos
+	Asset shell;
+	std::vector<Asset> props;
+	ModelAnim* character;
+	Shader* characterShader;
+	double loadMs;
+
+	StressSceneConfig config;
+	float spacing = 0.0f;
+	unsigned int columns = 1;
+	std::vector<Object> objects;
+	std::vector<PointLight> lights;
+	std::vector<AnimatedInstance*> instances;
+	AnimationSystem animation;
+
+	StressScene(const StressScene&);
+	StressScene& operator=(const StressScene&);
+
+	Model* Load(const char* path)
+	{
+		Model* model = new Model(path);
+		this->models.push_back(model);
+		return model;
+	}
+
+	// false si el archivo no tiene mallas y se descarta
+	bool AddProp(const char* path, const char* attached, const glm::mat4& correction)
+	{
+		Asset prop;
+		prop.parts.push_back(Load(path));
+		if (attached != NULL)
+			prop.parts.push_back(Load(attached));
+		prop.correction = correction;
+		if (!ComputeBounds(prop))
+		{
+			std::cout << "ERROR::STRESS_SCENE:: " << path << " no tiene mallas, no se usa" << std::endl;
+			return false;
+		}
+		glm::vec3 center = (prop.boundsMin + prop.boundsMax) * 0.5f;
+		prop.recenter = glm::translate(glm::mat4(1.0f), glm::vec3(-center.x, -prop.boundsMin.y, -center.z));
+		this->props.push_back(prop);
+		return true;
+	}
+
+	// Caja de las mallas de todas las partes con la correccin aplicada; false si no hay mallas
+	static bool ComputeBounds(Asset& asset)
+	{
+		bool any = false;
+		for (unsigned int p = 0; p < asset.parts.size(); p++)
+		{
+			const std::vector<Mesh>& meshes = asset.parts[p]->meshes;
+			for (unsigned int m = 0; m < meshes.size(); m++)
+			{
+				for (int corner = 0; corner < 8; corner++)
+				{
+					glm::vec3 local((corner & 1) ? meshes[m].boundsMax.x : meshes[m].boundsMin.x,
+						(corner & 2) ? meshes[m].boundsMax.y : meshes[m].boundsMin.y,
+						(corner & 4) ? meshes[m].boundsMax.z : meshes[m].boundsMin.z);
+					glm::vec3 point = glm::vec3(asset.correction * glm::vec4(local, 1.0f));
+					asset.boundsMin = any ? glm::min(asset.boundsMin, point) : point;
+					asset.boundsMax = any ? glm::max(asset.boundsMax, point) : point;
+					any = true;
+				}
+			}
+		}
+		if (!any)
+			asset.boundsMin = asset.boundsMax = glm::vec3(0.0f);
+		glm::vec3 size = asset.boundsMax - asset.boundsMin;
+		asset.radius = 0.5f * std::sqrt(size.x * size.x + size.z * size.z);
+		return any;
+	}
+
+	// Cuadrante r de la planta de la casa (coordenadas corregidas de la casa) menos el margen de las paredes
+	void Room(unsigned int r, glm::vec2& roomMin, glm::vec2& roomMax) const
+	{
+		glm::vec2 planMin(this->shell.boundsMin.x + ROOM_MARGIN, this->shell.boundsMin.z + ROOM_MARGIN);
+		glm::vec2 planMax(this->shell.boundsMax.x - ROOM_MARGIN, this->shell.boundsMax.z - ROOM_MARGIN);
+		glm::vec2 half = glm::max((planMax - planMin) * 0.5f, glm::vec2(0.0f));
+		roomMin = planMin + glm::vec2((float)(r % 2), (float)(r / 2)) * half;
+		roomMax = roomMin + half;
+	}
+
+	void Place(Model& model, const glm::mat4& transform)
+	{
+		Object object = { &model, transform };
+		this->objects.push_back(object);
+	}
+
+	// Si el mueble no cabe en el cuarto queda en el centro
+	static float Lerp(float low, float high, float t)
+	{
+		return low <= high ? low + (high - low) * t : 0.5f * (low + high);
+	}
+
+	static glm::mat4 Rotate(const glm::mat4& m, float degrees, const glm::vec3& axis)
+	{
+		return glm::rotate(m, glm::radians(degrees), axis);
+	}
+
+	void ReleaseScene()
+	{
+		this->animation.Clear();
+		for (unsigned int i = 0; i < this->instances.size(); i++)
+			delete this->instances[i];
+		this->instances.clear();
+		this->objects.clear();
+		this->lights.clear();
+	}
+
+	void Release()
+	{
+		ReleaseScene();
+		for (unsigned int i = 0; i < this->models.size(); i++)
+			delete this->models[i];
+		this->models.clear();
+		delete this->character;
+		delete this->characterShader;
+		this->character = NULL;
+		this->characterShader = NULL;
+	}
+};
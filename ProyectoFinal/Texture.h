@@ -15,13 +15,16 @@ class TextureLoading
 public:
 	static GLuint LoadTexture(GLchar *path)
 	{
+		LoadReport::Asset report(path, "textura");
+		LoadReport::Texture reportTexture(path);
 		unsigned int textureID;
 		glGenTextures(1, &textureID);
 
 		int width, height, nrComponents;
-		unsigned char *data = stbi_load(path, &width, &height, &nrComponents, 0);
+		unsigned char *data = ReadImage(path, &width, &height, &nrComponents);
 		if (data)
 		{
+			reportTexture.SetSize(width, height, nrComponents);
 			GLenum format;
 			if (nrComponents == 1)
 				format = GL_RED;
@@ -31,8 +34,15 @@ public:
 				format = GL_RGBA;
 
 			glBindTexture(GL_TEXTURE_2D, textureID);
-			glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-			glGenerateMipmap(GL_TEXTURE_2D);
+			{
+				LoadReport::Stage stage(LoadReport::UPLOAD, true);
+				glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+			}
+			{
+				LoadReport::Stage stage(LoadReport::MIPMAPS, true);
+				glGenerateMipmap(GL_TEXTURE_2D);
+			}
+			RenderStats::TrackTextureMemory((GLint64)width * height * nrComponents * 4 / 3);
 
 			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
 			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
@@ -54,16 +64,23 @@ public:
 
 	static GLuint LoadCubemap(vector<const GLchar * > faces)
 	{
+		LoadReport::Asset report(faces.empty() ? "" : faces[0], "cubemap");
 		GLuint textureID;
 		glGenTextures(1, &textureID);
 
 		int width, height, nrChannels;
 		for (unsigned int i = 0; i < faces.size(); i++)
 		{
-			unsigned char *data = stbi_load(faces[i], &width, &height, &nrChannels, 0);
+			LoadReport::Texture reportTexture(faces[i]);
+			unsigned char *data = ReadImage(faces[i], &width, &height, &nrChannels);
 			if (data)
 			{
-				glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
+				reportTexture.SetSize(width, height, nrChannels);
+				{
+					LoadReport::Stage stage(LoadReport::UPLOAD, true);
+					glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
+				}
+				RenderStats::TrackTextureMemory((GLint64)width * height * 3);
 				stbi_image_free(data);
 			}
 			else
@@ -0,0 +1,212 @@
+#pragma once
+
+// Std. Includes
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <chrono>
+
+// GL Includes
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "Shader.h"
+#include "Model.h"
+#include "Lights.h"
+#include "Framebuffer.h"
+#include "OitBuffer.h"
+#include "RenderQueue.h"
+
+// Escena de prueba con muchos planos transparentes superpuestos para comparar la mezcla
+// ordenada (RenderQueue::DrawBlended, ordena en la CPU cada frame) contra la transparencia
+// ponderada (OitBuffer + RenderQueue::DrawWeighted, sin ordenar). La cmara gira un poco en
+// cada frame para que el orden cambie como en un recorrido.
+class TransparencyBenchmark
+{
+public:
+	TransparencyBenchmark(GLuint frames = 30, GLuint warmupFrames = 5)
+		: frames(frames), warmupFrames(warmupFrames)
+	{
+	}
+
+	// Mide ambos mtodos a 1080p fuera de pantalla con 256, 1024 y 4096 planos
+	void Run(LightBuffer& lights)
+	{
+		Shader blendShader("Shaders/lighting.vs", "Shaders/lighting.frag");
+		Shader oitShader("Shaders/lighting.vs", "Shaders/lighting.frag", "#define WEIGHTED_OIT\n");
+		Shader compositeShader("Shaders/fullscreen.vs", "Shaders/oitComposite.frag");
+		LightBuffer::BindProgram(blendShader.Program);
+		LightBuffer::BindProgram(oitShader.Program);
+		lights.Upload();
+
+		Model quad;
+		quad.meshes.push_back(CreateQuad());
+
+		const GLsizei width = 1920, height = 1080;
+		Framebuffer target(width, height);
+		OitBuffer oit(width, height, target.depthTexture);
+
+		std::cout << std::endl << "Transparency benchmark (" << width << "x" << height << ", " << this->frames << " frames)" << std::endl;
+		std::cout << std::left << std::setw(10) << "objetos" << std::setw(10) << "metodo"
+			<< std::right << std::setw(12) << "cpu ms" << std::setw(12) << "wall ms" << std::setw(10) << "speedup" << std::endl;
+
+		const GLuint counts[] = { 256, 1024, 4096 };
+		for (unsigned int c = 0; c < 3; c++)
+		{
+			RenderQueue queue;
+			std::srand(counts[c]);
+			for (GLuint i = 0; i < counts[c]; i++)
+			{
+				glm::vec3 position(Random(-8.0f, 8.0f), Random(-5.0f, 5.0f), Random(-20.0f, 10.0f));
+				glm::mat4 model = glm::translate(glm::mat4(1.0f), position);
+				model = glm::rotate(model, glm::radians(Random(-30.0f, 30.0f)), glm::vec3(0.0f, 1.0f, 0.0f));
+				queue.Submit(quad, model);
+			}
+
+			Timing sorted = Measure(queue, false, blendShader, oitShader, compositeShader, target, oit);
+			Timing weighted = Measure(queue, true, blendShader, oitShader, compositeShader, target, oit);
+
+			PrintRow(counts[c], "sorted", sorted, 1.0);
+			PrintRow(counts[c], "oit", weighted, sorted.wallMs / weighted.wallMs);
+		}
+		std::cout << std::endl;
+
+		Framebuffer::Unbind();
+		for (unsigned int i = 0; i < quad.meshes[0].textures.size(); i++)
+		{
+			glDeleteTextures(1, &quad.meshes[0].textures[i].id);
+		}
+	}
+
+private:
+	GLuint frames;
+	GLuint warmupFrames;
+
+	// Promedios por frame: CPU = emitir los draws (incluye el ordenamiento), wall = entre dos glFinish
+	struct Timing
+	{
+		double cpuMs;
+		double wallMs;
+	};
+
+	Timing Measure(RenderQueue& queue, bool weighted, Shader& blendShader, Shader& oitShader, Shader& compositeShader,
+		Framebuffer& target, OitBuffer& oit)
+	{
+		glm::mat4 projection = glm::perspective(glm::radians(45.0f), (GLfloat)target.width / (GLfloat)target.height, 0.1f, 100.0f);
+
+		std::chrono::duration<double, std::milli> cpu(0.0);
+		std::chrono::steady_clock::time_point wallStart;
+		for (GLuint frame = 0; frame < this->warmupFrames + this->frames; frame++)
+		{
+			bool timed = frame >= this->warmupFrames;
+			if (frame == this->warmupFrames)
+			{
+				glFinish();
+				wallStart = std::chrono::steady_clock::now();
+			}
+
+			GLfloat angle = glm::radians(20.0f) * glm::sin(0.1f * frame);
+			glm::vec3 eye = glm::vec3(30.0f * glm::sin(angle), 0.0f, 30.0f * glm::cos(angle));
+			glm::mat4 view = glm::lookAt(eye, glm::vec3(0.0f, 0.0f, -5.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+			SetCameraUniforms(weighted ? oitShader : blendShader, view, projection, eye);
+
+			target.Bind();
+			glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+			std::chrono::steady_clock::time_point cpuStart = std::chrono::steady_clock::now();
+			if (weighted)
+			{
+				oit.Begin();
+				queue.DrawWeighted(oitShader);
+				oit.Composite(compositeShader, target);
+			}
+			else
+			{
+				queue.DrawBlended(blendShader, eye);
+			}
+			if (timed)
+				cpu += std::chrono::steady_clock::now() - cpuStart;
+		}
+		glFinish();
+		std::chrono::duration<double, std::milli> wall = std::chrono::steady_clock::now() - wallStart;
+
+		Timing timing;
+		timing.cpuMs = cpu.count() / this->frames;
+		timing.wallMs = wall.count() / this->frames;
+		return timing;
+	}
+
+	void PrintRow(GLuint objects, const char* name, Timing timing, double speedup)
+	{
+		std::cout << std::left << std::setw(10) << objects << std::setw(10) << name
+			<< std::right << std::fixed << std::setprecision(3) << std::setw(12) << timing.cpuMs << std::setw(12) << timing.wallMs
+			<< std::setprecision(2) << std::setw(9) << speedup << "x" << std::endl;
+	}
+
+	static void SetCameraUniforms(Shader& shader, const glm::mat4& view, const glm::mat4& projection, glm::vec3 eye)
+	{
+		shader.Use();
+		glUniformMatrix4fv(glGetUniformLocation(shader.Program, "view"), 1, GL_FALSE, glm::value_ptr(view));
+		glUniformMatrix4fv(glGetUniformLocation(shader.Program, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+		glUniform3f(glGetUniformLocation(shader.Program, "viewPos"), eye.x, eye.y, eye.z);
+		glUniform1i(glGetUniformLocation(shader.Program, "material.diffuse"), 0);
+		glUniform1i(glGetUniformLocation(shader.Program, "material.specular"), 1);
+	}
+
+	static GLfloat Random(GLfloat min, GLfloat max)
+	{
+		return min + (max - min) * ((GLfloat)std::rand() / RAND_MAX);
+	}
+
+	// Plano de 2x2 mirando a +z con una textura difusa semitransparente (alfa entre 0.25 y 0.6)
+	static Mesh CreateQuad()
+	{
+		vector<Vertex> vertices(4);
+		const GLfloat corners[4][2] = { { -1.0f, -1.0f }, { 1.0f, -1.0f }, { 1.0f, 1.0f }, { -1.0f, 1.0f } };
+		for (unsigned int i = 0; i < 4; i++)
+		{
+			vertices[i].Position = glm::vec3(corners[i][0], corners[i][1], 0.0f);
+			vertices[i].Normal = glm::vec3(0.0f, 0.0f, 1.0f);
+			vertices[i].TexCoords = glm::vec2(corners[i][0], corners[i][1]) * 0.5f + 0.5f;
+			vertices[i].Tangent = glm::vec3(1.0f, 0.0f, 0.0f);
+			vertices[i].Bitangent = glm::vec3(0.0f, 1.0f, 0.0f);
+		}
+		vector<unsigned int> indices = { 0, 1, 2, 0, 2, 3 };
+
+		vector<Texture> textures(2);
+		textures[0].id = CreateTexture(64, 96, 160);
+		textures[0].type = "texture_diffuse";
+		textures[1].id = CreateTexture(0, 255, 255);
+		textures[1].type = "texture_specular";
+
+		return Mesh(vertices, indices, textures, ALPHA_BLENDED);
+	}
+
+	// Textura de 64x64 con color aleatorio a partir de colorMin y alfa entre alphaMin y alphaMax
+	static GLuint CreateTexture(int colorMin, int alphaMin, int alphaMax)
+	{
+		const int size = 64;
+		std::vector<unsigned char> pixels(size * size * 4);
+		for (unsigned int i = 0; i < pixels.size(); i += 4)
+		{
+			for (unsigned int c = 0; c < 3; c++)
+				pixels[i + c] = (unsigned char)(colorMin + std::rand() % (256 - colorMin));
+			pixels[i + 3] = (unsigned char)(alphaMin + std::rand() % (alphaMax - alphaMin + 1));
+		}
+
+		GLuint textureID;
+		glGenTextures(1, &textureID);
+		glBindTexture(GL_TEXTURE_2D, textureID);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, size, size, 0, GL_RGBA, GL_UNSIGNED_BYTE, &pixels[0]);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		return textureID;
+	}
+};
@@ -6,8 +6,9 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
-#include "shader.h"
-#include "mesh.h"
+#include "Shader.h"
+#include "Mesh.h"
+#include "RenderStats.h"
 
 #include <string>
 #include <fstream>
@@ -25,28 +26,79 @@ struct BoneMatrix
 	aiMatrix4x4 final_world_transform;
 };
 
+#define MAX_PACKED_BONES 256 // los indices de hueso se guardan en un byte
+
+// Stream de huesos que lee el vertex shader: 8 bytes por vertice. Los indices son uint8 (atributo 5, uvec4)
+// y los pesos unorm8 (atributo 6, vec4 normalizado) que suman exactamente 255
 struct VertexBoneData
 {
-	uint ids[NUM_BONES_PER_VEREX];   // we have 4 bone ids for EACH vertex & 4 weights for EACH vertex
-	float weights[NUM_BONES_PER_VEREX];
+	GLubyte ids[NUM_BONES_PER_VEREX];   // we have 4 bone ids for EACH vertex & 4 weights for EACH vertex
+	GLubyte weights[NUM_BONES_PER_VEREX];
 
 	VertexBoneData()
 	{
 		memset(ids, 0, sizeof(ids));    // init all values in array = 0
 		memset(weights, 0, sizeof(weights));
 	}
+};
+
+// Influencias de un vertice durante la importacion: conserva las cuatro de mayor peso y lleva la cuenta
+// de las que se descartan, luego pack() las renormaliza y las cuantiza al formato de VertexBoneData
+struct VertexInfluences
+{
+	uint ids[NUM_BONES_PER_VEREX];
+	float weights[NUM_BONES_PER_VEREX];
+	uint count;          // influencias recibidas, incluidas las descartadas
+	float dropped;       // peso total descartado
+
+	VertexInfluences() : count(0), dropped(0.0f)
+	{
+		memset(ids, 0, sizeof(ids));
+		memset(weights, 0, sizeof(weights));
+	}
 
 	void addBoneData(uint bone_id, float weight)
 	{
+		count++;
+		// Si ya hay cuatro se reemplaza la de menor peso, solo si la nueva pesa mas
+		uint smallest = 0;
+		for (uint i = 1; i < NUM_BONES_PER_VEREX; i++)
+		{
+			if (weights[i] < weights[smallest])
+				smallest = i;
+		}
+		if (weight <= weights[smallest])
+		{
+			dropped += weight;
+			return;
+		}
+		dropped += weights[smallest];
+		ids[smallest] = bone_id;
+		weights[smallest] = weight;
+	}
+
+	// Pesos renormalizados a 255 en total; el error de redondeo se lo queda la influencia mayor
+	VertexBoneData pack() const
+	{
+		VertexBoneData packed;
+		float total = 0.0f;
+		for (uint i = 0; i < NUM_BONES_PER_VEREX; i++)
+			total += weights[i];
+		if (total <= 0.0f)
+			return packed;
+
+		int sum = 0;
+		uint largest = 0;
 		for (uint i = 0; i < NUM_BONES_PER_VEREX; i++)
 		{
-			if (weights[i] == 0.0)
-			{
-				ids[i] = bone_id;
-				weights[i] = weight;
-				return;
-			}
+			packed.ids[i] = (GLubyte)(ids[i] < MAX_PACKED_BONES ? ids[i] : 0);
+			packed.weights[i] = (GLubyte)(weights[i] / total * 255.0f + 0.5f);
+			sum += packed.weights[i];
+			if (weights[i] > weights[largest])
+				largest = i;
 		}
+		packed.weights[largest] = (GLubyte)(packed.weights[largest] + 255 - sum);
+		return packed;
 	}
 };
 
@@ -58,6 +110,8 @@ public:
     vector<Texture> textures;
 	vector<VertexBoneData> bones_id_weights_for_each_vertex;
     unsigned int VAO;
+	unsigned int skinnedVAO = 0; // malla ya deformada por preSkin (0 = sin pre-skinning)
+	unsigned int instancedVAO = 0; // malla con atributos por instancia (0 = sin instancias, ver enableInstancing)
 
     /*  Functions  */
     // constructor
@@ -85,7 +139,131 @@ public:
     // render the mesh
     void Draw(Shader shader) 
     {
-        // bind appropriate textures
+        bindTextures(shader);
+
+        // draw mesh
+        RenderStats::BindVertexArray(VAO);
+        RenderStats::DrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
+        glBindVertexArray(0);
+
+        // always good practice to set everything back to defaults once configured.
+        glActiveTexture(GL_TEXTURE0);
+    }
+
+	// Dibuja la malla deformada en el ultimo preSkin como geometria estatica (p. ej. con Shaders/lighting.vs)
+	void DrawSkinned(Shader shader)
+	{
+		bindTextures(shader);
+
+		RenderStats::BindVertexArray(skinnedVAO);
+		RenderStats::DrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
+		glBindVertexArray(0);
+
+		glActiveTexture(GL_TEXTURE0);
+	}
+
+	// Dibuja count instancias con el buffer de enableInstancing (p. ej. skinning.vs con BAKED)
+	void DrawInstanced(Shader shader, GLsizei count)
+	{
+		bindTextures(shader);
+
+		RenderStats::BindVertexArray(instancedVAO);
+		RenderStats::DrawElementsInstanced(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0, count);
+		glBindVertexArray(0);
+
+		glActiveTexture(GL_TEXTURE0);
+	}
+
+	// VAO con los atributos de la malla mas los de instance_buffer, que avanzan una vez por instancia:
+	// locations[i] es un vec4 en offsets[i] de cada instancia (un mat4 ocupa cuatro ubicaciones seguidas)
+	void enableInstancing(GLuint instance_buffer, GLsizei stride, const vector<GLuint>& locations, const vector<size_t>& offsets)
+	{
+		if (instancedVAO == 0)
+			glGenVertexArrays(1, &instancedVAO);
+
+		glBindVertexArray(instancedVAO);
+		setupVertexAttributes();
+		glBindBuffer(GL_ARRAY_BUFFER, instance_buffer);
+		for (uint i = 0; i < locations.size(); i++)
+		{
+			glEnableVertexAttribArray(locations[i]);
+			glVertexAttribPointer(locations[i], 4, GL_FLOAT, GL_FALSE, stride, (void*)offsets[i]);
+			glVertexAttribDivisor(locations[i], 1);
+		}
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+		glBindVertexArray(0);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+
+	// Crea el buffer de salida del pre-skinning (posicion y normal deformadas de cada vertice) y un VAO
+	// que lo combina con las coordenadas de textura, tangentes e indices originales
+	void enablePreSkinning()
+	{
+		if (skinnedVAO != 0)
+			return;
+
+		glGenVertexArrays(1, &skinnedVAO);
+		glGenBuffers(1, &VBO_skinned);
+
+		glBindVertexArray(skinnedVAO);
+		glBindBuffer(GL_ARRAY_BUFFER, VBO_skinned);
+		glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(SkinnedVertex), NULL, GL_DYNAMIC_COPY);
+		RenderStats::TrackBufferMemory(vertices.size() * sizeof(SkinnedVertex));
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(SkinnedVertex), (void*)0);
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(SkinnedVertex), (void*)offsetof(SkinnedVertex, Normal));
+
+		glBindBuffer(GL_ARRAY_BUFFER, VBO);
+		glEnableVertexAttribArray(2);
+		glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, TexCoords));
+		glEnableVertexAttribArray(3);
+		glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Tangent));
+		glEnableVertexAttribArray(4);
+		glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Bitangent));
+
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+		glBindVertexArray(0);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+
+	// Deforma todos los vertices una vez con el programa de pre-skinning ya activo (skinning.vs con PRESKIN).
+	// Debe llamarse entre glEnable(GL_RASTERIZER_DISCARD) y glDisable, como hace ModelAnim::Update
+	void preSkin()
+	{
+		RenderStats::BindVertexArray(VAO);
+		glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, VBO_skinned);
+		glBeginTransformFeedback(GL_POINTS);
+		RenderStats::DrawArrays(GL_POINTS, 0, vertices.size());
+		glEndTransformFeedback();
+		glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+		glBindVertexArray(0);
+	}
+
+	// Bytes de la malla: copia en la CPU mas los buffers de la GPU (vertices, huesos, indices y salida del pre-skinning)
+	size_t MemoryBytes() const
+	{
+		size_t vertex_bytes = vertices.size() * sizeof(Vertex) + bones_id_weights_for_each_vertex.size() * sizeof(VertexBoneData)
+			+ indices.size() * sizeof(unsigned int);
+		size_t skinned_bytes = skinnedVAO != 0 ? vertices.size() * sizeof(SkinnedVertex) : 0;
+		return sizeof(MeshAnim) + 2 * vertex_bytes + skinned_bytes + textures.capacity() * sizeof(Texture);
+	}
+
+private:
+    /*  Render data  */
+    unsigned int VBO, EBO, VBO_bones;
+	unsigned int VBO_skinned = 0;
+
+	// Salida del pre-skinning, en el orden de los varyings capturados
+	struct SkinnedVertex
+	{
+		glm::vec3 Position;
+		glm::vec3 Normal;
+	};
+
+    // bind appropriate textures
+    void bindTextures(Shader& shader)
+    {
         unsigned int diffuseNr  = 1;
         unsigned int specularNr = 1;
         unsigned int normalNr   = 1;
@@ -106,24 +284,12 @@ public:
                 number = std::to_string(heightNr++); // transfer unsigned int to stream
 
             // now set the sampler to the correct texture unit
-            glUniform1i(glGetUniformLocation(shader.Program, (name + number).c_str()), i);    // AQUI ES DONDE SE ASIGNAN LOS UNIFORM A LOS SHADERS AHHHHHHHHHHHH
+            RenderStats::Uniform1i(glGetUniformLocation(shader.Program, (name + number).c_str()), i);    // AQUI ES DONDE SE ASIGNAN LOS UNIFORM A LOS SHADERS AHHHHHHHHHHHH
             // and finally bind the texture
-            glBindTexture(GL_TEXTURE_2D, textures[i].id);
+            RenderStats::BindTexture(GL_TEXTURE_2D, textures[i].id);
         }
-        
-        // draw mesh
-        glBindVertexArray(VAO);
-        glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
-        glBindVertexArray(0);
-
-        // always good practice to set everything back to defaults once configured.
-        glActiveTexture(GL_TEXTURE0);
     }
 
-private:
-    /*  Render data  */
-    unsigned int VBO, EBO, VBO_bones;
-
     /*  Functions    */
     // initializes all the buffer objects/arrays
     void setupMesh()
@@ -149,7 +315,18 @@ private:
 		// indices
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
         glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
+		RenderStats::TrackBufferMemory(vertices.size() * sizeof(Vertex) + bones_id_weights_for_each_vertex.size() * sizeof(bones_id_weights_for_each_vertex[0])
+			+ indices.size() * sizeof(unsigned int));
+
+		setupVertexAttributes();
 
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+        glBindVertexArray(0);
+    }
+
+	// Atributos 0-6 (vertices y huesos) en el VAO ligado
+	void setupVertexAttributes()
+	{
 		// Se liga primero el buffer de los vertices
 		glBindBuffer(GL_ARRAY_BUFFER, VBO);
         // set the vertex attribute pointers
@@ -173,13 +350,10 @@ private:
 		glBindBuffer(GL_ARRAY_BUFFER, VBO_bones);
 		// set the bones atrribute pointers
 		glEnableVertexAttribArray(5);
-		glVertexAttribIPointer(5, 4, GL_INT, sizeof(VertexBoneData), (void*)0);
+		glVertexAttribIPointer(5, 4, GL_UNSIGNED_BYTE, sizeof(VertexBoneData), (void*)0);
 		glEnableVertexAttribArray(6);
-		glVertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, sizeof(VertexBoneData), (void*)offsetof(VertexBoneData, weights));
-
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-        glBindVertexArray(0);
-    }
+		glVertexAttribPointer(6, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(VertexBoneData), (void*)offsetof(VertexBoneData, weights));
+	}
 };
 #endif
 
@@ -12,16 +12,39 @@
 
 #include <GLFW/glfw3.h>
 #include "meshAnim.h"
-#include "model.h"
-#include "shader.h"
+#include "Model.h"
+#include "Shader.h"
+#include "AnimationClip.h"
+#include "AnimationPlayer.h"
+#include "BonePalette.h"
+#include "Profiler.h"
+#include "LoadReport.h"
 #include <string>
 #include <fstream>
 #include <sstream>
 #include <iostream>
 #include <map>
+#include <algorithm>
 #include <vector>
 using namespace std;
 
+// Resumen de la importación de pesos de huesos
+struct BoneStreamStats
+{
+	size_t vertices = 0;
+	uint clamped_vertices = 0;   // vértices con más de NUM_BONES_PER_VEREX influencias
+	float max_dropped_weight = 0.0f;
+};
+
+// Estado intermedio de evaluar el esqueleto, propio de cada instancia que lo anima (ModelAnim para su
+// reproducción propia, AnimatedInstance para las demás); el esqueleto en sí se comparte
+struct SkeletonState
+{
+	vector<AffineTransform> node_local;   // transformaciones locales y globales de la última evaluación;
+	vector<AffineTransform> node_global;  // las globales ya incluyen m_global_inverse_transform
+	vector<char> node_animated;           // el nodo tiene pista en algún clip de la última evaluación
+};
+
 class ModelAnim 
 {
 public:
@@ -31,70 +54,297 @@ public:
     string directory;
     bool gammaCorrection;
 
-	/* Importacion base */
+	/* Importacion base: la escena se libera al terminar de cargar, salvo con keep_source */
 	Assimp::Importer importer;
 	const aiScene* scene;
 
 	/* Huesos */
-	static const uint MAX_BONES = 100;
-
 	map<string, uint> m_bone_mapping; // maps a bone name and their index
 	uint m_num_bones = 0;
+	BoneStreamStats m_bone_stream;    // resumen del stream de huesos de todas las mallas
 	vector<BoneMatrix> m_bone_matrices;
 	aiMatrix4x4 m_global_inverse_transform;
 
-	GLuint m_bone_location[MAX_BONES];
+	BonePalette m_palette;            // matrices de los huesos para Shaders/skinning.vs, compartidas por todas las mallas
+	GLint m_bone_offset_location = -1;
 	float ticks_per_second = 0.0f;
 
+	/* Pre-skinning opcional: Update deforma las mallas una vez por frame y cada pasada usa DrawSkinned */
+	GLuint m_preskin_program = 0;              // skinning.vs con PRESKIN (ver PreSkinVaryings)
+	GLint m_preskin_offset_location = -1;
+	vector<aiMatrix4x4> m_skinned_pose;        // matrices con las que se deformaron los buffers actuales
+	uint m_skin_count = 0;                     // frames que sí deformaron las mallas
+	uint m_skin_skipped = 0;                   // frames sin cambio de pose
+
+	/* Esqueleto aplanado: la jerarquía de nodos compilada al cargar, con cada padre antes que sus hijos */
+	vector<int> m_node_parent;                 // índice del nodo padre (-1 = raíz)
+	vector<aiMatrix4x4> m_node_bind_transform; // mTransformation del nodo, se usa si no tiene canal
+	vector<int> m_node_bone;                   // hueso que corresponde al nodo (-1 = no es hueso)
+	LocalPose m_bind_pose;                     // m_node_bind_transform descompuesta, para mezclar clips
+	vector<AffineTransform> m_node_bind_affine;
+	vector<AffineTransform> m_bone_offsets;    // offset_matrix de cada hueso
+	glm::vec3 m_bounds_center = glm::vec3(0.0f); // esfera que contiene las mallas en la pose de reposo
+	float m_bounds_radius = 0.0f;
+
+	/* Animaciones compactadas al cargar (una por cada animación de la escena); se reproduce la primera */
+	vector<AnimationClip> m_clips;
+	static constexpr float MAX_CLIP_ROTATION_ERROR = 0.5f; // grados; más que esto se reporta al cargar
+
+	/* Reproducción propia del modelo: al cargar reproduce en bucle el primer clip. Otros personajes con el
+	   mismo modelo no lo vuelven a cargar: cada AnimatedInstance comparte mallas, texturas, esqueleto y clips */
+	AnimationPlayer m_player;
+	double m_clock = 0.0;                      // último instante recibido por boneTransform
+	SkeletonState m_state;
+	SegmentCache m_clip_cache;                 // tramos de claves de m_clips[0] para evaluateSkeleton
+	LocalPose m_clip_pose;
+
     /*  Functions   */
     // constructor, expects a filepath to a 3D model.
-    ModelAnim(string const &path, bool gamma = false) : gammaCorrection(gamma)
+	// samples_per_second > 0 remuestrea los clips a frecuencia fija (clave en O(1), aproxima las curvas);
+	// keep_source conserva la escena de Assimp para comparar contra ella (AnimationBenchmark)
+    ModelAnim(string const &path, bool gamma = false, float samples_per_second = 0.0f, bool keep_source = false) : gammaCorrection(gamma)
     {
-        loadModel(path);
+        loadModel(path, samples_per_second, keep_source);
     }
 
 	void initShaders(GLuint shader_program)
 	{
-		for (uint i = 0; i < MAX_BONES; i++) // get location all matrices of bones
-		{
-			string name = "bones[" + to_string(i) + "]";// name like in shader
-			m_bone_location[i] = glGetUniformLocation(shader_program, name.c_str());
-		}
+		// La paleta se lee de un texture buffer en una unidad fija; solo cambia el desplazamiento de cada frame
+		glUseProgram(shader_program);
+		glUniform1i(glGetUniformLocation(shader_program, "bonePalette"), BonePalette::TEXTURE_UNIT);
+		m_bone_offset_location = glGetUniformLocation(shader_program, "boneOffset");
 
 		// rotate head AND AXIS(y_z) about x !!!!!  Not be gimbal lock
 		//rotate_head_xz *= glm::quat(cos(glm::radians(-45.0f / 2)), sin(glm::radians(-45.0f / 2)) * glm::vec3(1.0f, 0.0f, 0.0f));
 	}
 
+	// Activa el pre-skinning: preskin_program es Shaders/skinning.vs compilado con "#define PRESKIN\n",
+	// Shaders/preskin.frag y los varyings de PreSkinVaryings()
+	void enablePreSkinning(GLuint preskin_program)
+	{
+		m_preskin_program = preskin_program;
+		glUseProgram(preskin_program);
+		glUniform1i(glGetUniformLocation(preskin_program, "bonePalette"), BonePalette::TEXTURE_UNIT);
+		m_preskin_offset_location = glGetUniformLocation(preskin_program, "boneOffset");
+
+		for (unsigned int i = 0; i < meshes.size(); i++)
+			meshes[i].enablePreSkinning();
+		m_skinned_pose.clear();
+	}
+
+	// Crossfade hacia el clip con ese nombre; false si no existe
+	bool playClip(const string& name, float fade_seconds = 0.0f, float speed = 1.0f, bool loop = true)
+	{
+		unsigned int clip = m_player.FindClip(name);
+		if (clip == AnimationPlayer::NO_CLIP)
+		{
+			cout << "ERROR::ANIM:: no hay un clip llamado '" << name << "'" << endl;
+			return false;
+		}
+		m_player.Play(clip, fade_seconds, speed, loop);
+		return true;
+	}
+
+	// Deja state listo para evaluar este esqueleto
+	void initSkeletonState(SkeletonState& state) const
+	{
+		uint num_nodes = (uint)m_node_parent.size();
+		state.node_local.resize(num_nodes);
+		state.node_global.resize(num_nodes);
+		state.node_animated.assign(num_nodes, 0);
+	}
+
+	// Evalúa la mezcla de las capas de player (que reproduce m_clips) con el estado de una instancia y escribe
+	// las tres filas de cada hueso cada bone_stride floats a partir de bone_rows. El modelo no cambia: varias
+	// instancias pueden evaluar el mismo esqueleto, cada una con su propio reproductor y estado
+	void evaluatePlayer(AnimationPlayer& player, SkeletonState& state, float* bone_rows, size_t bone_stride) const
+	{
+		if (m_clips.empty())
+			return;
+
+		const LocalPose& pose = player.Evaluate();
+		for (uint i = 0; i < m_node_parent.size(); i++)
+			state.node_animated[i] = player.Animates(i);
+		composeSkeleton(pose, state, bone_rows, bone_stride);
+	}
+
+	// Transformaciones locales de la pose (SIMD, cuatro nodos a la vez) y una pasada lineal por la jerarquía
+	// aplanada con transformaciones afines: sin strings, mapas ni recursión. m_global_inverse_transform se
+	// aplica una sola vez en la raíz en lugar de en cada hueso
+	void composeSkeleton(const LocalPose& pose, SkeletonState& state, float* bone_rows, size_t bone_stride) const
+	{
+		composePose(pose, state.node_local);
+		AffineTransform root(m_global_inverse_transform);
+		for (uint i = 0; i < m_node_parent.size(); i++)
+		{
+			const AffineTransform& local = state.node_animated[i] ? state.node_local[i] : m_node_bind_affine[i];
+			if (m_node_parent[i] >= 0)
+				multiplyAffine(state.node_global[m_node_parent[i]], local, state.node_global[i]);
+			else
+				multiplyAffine(root, local, state.node_global[i]);
+
+			int bone_index = m_node_bone[i];
+			if (bone_index >= 0)
+				multiplyAffine(state.node_global[i].m, m_bone_offsets[bone_index].m, bone_rows + bone_index * bone_stride);
+		}
+	}
+
+	// Memoria que comparten todas las instancias del modelo: mallas (copia en la CPU y buffers en la GPU),
+	// texturas en la GPU, esqueleto y clips
+	size_t MemoryBytes() const
+	{
+		size_t bytes = sizeof(ModelAnim) + m_node_parent.capacity() * sizeof(int) + m_node_bone.capacity() * sizeof(int)
+			+ m_node_bind_transform.capacity() * sizeof(aiMatrix4x4) + m_bind_pose.data.capacity() * sizeof(float)
+			+ (m_node_bind_affine.capacity() + m_bone_offsets.capacity()) * sizeof(AffineTransform)
+			+ m_bone_matrices.capacity() * sizeof(BoneMatrix);
+		for (uint i = 0; i < meshes.size(); i++)
+			bytes += meshes[i].MemoryBytes();
+		for (uint i = 0; i < m_clips.size(); i++)
+			bytes += m_clips[i].MemoryBytes();
+		for (uint i = 0; i < textures_loaded.size(); i++)
+			bytes += textureBytes(textures_loaded[i].id);
+		return bytes;
+	}
+
+	static vector<const GLchar*> PreSkinVaryings()
+	{
+		vector<const GLchar*> varyings;
+		varyings.push_back("SkinnedPosition");
+		varyings.push_back("SkinnedNormal");
+		return varyings;
+	}
+
+	// Una vez por frame con pre-skinning: evalúa el esqueleto y deforma todas las mallas en un solo pase de
+	// transform feedback. Si el reproductor no avanzó no se evalúa nada, y si la pose resultante es la
+	// misma que la de los buffers actuales (clip en pausa o tramo sin movimiento) tampoco se deforma.
+	// Devuelve true si las mallas se deformaron en este frame
+	bool Update(double time_in_sec)
+	{
+		if (m_preskin_program == 0)
+			return false;
+
+		boneTransform(time_in_sec);
+		if (!poseChanged())
+		{
+			m_skin_skipped++;
+			return false;
+		}
+
+		m_palette.Upload(m_bone_matrices);
+		RenderStats::UseProgram(m_preskin_program);
+		m_palette.Bind(m_preskin_offset_location);
+
+		RenderStats::Enable(GL_RASTERIZER_DISCARD);
+		for (unsigned int i = 0; i < meshes.size(); i++)
+			meshes[i].preSkin();
+		RenderStats::Disable(GL_RASTERIZER_DISCARD);
+
+		m_palette.Fence();
+		m_skin_count++;
+		return true;
+	}
+
+	// Dibuja las mallas deformadas en el último Update con un shader de geometría estática; se puede llamar
+	// en tantas pasadas como haga falta (profundidad, sombras, color) sin repetir la mezcla de huesos
+	void DrawSkinned(Shader shader)
+	{
+		for (unsigned int i = 0; i < meshes.size(); i++)
+			meshes[i].DrawSkinned(shader);
+	}
+
     // draws the model, and thus all its meshes
     void Draw(Shader shader)
     {
-		// Calculo de las animaciones
-		vector<aiMatrix4x4> transforms;
-		boneTransform((double)glfwGetTime(), transforms);
-	  
-		for (uint i = 0; i < transforms.size(); i++) // move all matrices for actual model position to shader
-		{
-			glUniformMatrix4fv(m_bone_location[i], 1, GL_TRUE, (const GLfloat*)&transforms[i]);
-		}
+		PROFILE_SCOPE("ModelAnim::Draw");
+		// Calculo de las animaciones: una copia de la paleta por frame, ligada una vez para todas las mallas
+		boneTransform((double)glfwGetTime());
+		m_palette.Upload(m_bone_matrices);
+		m_palette.Bind(m_bone_offset_location);
 
         for(unsigned int i = 0; i < meshes.size(); i++)
             meshes[i].Draw(shader);
+
+		m_palette.Fence();
     }
+
+	// Avanza el reproductor hasta time_in_sec (reloj de la aplicación) y evalúa la pose si pudo cambiar
+	void boneTransform(double time_in_sec)
+	{
+		PROFILE_SCOPE("ModelAnim::boneTransform");
+		float delta_seconds = (float)(time_in_sec - m_clock);
+		m_clock = time_in_sec;
+		if (m_player.Advance(delta_seconds))
+			evaluatePlayer(m_player, m_state, boneRows(), BONE_MATRIX_STRIDE);
+	}
+
+	// start from RootNode
+	// Ruta recursiva original sobre la escena de Assimp (solo existe con keep_source); boneTransform usa
+	// el reproductor y esta queda como referencia para AnimationBenchmark
+	void readNodeHierarchy(float p_animation_time, const aiNode* p_node, const aiMatrix4x4 parent_transform)
+	{
+
+		string node_name(p_node->mName.data);
+
+		//������� node, �� ������� ������������ �������, ������������� �������� ���� ������(aiNodeAnim).
+		const aiAnimation* animation = scene->mAnimations[0];
+		aiMatrix4x4 node_transform = p_node->mTransformation; // AQUI AHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHH
+
+		const aiNodeAnim* node_anim = findNodeAnim(animation, node_name); // ����� ������� �� ����� ����
+
+		if (node_anim)
+		{
+			KeyCursor seek; // sin cursor propio: cada llamada busca la clave desde cero
+			node_transform = animatedTransform(p_animation_time, node_anim, seek);
+		}
+
+		aiMatrix4x4 global_transform = parent_transform * node_transform;
+
+		// ���� � node �� �������� ����������� bone, �� �� node ������ ��������� � ������ bone !!!
+		if (m_bone_mapping.find(node_name) != m_bone_mapping.end()) // true if node_name exist in bone_mapping
+		{
+			uint bone_index = m_bone_mapping[node_name];
+			m_bone_matrices[bone_index].final_world_transform = m_global_inverse_transform * global_transform * m_bone_matrices[bone_index].offset_matrix;
+		}
+
+		for (uint i = 0; i < p_node->mNumChildren; i++)
+		{
+			readNodeHierarchy(p_animation_time, p_node->mChildren[i], global_transform);
+		}
+
+	}
     
 private:
+	friend class AnimationBenchmark;
 
     /*  Functions   */
     // loads a model with supported ASSIMP extensions from file and stores the resulting meshes in the meshes vector.
-    void loadModel(string const &path)
+    void loadModel(string const &path, float samples_per_second, bool keep_source)
     {
-        // read file via ASSIMP
-        scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_CalcTangentSpace);
+        PROFILE_SCOPE("ModelAnim::loadModel");
+		LoadReport::Asset report(path, "modelo animado");
+        // read file via ASSIMP, parsing and post-processing apart for the load report
+		if (LoadReport::Enabled())
+			importer.SetIOHandler(new LoadReportIOSystem());
+		{
+			LoadReport::Stage stage(LoadReport::PARSE);
+			scene = importer.ReadFile(path, 0);
+		}
+		if (scene)
+		{
+			LoadReport::Stage stage(LoadReport::POST_PROCESS);
+			scene = importer.ApplyPostProcessing(aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_CalcTangentSpace);
+		}
         // check for errors
         if(!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) // if is Not Zero
         {
             cout << "ERROR::ASSIMP:: " << importer.GetErrorString() << endl;
             return;
         }
+		if (!scene->HasAnimations())
+		{
+			cout << "ERROR::ANIM:: " << path << " no tiene animaciones" << endl;
+			return;
+		}
 
 		m_global_inverse_transform = scene->mRootNode->mTransformation;
 		m_global_inverse_transform.Inverse();
@@ -111,35 +361,68 @@ private:
         // retrieve the directory path of the filepath
         directory = path.substr(0, path.find_last_of('/'));
 
-		cout << "scene->HasAnimations() 1: " << scene->HasAnimations() << endl;
-		cout << "scene->mNumMeshes 1: " << scene->mNumMeshes << endl;
-		cout << "scene->mAnimations[0]->mNumChannels 1: " << scene->mAnimations[0]->mNumChannels << endl;
-		cout << "scene->mAnimations[0]->mDuration 1: " << scene->mAnimations[0]->mDuration << endl;
-		cout << "scene->mAnimations[0]->mTicksPerSecond 1: " << scene->mAnimations[0]->mTicksPerSecond << endl << endl;
-
-		cout << "		name nodes : " << endl;
-		showNodeName(scene->mRootNode);
-		cout << endl;
-
-		cout << "		name bones : " << endl;
 		//processNode(scene->mRootNode, scene);
 		// process ASSIMP's root node recursively
 		processNode(scene->mRootNode, scene);
+		reportBoneStream(path);
+		computeBounds();
+
+		// Con los huesos ya registrados se aplana la jerarquía para evaluarla sin recursión
+		// y las animaciones se compactan contra ese esqueleto
+		map<string, int> node_index;
+		compileSkeleton(node_index);
+		bakeClips(samples_per_second, node_index);
 
-		cout << "		name nodes animation : " << endl;
-		for (uint i = 0; i < scene->mAnimations[0]->mNumChannels; i++)
+		// Después de hornear los clips ya nada lee la escena
+		if (!keep_source)
 		{
-			cout << scene->mAnimations[0]->mChannels[i]->mNodeName.C_Str() << endl;
+			importer.FreeScene();
+			scene = NULL;
 		}
-		cout << endl;
     }
 
-	void showNodeName(aiNode* node)
+	// Esfera de las mallas en la pose de reposo (la caja de los vértices y su media diagonal)
+	void computeBounds()
+	{
+		bool first = true;
+		glm::vec3 bounds_min(0.0f), bounds_max(0.0f);
+		for (uint i = 0; i < meshes.size(); i++)
+		{
+			for (uint j = 0; j < meshes[i].vertices.size(); j++)
+			{
+				const glm::vec3& position = meshes[i].vertices[j].Position;
+				bounds_min = first ? position : glm::min(bounds_min, position);
+				bounds_max = first ? position : glm::max(bounds_max, position);
+				first = false;
+			}
+		}
+		m_bounds_center = (bounds_min + bounds_max) * 0.5f;
+		m_bounds_radius = glm::length(bounds_max - bounds_min) * 0.5f;
+	}
+
+	// Bytes del nivel base de la textura, más un tercio por los mipmaps
+	static size_t textureBytes(GLuint texture)
+	{
+		GLint width = 0, height = 0;
+		glBindTexture(GL_TEXTURE_2D, texture);
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		return (size_t)width * height * 4 * 4 / 3;
+	}
+
+	// Memoria del stream de huesos antes (4 uint + 4 float, 32 bytes) y después del empaquetado (8 bytes)
+	void reportBoneStream(string const &path)
 	{
-		cout << node->mName.data << endl;
-		for (uint i = 0; i < node->mNumChildren; i++)
+		const size_t unpacked_size = NUM_BONES_PER_VEREX * (sizeof(uint) + sizeof(float));
+		size_t before = m_bone_stream.vertices * unpacked_size;
+		size_t after = m_bone_stream.vertices * sizeof(VertexBoneData);
+		cout << "huesos '" << path << "': " << m_bone_stream.vertices << " vertices, " << before / 1024.0f << " KB -> "
+			<< after / 1024.0f << " KB (ahorro " << (before - after) / 1024.0f << " KB); " << m_bone_stream.clamped_vertices
+			<< " vertices con mas de " << NUM_BONES_PER_VEREX << " influencias (peso descartado max " << m_bone_stream.max_dropped_weight << ")" << endl;
+		if (m_num_bones > MAX_PACKED_BONES)
 		{
-			showNodeName(node->mChildren[i]);
+			cout << "ERROR::ANIM:: " << path << " tiene " << m_num_bones << " huesos, el stream empaquetado solo indexa " << MAX_PACKED_BONES << endl;
 		}
 	}
 
@@ -164,12 +447,12 @@ private:
 
     MeshAnim processMesh(aiMesh *mesh, const aiScene *scene)
     {
-		std::cout << "bones: " << mesh->mNumBones << " vertices: " << mesh->mNumVertices << std::endl;
+		LoadReport::Stage convert(LoadReport::CONVERT);
         // data to fill
         vector<Vertex> vertices;
         vector<unsigned int> indices;
         vector<Texture> textures;
-		vector<VertexBoneData> bones_id_weights_for_each_vertex;
+		vector<VertexInfluences> bones_id_weights_for_each_vertex;
 
 		
 		//Tal vez haya que hacer resize de los vectores
@@ -253,9 +536,6 @@ private:
 			uint bone_index = 0;
 			string bone_name(mesh->mBones[i]->mName.data);
 
-			// Impresión de los nombres de los huesos
-			cout << mesh->mBones[i]->mName.data << endl;
-
 			if (m_bone_mapping.find(bone_name) == m_bone_mapping.end()) // ��������� ��� �� � ������� ��������
 			{
 				// Allocate an index for a new bone
@@ -285,8 +565,24 @@ private:
 			}
 		}
         
-        // return a mesh object created from the extracted mesh data
-        return MeshAnim(vertices, indices, textures, bones_id_weights_for_each_vertex);
+		// Las cuatro influencias mayores de cada vértice, renormalizadas y empaquetadas en 8 bytes
+		vector<VertexBoneData> packed_bones(mesh->mNumVertices);
+		for (uint i = 0; i < mesh->mNumVertices; i++)
+		{
+			const VertexInfluences& influences = bones_id_weights_for_each_vertex[i];
+			packed_bones[i] = influences.pack();
+			if (influences.count > NUM_BONES_PER_VEREX)
+			{
+				m_bone_stream.clamped_vertices++;
+				m_bone_stream.max_dropped_weight = max(m_bone_stream.max_dropped_weight, influences.dropped);
+			}
+		}
+		m_bone_stream.vertices += mesh->mNumVertices;
+        
+        // return a mesh object created from the extracted mesh data (the constructor uploads the buffers)
+		LoadReport::AddMesh(vertices.size(), indices.size());
+		LoadReport::Stage upload(LoadReport::UPLOAD, true);
+        return MeshAnim(vertices, indices, textures, packed_bones);
     }
 
     // checks all material textures of a given type and loads the textures if they're not loaded yet.
@@ -299,17 +595,10 @@ private:
             aiString str;
             mat->GetTexture(type, i, &str);
             // check if texture was loaded before and if so, continue to next iteration: skip loading a new texture
-            bool skip = false;
-            for(unsigned int j = 0; j < textures_loaded.size(); j++)
-            {
-                if(std::strcmp(textures_loaded[j].path.data(), str.C_Str()) == 0)
-                {
-                    textures.push_back(textures_loaded[j]);
-                    skip = true; // a texture with the same filepath has already been loaded, continue to next one. (optimization)
-                    break;
-                }
-            }
-            if(!skip)
+            int loaded = FindLoadedTexture(textures_loaded, str.C_Str());
+            if(loaded != -1)
+                textures.push_back(textures_loaded[loaded]); // a texture with the same filepath has already been loaded, continue to next one. (optimization)
+            else
             {   // if texture hasn't been loaded already, load it
                 Texture texture;
 				texture.id = TextureFromFile(str.C_Str(), this->directory);
@@ -322,66 +611,16 @@ private:
         return textures;
     }
 
-	uint findPosition(float p_animation_time, const aiNodeAnim* p_node_anim)
-	{
-		// ����� ���� ������� ����� ����� ����� ������� ���������� ����� ������ ��������
-		for (uint i = 0; i < p_node_anim->mNumPositionKeys - 1; i++) // �������� ����� ��������
-		{
-			if (p_animation_time < (float)p_node_anim->mPositionKeys[i + 1].mTime) // �������� �� �������� ��������� !!!
-			{
-				return i; // �� ������� ������ �������� !!!!!!!!!!!!!!!!!! ����������������������������
-			}
-		}
-
-		assert(0);
-		return 0;
-	}
-
-	uint findRotation(float p_animation_time, const aiNodeAnim* p_node_anim)
-	{
-		// ����� ���� ������� ����� ����� ����� ������� ���������� ����� ������ ��������
-		for (uint i = 0; i < p_node_anim->mNumRotationKeys - 1; i++) // �������� ����� ��������
-		{
-			if (p_animation_time < (float)p_node_anim->mRotationKeys[i + 1].mTime) // �������� �� �������� ��������� !!!
-			{
-				return i; // �� ������� ������ �������� !!!!!!!!!!!!!!!!!! ����������������������������
-			}
-		}
-
-		assert(0);
-		return 0;
-	}
-
-	uint findScaling(float p_animation_time, const aiNodeAnim* p_node_anim)
-	{
-		// ����� ���� ������� ����� ����� ����� ������� ���������� ����� ������ ��������
-		for (uint i = 0; i < p_node_anim->mNumScalingKeys - 1; i++) // �������� ����� ��������
-		{
-			if (p_animation_time < (float)p_node_anim->mScalingKeys[i + 1].mTime) // �������� �� �������� ��������� !!!
-			{
-				return i; // �� ������� ������ �������� !!!!!!!!!!!!!!!!!! ����������������������������
-			}
-		}
-
-		assert(0);
-		return 0;
-	}
-
-	aiVector3D calcInterpolatedPosition(float p_animation_time, const aiNodeAnim* p_node_anim)
+	aiVector3D calcInterpolatedPosition(float p_animation_time, const aiNodeAnim* p_node_anim, KeyCursor& cursor)
 	{
 		if (p_node_anim->mNumPositionKeys == 1) // Keys ��� ������� �����
 		{
 			return p_node_anim->mPositionKeys[0].mValue;
 		}
 
-		uint position_index = findPosition(p_animation_time, p_node_anim); // ������ ������ �������� ����� ������� ������
+		uint position_index = findKey(p_animation_time, p_node_anim->mPositionKeys, p_node_anim->mNumPositionKeys, cursor.position); // ������ ������ �������� ����� ������� ������
 		uint next_position_index = position_index + 1; // ������ ��������� �������� �����
-		assert(next_position_index < p_node_anim->mNumPositionKeys);
-		// ���� ����� �������
-		float delta_time = (float)(p_node_anim->mPositionKeys[next_position_index].mTime - p_node_anim->mPositionKeys[position_index].mTime);
-		// ������ = (���� ������� ������ �� ������ �������� ��������� �����) / �� ���� ����� �������
-		float factor = (p_animation_time - (float)p_node_anim->mPositionKeys[position_index].mTime) / delta_time;
-		assert(factor >= 0.0f && factor <= 1.0f);
+		float factor = keyFactor(p_animation_time, p_node_anim->mPositionKeys[position_index].mTime, p_node_anim->mPositionKeys[next_position_index].mTime);
 		aiVector3D start = p_node_anim->mPositionKeys[position_index].mValue;
 		aiVector3D end = p_node_anim->mPositionKeys[next_position_index].mValue;
 		aiVector3D delta = end - start;
@@ -389,20 +628,16 @@ private:
 		return start + factor * delta;
 	}
 
-	aiQuaternion calcInterpolatedRotation(float p_animation_time, const aiNodeAnim* p_node_anim)
+	aiQuaternion calcInterpolatedRotation(float p_animation_time, const aiNodeAnim* p_node_anim, KeyCursor& cursor)
 	{
 		if (p_node_anim->mNumRotationKeys == 1) // Keys ��� ������� �����
 		{
 			return p_node_anim->mRotationKeys[0].mValue;
 		}
 
-		uint rotation_index = findRotation(p_animation_time, p_node_anim); // ������ ������ �������� ����� ������� ������
+		uint rotation_index = findKey(p_animation_time, p_node_anim->mRotationKeys, p_node_anim->mNumRotationKeys, cursor.rotation); // ������ ������ �������� ����� ������� ������
 		uint next_rotation_index = rotation_index + 1; // ������ ��������� �������� �����
-		assert(next_rotation_index < p_node_anim->mNumRotationKeys);
-		// ���� ����� �������
-		float delta_time = (float)(p_node_anim->mRotationKeys[next_rotation_index].mTime - p_node_anim->mRotationKeys[rotation_index].mTime);
-		// ������ = (���� ������� ������ �� ������ �������� ��������� �����) / �� ���� ����� �������
-		float factor = (p_animation_time - (float)p_node_anim->mRotationKeys[rotation_index].mTime) / delta_time;
+		float factor = keyFactor(p_animation_time, p_node_anim->mRotationKeys[rotation_index].mTime, p_node_anim->mRotationKeys[next_rotation_index].mTime);
 
 		//cout << "p_node_anim->mRotationKeys[rotation_index].mTime: " << p_node_anim->mRotationKeys[rotation_index].mTime << endl;
 		//cout << "p_node_anim->mRotationKeys[next_rotaion_index].mTime: " << p_node_anim->mRotationKeys[next_rotation_index].mTime << endl;
@@ -411,29 +646,23 @@ private:
 		//cout << "animation_time - mRotationKeys[rotation_index].mTime: " << (p_animation_time - (float)p_node_anim->mRotationKeys[rotation_index].mTime) << endl;
 		//cout << "factor: " << factor << endl << endl << endl;
 
-		assert(factor >= 0.0f && factor <= 1.0f);
 		aiQuaternion start_quat = p_node_anim->mRotationKeys[rotation_index].mValue;
 		aiQuaternion end_quat = p_node_anim->mRotationKeys[next_rotation_index].mValue;
 
 		return nlerp(start_quat, end_quat, factor);
 	}
 
-	aiVector3D calcInterpolatedScaling(float p_animation_time, const aiNodeAnim* p_node_anim)
+	aiVector3D calcInterpolatedScaling(float p_animation_time, const aiNodeAnim* p_node_anim, KeyCursor& cursor)
 	{
 		if (p_node_anim->mNumScalingKeys == 1) // Keys ��� ������� �����
 		{
 			return p_node_anim->mScalingKeys[0].mValue;
 		}
 
-		uint scaling_index = findScaling(p_animation_time, p_node_anim); // ������ ������ �������� ����� ������� ������
+		uint scaling_index = findKey(p_animation_time, p_node_anim->mScalingKeys, p_node_anim->mNumScalingKeys, cursor.scaling); // ������ ������ �������� ����� ������� ������
 		uint next_scaling_index = scaling_index + 1; // ������ ��������� �������� �����
-		assert(next_scaling_index < p_node_anim->mNumScalingKeys);
-		// ���� ����� �������
-		float delta_time = (float)(p_node_anim->mScalingKeys[next_scaling_index].mTime - p_node_anim->mScalingKeys[scaling_index].mTime);
-		// ������ = (���� ������� ������ �� ������ �������� ��������� �����) / �� ���� ����� �������
-		float  factor = (p_animation_time - (float)p_node_anim->mScalingKeys[scaling_index].mTime) / delta_time;
+		float factor = keyFactor(p_animation_time, p_node_anim->mScalingKeys[scaling_index].mTime, p_node_anim->mScalingKeys[next_scaling_index].mTime);
 		//cout << "p_animation_time: " << p_animation_time << " " << "mTime: " << (float)p_node_anim->mScalingKeys[scaling_index].mTime << endl << endl << endl;
-		assert(factor >= 0.0f && factor <= 1.0f);
 		aiVector3D start = p_node_anim->mScalingKeys[scaling_index].mValue;
 		aiVector3D end = p_node_anim->mScalingKeys[next_scaling_index].mValue;
 		aiVector3D delta = end - start;
@@ -457,76 +686,242 @@ private:
 		return nullptr;
 	}
 
-	// start from RootNode
-	void readNodeHierarchy(float p_animation_time, const aiNode* p_node, const aiMatrix4x4 parent_transform)
+	// Transformación local de un nodo animado en el instante dado: traslación * rotación * escala
+	aiMatrix4x4 animatedTransform(float p_animation_time, const aiNodeAnim* node_anim, KeyCursor& cursor)
 	{
+		//scaling
+		//aiVector3D scaling_vector = node_anim->mScalingKeys[2].mValue;
+		aiVector3D scaling_vector = calcInterpolatedScaling(p_animation_time, node_anim, cursor);
 
-		string node_name(p_node->mName.data);
+		//rotation
+		//aiQuaternion rotate_quat = node_anim->mRotationKeys[2].mValue;
+		aiQuaternion rotate_quat = calcInterpolatedRotation(p_animation_time, node_anim, cursor);
 
-		//������� node, �� ������� ������������ �������, ������������� �������� ���� ������(aiNodeAnim).
-		const aiAnimation* animation = scene->mAnimations[0];
-		aiMatrix4x4 node_transform = p_node->mTransformation; // AQUI AHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHHH
+		//translation
+		//aiVector3D translate_vector = node_anim->mPositionKeys[2].mValue;
+		aiVector3D translate_vector = calcInterpolatedPosition(p_animation_time, node_anim, cursor);
 
-		const aiNodeAnim* node_anim = findNodeAnim(animation, node_name); // ����� ������� �� ����� ����
-
-		if (node_anim)
-		{
+		//if (p_node->mName == scene->mRootNode->mName) {
+		//	node_transform = translate_matr * (rotate_matr * aiMatrix4x4 (aiQuaternion(-90.0f, 0.0f, 0.0f).GetMatrix())) * scaling_matr;
+		//}
 
-			//scaling
-			//aiVector3D scaling_vector = node_anim->mScalingKeys[2].mValue;
-			aiVector3D scaling_vector = calcInterpolatedScaling(p_animation_time, node_anim);
-			aiMatrix4x4 scaling_matr;
-			aiMatrix4x4::Scaling(scaling_vector, scaling_matr);
+		return composeTransform(translate_vector, rotate_quat, scaling_vector);
+	}
 
-			//rotation
-			//aiQuaternion rotate_quat = node_anim->mRotationKeys[2].mValue;
-			aiQuaternion rotate_quat = calcInterpolatedRotation(p_animation_time, node_anim);
-			aiMatrix4x4 rotate_matr = aiMatrix4x4(rotate_quat.GetMatrix());
+	// traslación * rotación * escala
+	aiMatrix4x4 composeTransform(const aiVector3D& translate_vector, const aiQuaternion& rotate_quat, const aiVector3D& scaling_vector)
+	{
+		aiMatrix4x4 scaling_matr;
+		aiMatrix4x4::Scaling(scaling_vector, scaling_matr);
+		aiMatrix4x4 rotate_matr = aiMatrix4x4(rotate_quat.GetMatrix());
+		aiMatrix4x4 translate_matr;
+		aiMatrix4x4::Translation(translate_vector, translate_matr);
 
-			//translation
-			//aiVector3D translate_vector = node_anim->mPositionKeys[2].mValue;
-			aiVector3D translate_vector = calcInterpolatedPosition(p_animation_time, node_anim);
-			aiMatrix4x4 translate_matr;
-			aiMatrix4x4::Translation(translate_vector, translate_matr);
+		return translate_matr * rotate_matr * scaling_matr;
+	}
 
-			//if (p_node->mName == scene->mRootNode->mName) {
-			//	node_transform = translate_matr * (rotate_matr * aiMatrix4x4 (aiQuaternion(-90.0f, 0.0f, 0.0f).GetMatrix())) * scaling_matr;
-			//}
+	// Recorre la jerarquía una sola vez en preorden (así cada padre queda antes que sus hijos),
+	// resuelve por nombre el hueso de cada nodo y deja en node_index el nodo de cada nombre
+	void compileSkeleton(map<string, int>& node_index)
+	{
+		vector< pair<const aiNode*, int> > pending; // nodo y el índice de su padre
+		pending.push_back(make_pair((const aiNode*)scene->mRootNode, -1));
+		while (!pending.empty())
+		{
+			const aiNode* node = pending.back().first;
+			int parent = pending.back().second;
+			pending.pop_back();
 
-			node_transform = translate_matr * rotate_matr * scaling_matr;
-		}
+			int index = (int)m_node_parent.size();
+			string node_name(node->mName.data);
+			map<string, uint>::iterator bone = m_bone_mapping.find(node_name);
 
-		aiMatrix4x4 global_transform = parent_transform * node_transform;
+			m_node_parent.push_back(parent);
+			m_node_bind_transform.push_back(node->mTransformation);
+			m_node_bone.push_back(bone != m_bone_mapping.end() ? (int)bone->second : -1);
+			node_index.insert(make_pair(node_name, index));
 
-		// ���� � node �� �������� ����������� bone, �� �� node ������ ��������� � ������ bone !!!
-		if (m_bone_mapping.find(node_name) != m_bone_mapping.end()) // true if node_name exist in bone_mapping
+			// Los hijos se apilan al revés para visitarlos en el mismo orden que readNodeHierarchy
+			for (int i = (int)node->mNumChildren - 1; i >= 0; i--)
+			{
+				pending.push_back(make_pair((const aiNode*)node->mChildren[i], index));
+			}
+		}
+		uint num_nodes = (uint)m_node_parent.size();
+		initSkeletonState(m_state);
+		m_bind_pose.Resize(num_nodes);
+		for (uint i = 0; i < num_nodes; i++)
 		{
-			uint bone_index = m_bone_mapping[node_name];
-			m_bone_matrices[bone_index].final_world_transform = m_global_inverse_transform * global_transform * m_bone_matrices[bone_index].offset_matrix;
+			aiVector3D position, scaling;
+			aiQuaternion rotation;
+			m_node_bind_transform[i].Decompose(scaling, rotation, position);
+			m_bind_pose.Set(i, position, rotation, scaling);
+			m_node_bind_affine.push_back(AffineTransform(m_node_bind_transform[i]));
+		}
+		for (uint i = 0; i < m_num_bones; i++)
+		{
+			m_bone_offsets.push_back(AffineTransform(m_bone_matrices[i].offset_matrix));
 		}
+	}
 
-		for (uint i = 0; i < p_node->mNumChildren; i++)
+	// Compacta cada animación de la escena en un AnimationClip con sus pistas ordenadas por nodo.
+	// Con samples_per_second > 0 las pistas se remuestrean a frecuencia fija (la última muestra cae en el final del clip)
+	void bakeClips(float samples_per_second, const map<string, int>& node_index)
+	{
+		for (uint a = 0; a < scene->mNumAnimations; a++)
 		{
-			readNodeHierarchy(p_animation_time, p_node->mChildren[i], global_transform);
+			const aiAnimation* animation = scene->mAnimations[a];
+			float duration = (float)animation->mDuration;
+			float clip_ticks_per_second = animation->mTicksPerSecond != 0.0 ? (float)animation->mTicksPerSecond : 25.0f;
+			uint num_samples = 0;
+			float rate = 0.0f;
+			if (samples_per_second > 0.0f && duration > 0.0f)
+			{
+				num_samples = (uint)ceil(duration * samples_per_second / clip_ticks_per_second) + 1;
+				rate = (num_samples - 1) / duration;
+			}
+
+			ClipError error;
+			AnimationClip clip(animation->mName.C_Str(), duration, clip_ticks_per_second, rate, (uint)m_node_parent.size());
+			for (uint i = 0; i < animation->mNumChannels; i++)
+			{
+				// Igual que findNodeAnim, si dos canales animan el mismo nodo gana el primero
+				const aiNodeAnim* channel = animation->mChannels[i];
+				map<string, int>::const_iterator node = node_index.find(string(channel->mNodeName.data));
+				if (node == node_index.end() || clip.node_track[node->second] >= 0)
+					continue;
+
+				vector<float> position_times, rotation_times, scaling_times;
+				vector<aiVector3D> positions, scalings;
+				vector<aiQuaternion> rotations;
+				if (rate > 0.0f)
+				{
+					KeyCursor cursor;
+					for (uint j = 0; j < num_samples; j++)
+					{
+						float time = min(j / rate, duration);
+						positions.push_back(calcInterpolatedPosition(time, channel, cursor));
+						rotations.push_back(calcInterpolatedRotation(time, channel, cursor));
+						scalings.push_back(calcInterpolatedScaling(time, channel, cursor));
+					}
+				}
+				else
+				{
+					for (uint j = 0; j < channel->mNumPositionKeys; j++)
+					{
+						position_times.push_back((float)channel->mPositionKeys[j].mTime);
+						positions.push_back(channel->mPositionKeys[j].mValue);
+					}
+					for (uint j = 0; j < channel->mNumRotationKeys; j++)
+					{
+						rotation_times.push_back((float)channel->mRotationKeys[j].mTime);
+						rotations.push_back(channel->mRotationKeys[j].mValue);
+					}
+					for (uint j = 0; j < channel->mNumScalingKeys; j++)
+					{
+						scaling_times.push_back((float)channel->mScalingKeys[j].mTime);
+						scalings.push_back(channel->mScalingKeys[j].mValue);
+					}
+				}
+				clip.AddTrack(node->second, position_times, positions, rotation_times, rotations, scaling_times, scalings);
+				measureTrack(channel, clip, (uint)clip.tracks.size() - 1, error);
+			}
+
+			m_clips.push_back(clip);
+			cout << "clip '" << clip.name << "': " << clip.tracks.size() << " pistas, " << error.source_bytes / 1024.0f << " KB -> "
+				<< clip.MemoryBytes() / 1024.0f << " KB (" << (float)error.source_bytes / clip.MemoryBytes() << "x); error max: posicion "
+				<< error.position << ", rotacion " << error.rotation << " grados, escala " << error.scaling << endl;
+			if (error.rotation > MAX_CLIP_ROTATION_ERROR)
+			{
+				cout << "ERROR::ANIM:: el clip '" << clip.name << "' se aleja de la fuente mas de " << MAX_CLIP_ROTATION_ERROR << " grados" << endl;
+			}
 		}
+		m_clips[0].ResetCache(m_clip_cache);
+		m_clip_pose = m_bind_pose;
+		m_player.Reset(&m_clips, m_bind_pose);
+		m_player.Play(0);
+	}
 
+	struct ClipError
+	{
+		size_t source_bytes = sizeof(aiAnimation);
+		float position = 0.0f;
+		float rotation = 0.0f;                 // grados
+		float scaling = 0.0f;
+	};
+
+	// Compara la pista compactada contra las claves de Assimp en cada clave y a la mitad de cada tramo
+	void measureTrack(const aiNodeAnim* channel, const AnimationClip& clip, uint track, ClipError& error)
+	{
+		error.source_bytes += sizeof(aiNodeAnim*) + sizeof(aiNodeAnim) + channel->mNumPositionKeys * sizeof(aiVectorKey)
+			+ channel->mNumRotationKeys * sizeof(aiQuatKey) + channel->mNumScalingKeys * sizeof(aiVectorKey);
+
+		vector<float> times;
+		for (uint j = 0; j < channel->mNumPositionKeys; j++)
+			times.push_back((float)channel->mPositionKeys[j].mTime);
+		for (uint j = 0; j < channel->mNumRotationKeys; j++)
+			times.push_back((float)channel->mRotationKeys[j].mTime);
+		for (uint j = 0; j < channel->mNumScalingKeys; j++)
+			times.push_back((float)channel->mScalingKeys[j].mTime);
+		sort(times.begin(), times.end());
+		for (uint j = 0, count = (uint)times.size(); j + 1 < count; j++)
+			times.push_back(0.5f * (times[j] + times[j + 1]));
+
+		KeyCursor source_cursor, clip_cursor;
+		for (uint j = 0; j < times.size(); j++)
+		{
+			aiVector3D position, scaling;
+			aiQuaternion rotation;
+			clip.Sample(track, times[j], clip_cursor, position, rotation, scaling);
+
+			// El ángulo sale de la parte vectorial de q^-1 * q' (acos del producto punto pierde precisión cerca de 0)
+			aiQuaternion source_rotation = calcInterpolatedRotation(times[j], channel, source_cursor);
+			source_rotation.Normalize();
+			aiQuaternion difference = source_rotation.Conjugate() * rotation;
+			float sine = aiVector3D(difference.x, difference.y, difference.z).Length();
+
+			error.position = max(error.position, (calcInterpolatedPosition(times[j], channel, source_cursor) - position).Length());
+			error.rotation = max(error.rotation, glm::degrees(2.0f * atan2(sine, fabs(difference.w))));
+			error.scaling = max(error.scaling, (calcInterpolatedScaling(times[j], channel, source_cursor) - scaling).Length());
+		}
 	}
 
-	void boneTransform(double time_in_sec, vector<aiMatrix4x4>& transforms)
+	// Evalúa solo el primer clip en el instante dado, sin pasar por el reproductor (referencia de AnimationBenchmark)
+	void evaluateSkeleton(float p_animation_time)
 	{
-		aiMatrix4x4 identity_matrix; // = mat4(1.0f);
-		double time_in_ticks = time_in_sec * ticks_per_second;
-		float animation_time = fmod(time_in_ticks, scene->mAnimations[0]->mDuration); //������� �� ����� (������� �� ������)
-		// animation_time - ���� ������� ������ � ���� ������ �� ������ �������� (�� ������� �������� ����� � �������� )
+		if (m_clips.empty())
+			return;
+
+		const AnimationClip& clip = m_clips[0];
+		clip.SamplePose(p_animation_time, m_clip_cache, m_clip_pose);
+		for (uint i = 0; i < m_node_parent.size(); i++)
+			m_state.node_animated[i] = clip.node_track[i] >= 0;
+		composeSkeleton(m_clip_pose, m_state, boneRows(), BONE_MATRIX_STRIDE);
+	}
 
-		readNodeHierarchy(animation_time, scene->mRootNode, identity_matrix);
+	// La cuarta fila de final_world_transform siempre es (0, 0, 0, 1): composeSkeleton solo escribe las tres
+	// primeras, cada BONE_MATRIX_STRIDE floats a partir de la primera matriz
+	static const size_t BONE_MATRIX_STRIDE = sizeof(BoneMatrix) / sizeof(float);
 
-		transforms.resize(m_num_bones);
+	float* boneRows()
+	{
+		return m_bone_matrices.empty() ? NULL : &m_bone_matrices[0].final_world_transform.a1;
+	}
 
+	// Compara las matrices recién evaluadas con las de los buffers deformados y las guarda si cambiaron
+	bool poseChanged()
+	{
+		bool changed = m_skinned_pose.size() != m_num_bones;
+		m_skinned_pose.resize(m_num_bones);
 		for (uint i = 0; i < m_num_bones; i++)
 		{
-			transforms[i] = m_bone_matrices[i].final_world_transform;
+			if (changed || memcmp(&m_skinned_pose[i], &m_bone_matrices[i].final_world_transform, sizeof(aiMatrix4x4)) != 0)
+			{
+				m_skinned_pose[i] = m_bone_matrices[i].final_world_transform;
+				changed = true;
+			}
 		}
+		return changed;
 	}
 
 	glm::mat4 aiToGlm(aiMatrix4x4 ai_matr)